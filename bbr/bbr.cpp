@@ -6,6 +6,7 @@
 */
 
 #include "bbr.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
@@ -30,11 +31,28 @@ BBR::BBR()
       m_roundsWithoutGrowth(0),
       m_roundCount(0),
       m_lastRoundStartSeq(0),
+      m_nextRoundDelivered(0),
+      m_roundStart(false),
       m_probeBWCycleIndex(0),
       m_probeRTTDuration(PROBE_RTT_DURATION_MS),
       m_probeRTTRoundDone(false),
       m_deliveredBytes(0),
-      m_deliveredTime(0)
+      m_deliveredTime(0),
+      m_extraAcked{0, 0},           // No aggregation observed yet
+      m_extraAckedWinRounds(0),
+      m_extraAckedWinIdx(0),
+      m_ackEpochStart(0),
+      m_ackEpochAcked(0),
+      m_ltIsSampling(false),        // Wait for the first loss
+      m_ltUseBw(false),
+      m_ltBw(0),
+      m_ltRoundCount(0),
+      m_ltLastStamp(0),
+      m_ltLastDelivered(0),
+      m_ltLastLost(0),
+      m_lastLostBytes(0),
+      m_minRttService(nullptr),     // Probe on the flow's own timer
+      m_destination(0)
 {
     InitializeParameters();
 }
@@ -59,19 +77,40 @@ BBR::BBR(const BBR& other)
       m_roundsWithoutGrowth(other.m_roundsWithoutGrowth),
       m_roundCount(other.m_roundCount),
       m_lastRoundStartSeq(other.m_lastRoundStartSeq),
+      m_nextRoundDelivered(other.m_nextRoundDelivered),
+      m_roundStart(other.m_roundStart),
       m_probeBWCycleIndex(other.m_probeBWCycleIndex),
       m_probeBWCycleStart(other.m_probeBWCycleStart),
       m_probeRTTStart(other.m_probeRTTStart),
       m_probeRTTDuration(other.m_probeRTTDuration),
       m_probeRTTRoundDone(other.m_probeRTTRoundDone),
       m_deliveredBytes(other.m_deliveredBytes),
-      m_deliveredTime(other.m_deliveredTime)
+      m_deliveredTime(other.m_deliveredTime),
+      m_deliveryHistory(other.m_deliveryHistory),
+      m_extraAcked{other.m_extraAcked[0], other.m_extraAcked[1]},
+      m_extraAckedWinRounds(other.m_extraAckedWinRounds),
+      m_extraAckedWinIdx(other.m_extraAckedWinIdx),
+      m_ackEpochStart(other.m_ackEpochStart),
+      m_ackEpochAcked(other.m_ackEpochAcked),
+      m_ltIsSampling(other.m_ltIsSampling),
+      m_ltUseBw(other.m_ltUseBw),
+      m_ltBw(other.m_ltBw),
+      m_ltRoundCount(other.m_ltRoundCount),
+      m_ltLastStamp(other.m_ltLastStamp),
+      m_ltLastDelivered(other.m_ltLastDelivered),
+      m_ltLastLost(other.m_ltLastLost),
+      m_lastLostBytes(other.m_lastLostBytes),
+      m_minRttService(other.m_minRttService),
+      m_destination(other.m_destination)
 {
+    if (m_minRttService != nullptr) {
+        m_minRttService->Join(m_destination);
+    }
 }
 
 // Destructor
 BBR::~BBR() {
-    // No dynamic memory to clean up
+    SetMinRttService(nullptr, 0);
 }
 
 // Get type ID
@@ -99,8 +138,11 @@ void BBR::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segments
     // Update local state
     m_cwnd = socket->cwnd_;
 
-    // BBR calculates cwnd based on BDP (Bandwidth-Delay Product)
+    // BBR calculates cwnd based on BDP (Bandwidth-Delay Product),
+    // plus headroom for ACKs that arrive in batches
     uint32_t targetCwnd = CalculateTargetCwnd(m_cwndGain);
+    targetCwnd = static_cast<uint32_t>(std::min<uint64_t>(
+        static_cast<uint64_t>(targetCwnd) + GetAckAggregationCwnd(), m_maxCwnd));
     
     // In PROBE_RTT, use minimum cwnd
     if (m_mode == BBRMode::PROBE_RTT) {
@@ -129,10 +171,12 @@ void BBR::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     
     // Calculate delivered bytes
     uint32_t ackedBytes = segmentsAcked * socket->mss_bytes_;
     m_deliveredBytes += ackedBytes;
+    m_deliveredTime = socket->NowUs();
     
     // Run BBR main update logic
     BBRUpdate(socket, ackedBytes, rtt);
@@ -156,6 +200,7 @@ void BBR::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
         return;
     }
 
+    CC_PROBE_CWND_EVENT(bbr_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     // BBR doesn't react strongly to packet loss like traditional algorithms
@@ -205,6 +250,100 @@ void BBR::CongControl(std::unique_ptr<SocketState>& socket,
     }
 }
 
+// Get the model to keep across a rebuild
+CcModelSnapshot BBR::GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const {
+    CcModelSnapshot snapshot;
+    snapshot.bandwidth = GetBandwidth();
+    snapshot.min_rtt_us = m_minRTT != 0xFFFFFFFF ? m_minRTT : 0;
+    return snapshot;
+}
+
+// Seed the filters from a saved model
+void BBR::RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) {
+    if (socket == nullptr || snapshot.bandwidth == 0 || snapshot.min_rtt_us == 0) {
+        return;
+    }
+
+    // Mode timers run on the socket's clock from here on
+    m_deliveredTime = socket->NowUs();
+
+    m_bandwidthSamples.clear();
+    m_bandwidthSamples.push_back(BandwidthSample(snapshot.bandwidth, m_roundCount, EventTime()));
+    m_maxBandwidth = snapshot.bandwidth;
+    m_minRTT = snapshot.min_rtt_us;
+    m_minRTTTimestamp = EventTime();
+
+    // The pipe was filled before; skip STARTUP
+    m_cwnd = socket->cwnd_;
+    EnterProbeBW();
+    m_pacingRate = CalculatePacingRate(m_pacingGain);
+}
+
+// Get pacing rate
+uint64_t BBR::GetPacingRate() const {
+    return m_pacingRate;
+}
+
+// Get send quantum
+uint32_t BBR::GetSendQuantum(const std::unique_ptr<SocketState>& socket) const {
+    if (socket == nullptr) {
+        return 0;
+    }
+    if (m_pacingRate == 0) {
+        return CongestionControl::GetSendQuantum(socket);
+    }
+    return SendQuantumForRate(m_pacingRate, socket->mss_bytes_);
+}
+
+// Get decision
+CcDecision BBR::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    CcDecision decision = CongestionControl::GetDecision(socket);
+    decision.mode = static_cast<uint8_t>(static_cast<int>(m_mode) + 1);
+    if (socket == nullptr) {
+        return decision;
+    }
+    if (m_pacingRate != 0) {
+        decision.pacing_rate = m_pacingRate;
+    }
+
+    uint32_t minRtt = m_minRTT != 0xFFFFFFFF ? m_minRTT : socket->rtt_us_;
+    FillAckFrequency(decision, socket->mss_bytes_, minRtt, m_mode == BBRMode::STARTUP);
+    return decision;
+}
+
+// Get current mode
+BBRMode BBR::GetMode() const {
+    return m_mode;
+}
+
+// Get ACK aggregation estimate
+uint32_t BBR::GetExtraAcked() const {
+    return std::max(m_extraAcked[0], m_extraAcked[1]);
+}
+
+// Check if the long-term bandwidth is in use
+bool BBR::IsUsingLongTermBandwidth() const {
+    return m_ltUseBw;
+}
+
+// Get long-term bandwidth
+uint64_t BBR::GetLongTermBandwidth() const {
+    return m_ltBw;
+}
+
+// Join a shared min-RTT group
+void BBR::SetMinRttService(MinRttService* service, uint64_t destination) {
+    if (m_minRttService != nullptr) {
+        m_minRttService->Leave(m_destination);
+    }
+
+    m_minRttService = service;
+    m_destination = destination;
+    if (m_minRttService != nullptr) {
+        m_minRttService->Join(m_destination);
+    }
+}
+
 // Enter STARTUP mode
 void BBR::EnterStartup() {
     m_mode = BBRMode::STARTUP;
@@ -212,6 +351,8 @@ void BBR::EnterStartup() {
     m_cwndGain = CWND_GAIN;         // 2.0x
     m_roundsWithoutGrowth = 0;
     m_prevMaxBandwidth = 0;
+
+    CC_PROBE5(bbr_enter_startup, static_cast<void*>(this), m_maxBandwidth, m_minRTT, m_cwnd, m_roundCount);
 }
 
 // Enter DRAIN mode
@@ -219,6 +360,8 @@ void BBR::EnterDrain() {
     m_mode = BBRMode::DRAIN;
     m_pacingGain = 100 * 100 / HIGH_GAIN;  // 1/2.89 to drain queue
     m_cwndGain = CWND_GAIN;
+
+    CC_PROBE5(bbr_enter_drain, static_cast<void*>(this), m_maxBandwidth, m_minRTT, m_cwnd, m_roundCount);
 }
 
 // Enter PROBE_BW mode
@@ -227,8 +370,10 @@ void BBR::EnterProbeBW() {
     m_pacingGain = PROBE_BW_GAIN;
     m_cwndGain = CWND_GAIN;
     m_probeBWCycleIndex = 0;
-    m_probeBWCycleStart = std::chrono::steady_clock::now();
+    m_probeBWCycleStart = EventTime();
     UpdateProbeBWGain();
+
+    CC_PROBE5(bbr_enter_probe_bw, static_cast<void*>(this), m_maxBandwidth, m_minRTT, m_cwnd, m_roundCount);
 }
 
 // Enter PROBE_RTT mode
@@ -236,14 +381,22 @@ void BBR::EnterProbeRTT() {
     m_mode = BBRMode::PROBE_RTT;
     m_pacingGain = PROBE_BW_GAIN;
     m_cwndGain = PROBE_RTT_CWND_GAIN;  // 0.5x to reduce queue
-    m_probeRTTStart = std::chrono::steady_clock::now();
+    m_probeRTTStart = EventTime();
     m_probeRTTRoundDone = false;
+
+    CC_PROBE5(bbr_enter_probe_rtt, static_cast<void*>(this), m_maxBandwidth, m_minRTT, m_cwnd, m_roundCount);
 }
 
 // BBR main update logic
 void BBR::BBRUpdate(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes, uint64_t rtt) {
+    m_roundStart = UpdateRound(socket);
+
     // Update bandwidth estimate
     UpdateBandwidth(ackedBytes, rtt);
+    UpdateLongTermBandwidth(socket);
+
+    // Update ACK aggregation estimate against the new bandwidth
+    UpdateAckAggregation(socket, ackedBytes);
     
     // Update min RTT
     UpdateMinRTT(rtt);
@@ -264,9 +417,10 @@ void BBR::BBRUpdate(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes, u
             break;
             
         case BBRMode::DRAIN:
-            // Check if we've drained the queue
-            // (inflight <= BDP)
-            if (socket->cwnd_ <= CalculateTargetCwnd(100)) {
+            // Check if we've drained the queue (inflight <= BDP). Inflight
+            // is not known here: one round at the drain gain removes the
+            // queue STARTUP built
+            if (socket->cwnd_ <= CalculateTargetCwnd(100) || m_roundStart) {
                 EnterProbeBW();
             }
             break;
@@ -282,12 +436,19 @@ void BBR::BBRUpdate(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes, u
             break;
             
         case BBRMode::PROBE_RTT:
-            // Stay in PROBE_RTT for minimum duration
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - m_probeRTTStart);
+            // Stay in PROBE_RTT for minimum duration, or until the
+            // group's shared window closes
+            auto now = EventTime();
+            bool probeDone;
+            if (m_minRttService != nullptr) {
+                probeDone = !m_minRttService->ShouldProbeRtt(m_destination, m_deliveredTime);
+            } else {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - m_probeRTTStart);
+                probeDone = elapsed.count() >= m_probeRTTDuration;
+            }
             
-            if (elapsed.count() >= m_probeRTTDuration) {
+            if (probeDone) {
                 // Exit PROBE_RTT
                 m_minRTTTimestamp = now;
                 
@@ -307,29 +468,45 @@ void BBR::UpdateBandwidth(uint32_t ackedBytes, uint64_t rtt) {
         return;
     }
     
-    // Calculate bandwidth: bytes / time
-    // bandwidth (bytes/sec) = ackedBytes / (rtt / 1000000)
-    uint64_t bandwidth = (static_cast<uint64_t>(ackedBytes) * 1000000) / rtt;
-    
-    // Add new sample
-    m_bandwidthSamples.push_back(BandwidthSample(bandwidth));
+    // Delivery rate: bytes delivered over the last RTT, so batched ACKs
+    // do not inflate or deflate the sample
+    m_deliveryHistory.push_back(BBRDeliveryPoint{m_deliveredTime, m_deliveredBytes});
+    uint64_t windowStart = m_deliveredTime > rtt ? m_deliveredTime - rtt : 0;
+    while (m_deliveryHistory.size() > 2 && m_deliveryHistory[1].time_us <= windowStart) {
+        m_deliveryHistory.pop_front();
+    }
+
+    uint64_t bandwidth = 0;
+    const BBRDeliveryPoint& base = m_deliveryHistory.front();
+    if (m_deliveryHistory.size() > 1) {
+        uint64_t interval = std::max<uint64_t>(m_deliveredTime - base.time_us, rtt);
+        bandwidth = (m_deliveredBytes - base.delivered) * 1000000 / interval;
+    } else {
+        // First ACK: bandwidth (bytes/sec) = ackedBytes / (rtt / 1000000)
+        bandwidth = (static_cast<uint64_t>(ackedBytes) * 1000000) / rtt;
+    }
     
-    // Keep only recent samples (windowed max)
-    while (m_bandwidthSamples.size() > m_bandwidthWindow) {
+    // One sample per round (the round's best), windowed max over m_bandwidthWindow rounds
+    if (!m_bandwidthSamples.empty() && m_bandwidthSamples.back().round == m_roundCount) {
+        m_bandwidthSamples.back().bandwidth = std::max(m_bandwidthSamples.back().bandwidth, bandwidth);
+    } else {
+        m_bandwidthSamples.push_back(BandwidthSample(bandwidth, m_roundCount, EventTime()));
+    }
+    while (m_bandwidthSamples.front().round + m_bandwidthWindow <= m_roundCount) {
         m_bandwidthSamples.pop_front();
     }
     
     // Update max bandwidth
     uint64_t newMaxBandwidth = GetMaxBandwidth();
     
-    // Track bandwidth growth for STARTUP
-    if (m_mode == BBRMode::STARTUP) {
-        if (newMaxBandwidth < m_prevMaxBandwidth * FULL_PIPE_THRESHOLD) {
-            m_roundsWithoutGrowth++;
-        } else {
+    // Track bandwidth growth for STARTUP, once per round
+    if (m_mode == BBRMode::STARTUP && m_roundStart) {
+        if (newMaxBandwidth >= m_prevMaxBandwidth * FULL_PIPE_THRESHOLD) {
+            m_prevMaxBandwidth = newMaxBandwidth;
             m_roundsWithoutGrowth = 0;
+        } else {
+            m_roundsWithoutGrowth++;
         }
-        m_prevMaxBandwidth = newMaxBandwidth;
     }
     
     m_maxBandwidth = newMaxBandwidth;
@@ -358,12 +535,23 @@ void BBR::UpdateMinRTT(uint64_t rtt) {
     uint32_t rtt_us = static_cast<uint32_t>(rtt);
     
     // Add new sample
-    m_rttSamples.push_back(BBRRTTSample(rtt_us));
+    m_rttSamples.push_back(BBRRTTSample(rtt_us, EventTime()));
+
+    // In a group, use the shared minimum: peers may have seen a lower RTT,
+    // and the group's probe window refreshes it for every member
+    if (m_minRttService != nullptr) {
+        m_minRttService->OnRttSample(m_destination, rtt_us, m_deliveredTime);
+        uint32_t shared = m_minRttService->GetMinRtt(m_destination);
+        if (shared != 0) {
+            m_minRTT = shared;
+            return;
+        }
+    }
     
     // Update min RTT if this is smaller
     if (rtt_us < m_minRTT) {
         m_minRTT = rtt_us;
-        m_minRTTTimestamp = std::chrono::steady_clock::now();
+        m_minRTTTimestamp = EventTime();
     }
 }
 
@@ -381,7 +569,7 @@ uint32_t BBR::CalculateTargetCwnd(uint32_t gain_percent) {
     
     // BDP = bandwidth * RTT
     // cwnd = BDP * gain
-    uint64_t bdp = (m_maxBandwidth * m_minRTT) / 1000000;  // bytes
+    uint64_t bdp = (GetBandwidth() * m_minRTT) / 1000000;  // bytes
     uint64_t targetCwnd = (bdp * gain_percent) / 100;
     
     // Ensure minimum window
@@ -398,7 +586,7 @@ uint64_t BBR::CalculatePacingRate(uint32_t gain_percent) {
     }
     
     // Pacing rate = bandwidth * gain
-    uint64_t rate = (m_maxBandwidth * gain_percent) / 100;
+    uint64_t rate = (GetBandwidth() * gain_percent) / 100;
     
     return std::max(rate, static_cast<uint64_t>(1000));  // Minimum pacing rate
 }
@@ -408,9 +596,14 @@ bool BBR::ShouldProbeRTT() {
     if (m_minRTT == 0xFFFFFFFF) {
         return false;
     }
+
+    // The group probes once for all flows, and not while any of them keeps seeing the minimum
+    if (m_minRttService != nullptr) {
+        return m_minRttService->ShouldProbeRtt(m_destination, m_deliveredTime);
+    }
     
     // Check if min RTT measurement is stale
-    auto now = std::chrono::steady_clock::now();
+    auto now = EventTime();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
         now - m_minRTTTimestamp);
     
@@ -424,7 +617,7 @@ void BBR::UpdateProbeBWGain() {
     }
     
     // Check if we should move to next gain in cycle
-    auto now = std::chrono::steady_clock::now();
+    auto now = EventTime();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - m_probeBWCycleStart);
     
@@ -435,7 +628,7 @@ void BBR::UpdateProbeBWGain() {
     if (elapsed.count() >= minRTT_ms) {
         // Move to next gain in cycle
         m_probeBWCycleIndex = (m_probeBWCycleIndex + 1) % 8;
-        m_pacingGain = PROBE_BW_GAINS[m_probeBWCycleIndex];
+        m_pacingGain = m_ltUseBw ? PROBE_BW_GAIN : PROBE_BW_GAINS[m_probeBWCycleIndex];
         m_probeBWCycleStart = now;
     }
 }
@@ -446,9 +639,162 @@ bool BBR::IsFullPipe() const {
     return m_roundsWithoutGrowth >= FULL_PIPE_ROUNDS;
 }
 
+// Advance the round counter
+bool BBR::UpdateRound(std::unique_ptr<SocketState>& socket) {
+    // No per-packet delivery stamps here: a round ends once a window's worth
+    // of data sent after its start has been delivered
+    if (m_deliveredBytes < m_nextRoundDelivered) {
+        return false;
+    }
+
+    m_roundCount++;
+    m_lastRoundStartSeq = m_deliveredBytes;
+    m_nextRoundDelivered = m_deliveredBytes + std::max(socket->cwnd_, socket->mss_bytes_);
+    return true;
+}
+
+// Estimate ACK aggregation (Linux bbr_update_ack_aggregation)
+void BBR::UpdateAckAggregation(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes) {
+    if (ackedBytes == 0 || m_maxBandwidth == 0) {
+        return;
+    }
+
+    // Windowed max over two slots of EXTRA_ACKED_WIN_ROUNDS rounds
+    if (m_roundStart) {
+        m_extraAckedWinRounds = std::min<uint32_t>(m_extraAckedWinRounds + 1, 0x1F);
+        if (m_extraAckedWinRounds >= EXTRA_ACKED_WIN_ROUNDS) {
+            m_extraAckedWinRounds = 0;
+            m_extraAckedWinIdx = m_extraAckedWinIdx ? 0 : 1;
+            m_extraAcked[m_extraAckedWinIdx] = 0;
+        }
+    }
+
+    // Bytes the estimated bandwidth would have delivered over the epoch
+    uint64_t now = socket->NowUs();
+    uint64_t epochUs = now > m_ackEpochStart ? now - m_ackEpochStart : 0;
+    uint64_t expectedAcked = GetBandwidth() * epochUs / 1000000;
+
+    // ACK rate fell to the expected rate (or the epoch is very old): start a new epoch
+    if (m_ackEpochAcked <= expectedAcked || m_ackEpochAcked + ackedBytes >= ACK_EPOCH_RESET_BYTES) {
+        m_ackEpochAcked = 0;
+        m_ackEpochStart = now;
+        expectedAcked = 0;
+    }
+
+    // Data delivered beyond what was expected, at most one cwnd
+    m_ackEpochAcked += ackedBytes;
+    uint64_t extraAcked = std::min<uint64_t>(m_ackEpochAcked - expectedAcked, socket->cwnd_);
+    if (extraAcked > m_extraAcked[m_extraAckedWinIdx]) {
+        m_extraAcked[m_extraAckedWinIdx] = static_cast<uint32_t>(extraAcked);
+    }
+}
+
+// Extra cwnd for ACK aggregation (Linux bbr_ack_aggregation_cwnd)
+uint32_t BBR::GetAckAggregationCwnd() const {
+    // Only once STARTUP has found the bandwidth
+    if (m_mode == BBRMode::STARTUP) {
+        return 0;
+    }
+
+    uint64_t maxAggrCwnd = GetBandwidth() * EXTRA_ACKED_MAX_US / 1000000;
+    uint64_t aggrCwnd = static_cast<uint64_t>(GetExtraAcked()) * EXTRA_ACKED_GAIN / 100;
+    return static_cast<uint32_t>(std::min(aggrCwnd, maxAggrCwnd));
+}
+
+// Long-term bandwidth sampling (Linux bbr_lt_bw_sampling)
+void BBR::UpdateLongTermBandwidth(std::unique_ptr<SocketState>& socket) {
+    bool losses = socket->lost_bytes_ > m_lastLostBytes;
+    m_lastLostBytes = socket->lost_bytes_;
+
+    // Pinned to the policed rate: re-probe after LT_BW_MAX_ROUNDS
+    if (m_ltUseBw) {
+        if (m_mode == BBRMode::PROBE_BW && m_roundStart && ++m_ltRoundCount >= LT_BW_MAX_ROUNDS) {
+            ResetLongTermSampling();
+            EnterProbeBW();
+        }
+        return;
+    }
+
+    // Start at the first loss, once the policer has spent its tokens
+    if (!m_ltIsSampling) {
+        if (!losses) {
+            return;
+        }
+        ResetLongTermInterval();
+        m_ltIsSampling = true;
+    }
+
+    if (m_roundStart) {
+        m_ltRoundCount++;
+    }
+    if (m_ltRoundCount < LT_INTERVAL_MIN_ROUNDS) {
+        return;
+    }
+    if (m_ltRoundCount > 4 * LT_INTERVAL_MIN_ROUNDS) {
+        // Too long without heavy loss: not policed
+        ResetLongTermSampling();
+        return;
+    }
+
+    // End the interval on a loss, if the interval's loss ratio is high
+    if (!losses) {
+        return;
+    }
+    uint64_t lost = socket->lost_bytes_ - m_ltLastLost;
+    uint64_t delivered = m_deliveredBytes - m_ltLastDelivered;
+    if (delivered == 0 || lost * 256 < LT_LOSS_THRESH * delivered) {
+        return;
+    }
+
+    uint64_t intervalUs = m_deliveredTime > m_ltLastStamp ? m_deliveredTime - m_ltLastStamp : 0;
+    if (intervalUs < 1000) {
+        return;
+    }
+
+    LongTermIntervalDone(delivered * 1000000 / intervalUs);
+}
+
+// Two consistent lossy intervals mean a policer (Linux bbr_lt_bw_interval_done)
+void BBR::LongTermIntervalDone(uint64_t bandwidth) {
+    if (m_ltBw != 0) {
+        uint64_t diff = bandwidth > m_ltBw ? bandwidth - m_ltBw : m_ltBw - bandwidth;
+        if (diff * 256 <= LT_BW_RATIO * m_ltBw || diff <= LT_BW_DIFF) {
+            m_ltBw = (bandwidth + m_ltBw) / 2;
+            m_ltUseBw = true;
+            m_pacingGain = PROBE_BW_GAIN;   // Pace at the policed rate to avoid drops
+            m_ltRoundCount = 0;
+            return;
+        }
+    }
+
+    m_ltBw = bandwidth;
+    ResetLongTermInterval();
+}
+
+// Get the bandwidth used by the model
+uint64_t BBR::GetBandwidth() const {
+    return m_ltUseBw ? m_ltBw : m_maxBandwidth;
+}
+
+// Stop using and sampling the long-term bandwidth
+void BBR::ResetLongTermSampling() {
+    m_ltBw = 0;
+    m_ltUseBw = false;
+    m_ltIsSampling = false;
+    ResetLongTermInterval();
+}
+
+// Start a new sampling interval
+void BBR::ResetLongTermInterval() {
+    m_ltLastStamp = m_deliveredTime;
+    m_ltLastDelivered = m_deliveredBytes;
+    m_ltLastLost = m_lastLostBytes;
+    m_ltRoundCount = 0;
+}
+
 // Clean up old samples
 void BBR::CleanupOldSamples() {
-    auto now = std::chrono::steady_clock::now();
+    auto now = EventTime();
     
     // Clean up bandwidth samples older than window
     while (!m_bandwidthSamples.empty()) {
@@ -473,10 +819,15 @@ void BBR::CleanupOldSamples() {
     }
 }
 
-// Initialize parameters
+// Time of the latest ACK (SocketState::NowUs()) as a clock point for the mode timers
+std::chrono::steady_clock::time_point BBR::EventTime() const {
+    return std::chrono::steady_clock::time_point(std::chrono::microseconds(m_deliveredTime));
+}
+
+// Initialize parameters: every timer is restarted from the ACK clock when its mode is entered
 void BBR::InitializeParameters() {
-    m_minRTTTimestamp = std::chrono::steady_clock::now();
-    m_probeBWCycleStart = std::chrono::steady_clock::now();
-    m_probeRTTStart = std::chrono::steady_clock::now();
+    m_minRTTTimestamp = EventTime();
+    m_probeBWCycleStart = EventTime();
+    m_probeRTTStart = EventTime();
 }
 
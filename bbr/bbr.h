@@ -9,6 +9,7 @@
 #define BBR_H
 
 #include "../utils/cong.h"
+#include "../utils/min_rtt_service.h"
 
 #include <string>
 #include <chrono>
@@ -27,9 +28,11 @@ enum class BBRMode {
 struct BandwidthSample {
     uint64_t bandwidth;     // Bytes per second
     std::chrono::steady_clock::time_point timestamp;
+    uint32_t round;         // Round the sample belongs to
     
-    BandwidthSample(uint64_t bw = 0) 
-        : bandwidth(bw), timestamp(std::chrono::steady_clock::now()) {}
+    BandwidthSample(uint64_t bw = 0, uint32_t r = 0,
+                    std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now()) 
+        : bandwidth(bw), timestamp(t), round(r) {}
 };
 
 // RTT sample with timestamp
@@ -37,8 +40,15 @@ struct BBRRTTSample {
     uint32_t rtt_us;        // RTT in microseconds
     std::chrono::steady_clock::time_point timestamp;
     
-    BBRRTTSample(uint32_t rtt = 0) 
-        : rtt_us(rtt), timestamp(std::chrono::steady_clock::now()) {}
+    BBRRTTSample(uint32_t rtt = 0,
+                 std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now()) 
+        : rtt_us(rtt), timestamp(t) {}
+};
+
+// Cumulative delivered bytes at an ACK
+struct BBRDeliveryPoint {
+    uint64_t time_us;       // ACK time (microseconds)
+    uint64_t delivered;     // Bytes delivered up to this ACK
 };
 
 class BBR: public CongestionControl {
@@ -65,6 +75,35 @@ public:
 
     void CongControl(std::unique_ptr<SocketState>& socket, const CongestionEvent& congestionEvent, const RTTSample& rtt) override;
 
+    // Send quantum from the pacing rate (bbr_set_send_quantum)
+    uint32_t GetSendQuantum(const std::unique_ptr<SocketState>& socket) const override;
+
+    // Decision with the model's pacing rate
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    // Bandwidth and min RTT filters
+    CcModelSnapshot GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const override;
+
+    // Resume in PROBE_BW with the saved model, like an idle restart
+    void RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) override;
+
+    // Current pacing rate (bytes/sec)
+    uint64_t GetPacingRate() const;
+
+    // Current operating mode
+    BBRMode GetMode() const;
+
+    // Windowed max of bytes ACKed beyond the estimated bandwidth (ACK aggregation)
+    uint32_t GetExtraAcked() const;
+
+    // Long-term (policed) bandwidth in use instead of the max filter
+    bool IsUsingLongTermBandwidth() const;
+    uint64_t GetLongTermBandwidth() const;
+
+    // Share min RTT and PROBE_RTT timing with other flows to the same destination: the
+    // flow's BDP uses the group's min RTT (not owned, nullptr to probe on the flow's own timer)
+    void SetMinRttService(MinRttService* service, uint64_t destination);
+
 protected:
     // BBR state machine methods
     virtual void EnterStartup();
@@ -98,6 +137,22 @@ protected:
     // Check for full pipe (bandwidth plateau)
     virtual bool IsFullPipe() const;
 
+    // Advance the round counter, true on the first ACK of a new round
+    virtual bool UpdateRound(std::unique_ptr<SocketState>& socket);
+
+    // Estimate ACK aggregation (extra_acked) from this ACK
+    virtual void UpdateAckAggregation(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes);
+
+    // Extra cwnd allowed for ACK aggregation
+    virtual uint32_t GetAckAggregationCwnd() const;
+
+    // Long-term bandwidth sampling for token bucket policers
+    virtual void UpdateLongTermBandwidth(std::unique_ptr<SocketState>& socket);
+    virtual void LongTermIntervalDone(uint64_t bandwidth);
+
+    // Bandwidth the model uses: long-term rate when policed, else the max filter
+    virtual uint64_t GetBandwidth() const;
+
 private:
     // Standard TCP parameters
     uint32_t m_cwnd;               // Current congestion window
@@ -129,6 +184,8 @@ private:
     uint32_t m_roundsWithoutGrowth;// Rounds without bandwidth growth
     uint32_t m_roundCount;         // Current round number
     uint64_t m_lastRoundStartSeq;  // Sequence at start of current round
+    uint64_t m_nextRoundDelivered; // Delivered bytes that end the current round
+    bool m_roundStart;             // This ACK started a new round
     
     // PROBE_BW cycling
     uint32_t m_probeBWCycleIndex;  // Current position in gain cycle
@@ -143,6 +200,28 @@ private:
     // Packet accounting
     uint64_t m_deliveredBytes;     // Total bytes delivered
     uint64_t m_deliveredTime;      // Time of last delivery (microseconds)
+    std::deque<BBRDeliveryPoint> m_deliveryHistory;  // About one RTT of delivery points
+
+    // ACK aggregation (extra_acked) estimation
+    uint32_t m_extraAcked[2];      // Windowed max, two slots of EXTRA_ACKED_WIN_ROUNDS
+    uint32_t m_extraAckedWinRounds;// Rounds in the current slot
+    uint32_t m_extraAckedWinIdx;   // Current slot
+    uint64_t m_ackEpochStart;      // Start of the aggregation epoch (microseconds)
+    uint64_t m_ackEpochAcked;      // Bytes ACKed in the epoch
+
+    // Long-term bandwidth (lt_bw) policer detection
+    bool m_ltIsSampling;           // A lossy interval is being measured
+    bool m_ltUseBw;                // Pacing at m_ltBw
+    uint64_t m_ltBw;               // Long-term bandwidth (bytes/sec)
+    uint32_t m_ltRoundCount;       // Rounds in the interval / at m_ltBw
+    uint64_t m_ltLastStamp;        // Interval start (microseconds)
+    uint64_t m_ltLastDelivered;    // Delivered bytes at interval start
+    uint64_t m_ltLastLost;         // Lost bytes at interval start
+    uint64_t m_lastLostBytes;      // Lost bytes seen at the previous ACK
+
+    // Coordinated PROBE_RTT
+    MinRttService* m_minRttService;// Shared per-destination min RTT (not owned)
+    uint64_t m_destination;        // Group key in m_minRttService
     
     // Configuration constants
     static constexpr uint32_t STARTUP_GAIN = 289;      // 2/ln(2) ≈ 2.89
@@ -158,10 +237,26 @@ private:
     static constexpr uint32_t PROBE_RTT_DURATION_MS = 200;  // 200ms
     static constexpr uint32_t FULL_PIPE_ROUNDS = 3;         // Rounds to confirm full pipe
     static constexpr double FULL_PIPE_THRESHOLD = 1.25;     // 25% growth threshold
+
+    // ACK aggregation
+    static constexpr uint32_t EXTRA_ACKED_WIN_ROUNDS = 5;   // Per slot, max over the last 5-10 rounds
+    static constexpr uint32_t EXTRA_ACKED_GAIN = 100;       // 1.0
+    static constexpr uint32_t EXTRA_ACKED_MAX_US = 100000;  // Cap at 100ms of data
+    static constexpr uint64_t ACK_EPOCH_RESET_BYTES = 1ULL << 30;  // Restart very old epochs
+
+    // Long-term bandwidth
+    static constexpr uint32_t LT_INTERVAL_MIN_ROUNDS = 4;   // Shortest sampling interval
+    static constexpr uint32_t LT_LOSS_THRESH = 50;          // Loss ratio to end an interval (x/256, ~20%)
+    static constexpr uint32_t LT_BW_RATIO = 32;             // Consistent intervals within 1/8
+    static constexpr uint64_t LT_BW_DIFF = 4000 / 8;        // ... or within 4 kbit/s (bytes/sec)
+    static constexpr uint32_t LT_BW_MAX_ROUNDS = 48;        // Rounds to use lt_bw before re-probing
     
     // Helper methods
     void CleanupOldSamples();
     void InitializeParameters();
+    void ResetLongTermSampling();
+    void ResetLongTermInterval();
+    std::chrono::steady_clock::time_point EventTime() const;
 };
 
 #endif // BBR_H
@@ -0,0 +1,121 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 11:52:17
+@Description: Per-ACK CPU cost micro-benchmark
+@Language: C++17
+*/
+
+#include "benchmark.h"
+#include "../utils/probes.h"
+#include "../utils/instrumented_cc.h"
+#include "../utils/lazy_cc.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * Drives each algorithm with a synthetic ACK stream (PktsAcked +
+ * IncreaseWindow per ACK, a loss every LOSS_INTERVAL ACKs so CwndEvent and
+ * the mode transitions run too) and prints the mean cost per ACK.
+ *
+ * Build it once plain and once with -DCC_ENABLE_USDT to check that probe
+ * sites cost nothing while no tracer is attached. Each algorithm is also
+ * run through InstrumentedCongestionControl to show the sampled cycle
+ * accounting and its overhead. Finally, the cost of constructing each
+ * algorithm is compared with that of a LazyCongestionControl wrapper
+ * around it, which is all a young flow builds.
+ */
+
+static constexpr uint32_t LOSS_INTERVAL = 1000;
+
+// Mean nanoseconds per ACK, best of `repeats` runs
+static double MeasureAckCost(const BenchAlgorithm& algorithm, uint32_t acks, int repeats, bool instrumented) {
+    double best = 0.0;
+
+    for (int r = 0; r < repeats; r++) {
+        std::unique_ptr<CongestionControl> cc = algorithm.create();
+        if (instrumented) {
+            cc = std::make_unique<InstrumentedCongestionControl>(std::move(cc));
+        }
+        std::unique_ptr<SocketState> socket = std::make_unique<SocketState>();
+        socket->cwnd_ = 10 * socket->mss_bytes_;
+
+        uint64_t rtt = 20000;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < acks; i++) {
+            // RTT wanders between 20 and 30 ms
+            rtt = 20000 + (i * 7919u) % 10000;
+            cc->PktsAcked(socket, 1, rtt);
+            cc->IncreaseWindow(socket, 1);
+
+            if (i % LOSS_INTERVAL == LOSS_INTERVAL - 1) {
+                cc->CwndEvent(socket, CongestionEvent::PacketLoss);
+                socket->ssthresh_ = cc->GetSsThresh(socket, socket->cwnd_);
+                socket->cwnd_ = socket->ssthresh_;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / acks;
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+
+    return best;
+}
+
+// Mean nanoseconds to construct and destroy one object from `factory`, best of `repeats` runs
+static double MeasureConstructCost(const CongestionControlFactory& factory, uint32_t count, int repeats) {
+    double best = 0.0;
+
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < count; i++) {
+            std::unique_ptr<CongestionControl> cc = factory();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / count;
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+
+    return best;
+}
+
+// Usage: ack_cost [acks] [repeats]
+int main(int argc, char** argv) {
+    uint32_t acks = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+#ifdef CC_USDT_ENABLED
+    std::printf("USDT probes: built in\n");
+#else
+    std::printf("USDT probes: not built\n");
+#endif
+
+    std::printf("%-6s %12s %14s %16s\n", "", "plain", "instrumented", "sampled cycles");
+    for (const auto& algorithm : BenchmarkRunner::DefaultAlgorithms()) {
+        double plain = MeasureAckCost(algorithm, acks, repeats, false);
+        double wrapped = MeasureAckCost(algorithm, acks, repeats, true);
+
+        std::vector<CycleCostEntry> entries = CycleCostRegistry::Instance().Collect();
+        std::string name = algorithm.create()->GetAlgorithmName();
+        std::printf("%-6s %7.1f ns/ack %7.1f ns/ack %9.0f cycles/ack\n", algorithm.name.c_str(),
+                    plain, wrapped, CycleCostRegistry::CyclesPerAck(entries, name));
+    }
+
+    std::printf("\n%-6s %14s %14s\n", "", "construct", "lazy wrapper");
+    for (const auto& algorithm : BenchmarkRunner::DefaultAlgorithms()) {
+        CongestionControlFactory lazy = LazyCongestionControl::MakeFactory(
+            algorithm.create()->GetTypeId(), algorithm.name, algorithm.create);
+        double full = MeasureConstructCost(algorithm.create, acks / 10, repeats);
+        double young = MeasureConstructCost(lazy, acks / 10, repeats);
+        std::printf("%-6s %10.1f ns %10.1f ns\n", algorithm.name.c_str(), full, young);
+    }
+
+    return 0;
+}
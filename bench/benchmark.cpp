@@ -0,0 +1,305 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 10:02:41
+@Description: Standard scenario benchmark suite implementation
+@Language: C++17
+*/
+
+#include "benchmark.h"
+
+#include "../reno/reno.h"
+#include "../bic/bic.h"
+#include "../cubic/cubic.h"
+#include "../bbr/bbr.h"
+#include "../copa/copa.h"
+#include "../dctcp/dctcp.h"
+#include "../vegas/vegas.h"
+#include "../swift/swift.h"
+#include "../hpcc/hpcc.h"
+#include "../timely/timely.h"
+#include "../ledbat/ledbat.h"
+#include "../sim/metrics.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// Benchmark runner constructor
+BenchmarkRunner::BenchmarkRunner() {
+}
+
+// Register an algorithm
+void BenchmarkRunner::AddAlgorithm(BenchAlgorithm algorithm) {
+    m_algorithms.push_back(std::move(algorithm));
+}
+
+// Register a scenario
+void BenchmarkRunner::AddScenario(BenchScenario scenario) {
+    m_scenarios.push_back(std::move(scenario));
+}
+
+// Set scenario filter
+void BenchmarkRunner::SetScenarioFilter(const std::string& filter) {
+    m_scenarioFilter = filter;
+}
+
+// Set algorithm filter
+void BenchmarkRunner::SetAlgorithmFilter(const std::string& filter) {
+    m_algorithmFilter = filter;
+}
+
+// Run the scenario x algorithm matrix
+std::vector<BenchResult> BenchmarkRunner::RunAll() {
+    std::vector<BenchResult> results;
+
+    for (const auto& scenario : m_scenarios) {
+        if (scenario.name.find(m_scenarioFilter) == std::string::npos) {
+            continue;
+        }
+        for (const auto& algorithm : m_algorithms) {
+            if (algorithm.name.find(m_algorithmFilter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(Run(scenario, algorithm));
+        }
+    }
+
+    return results;
+}
+
+// Flag regressions relative to an earlier run
+void BenchmarkRunner::CompareToBaseline(std::vector<BenchResult>& results,
+                                        const std::vector<BenchResult>& baseline, double tolerance) {
+    for (auto& result : results) {
+        auto it = std::find_if(baseline.begin(), baseline.end(), [&result](const BenchResult& b) {
+            return b.scenario == result.scenario && b.algorithm == result.algorithm;
+        });
+        if (it == baseline.end() || !result.pass) {
+            continue;
+        }
+
+        if (result.throughput_mbps < it->throughput_mbps * (1.0 - tolerance)) {
+            result.pass = false;
+            result.reason = "throughput regressed";
+        } else if (result.delay_p99_ms > it->delay_p99_ms * (1.0 + tolerance) + 1.0) {
+            // 1ms slack so near-empty queues do not fail on noise
+            result.pass = false;
+            result.reason = "delay regressed";
+        } else if (result.jain < it->jain - tolerance / 2.0) {
+            result.pass = false;
+            result.reason = "fairness regressed";
+        }
+    }
+}
+
+// Write results as TSV
+bool BenchmarkRunner::WriteResults(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "scenario\talgorithm\tthroughput_mbps\tutilization\tdelay_p50_ms\tdelay_p99_ms\tjain\tlost_packets\tstatus\treason\n";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (const auto& r : results) {
+        out << r.scenario << '\t' << r.algorithm << '\t'
+            << r.throughput_mbps << '\t' << r.utilization << '\t'
+            << r.delay_p50_ms << '\t' << r.delay_p99_ms << '\t'
+            << r.jain << '\t' << r.lost_packets << '\t'
+            << (r.pass ? "PASS" : "FAIL") << '\t' << (r.reason.empty() ? "-" : r.reason) << '\n';
+    }
+
+    return static_cast<bool>(out);
+}
+
+// Read a TSV written by WriteResults
+bool BenchmarkRunner::LoadResults(const std::string& path, std::vector<BenchResult>& results) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    std::getline(in, line);     // header
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        BenchResult r;
+        std::string status;
+        if (!std::getline(fields, r.scenario, '\t') || !std::getline(fields, r.algorithm, '\t')) {
+            return false;
+        }
+        if (!(fields >> r.throughput_mbps >> r.utilization >> r.delay_p50_ms >> r.delay_p99_ms
+                     >> r.jain >> r.lost_packets >> status)) {
+            return false;
+        }
+        r.pass = status == "PASS";
+        results.push_back(r);
+    }
+
+    return true;
+}
+
+// Every algorithm of the repository
+std::vector<BenchAlgorithm> BenchmarkRunner::DefaultAlgorithms() {
+    return {
+        {"reno",  [] { return std::unique_ptr<CongestionControl>(new Reno()); }},
+        {"bic",   [] { return std::unique_ptr<CongestionControl>(new BIC()); }},
+        {"cubic", [] { return std::unique_ptr<CongestionControl>(new Cubic()); }},
+        {"bbr",   [] { return std::unique_ptr<CongestionControl>(new BBR()); }},
+        {"copa",  [] { return std::unique_ptr<CongestionControl>(new Copa()); }},
+        {"dctcp", [] { return std::unique_ptr<CongestionControl>(new DCTCP()); }},
+        {"vegas", [] { return std::unique_ptr<CongestionControl>(new Vegas()); }},
+        {"swift", [] { return std::unique_ptr<CongestionControl>(new Swift()); }},
+        {"hpcc",  [] { return std::unique_ptr<CongestionControl>(new HPCC()); }},
+        {"timely", [] {
+            // Datacenter defaults scaled to the 10 Mbps bottleneck: RTTs of tens of ms, steps of 1 Mbps
+            Timely* timely = new Timely();
+            timely->SetThresholds(1000, 60000);
+            timely->SetAdditiveIncrease(125000);
+            timely->SetRateLimits(12500, 0);
+            return std::unique_ptr<CongestionControl>(timely);
+        }},
+        {"ledbat", [] { return std::unique_ptr<CongestionControl>(new Ledbat()); }},
+    };
+}
+
+// Standard scenarios on a 10 Mbps bottleneck. The absolute envelopes only
+// catch collapse; per-algorithm expectations come from the baseline file.
+std::vector<BenchScenario> BenchmarkRunner::DefaultScenarios() {
+    const uint64_t rate = 10000000;
+    const uint32_t bdp = 25000;             // 10 Mbps x 20 ms
+    const SimTime sec = 1000000;
+
+    std::vector<BenchScenario> scenarios;
+
+    // Two flows, 10ms vs 40ms base RTT
+    scenarios.push_back({"rtt_unfairness", rate, 2 * bdp, 0.0, 30 * sec,
+                         {{false, 0, 10000}, {false, 0, 40000}},
+                         {}, "", {0.30, 0.0, 0.0}});
+
+    // 10 -> 2 -> 10 Mbps steps
+    scenarios.push_back({"rate_step", rate, 2 * bdp, 0.0, 30 * sec,
+                         {{false, 0, 20000}},
+                         {{10 * sec, 2000000}, {20 * sec, rate}}, "", {0.20, 0.0, 0.0}});
+
+    // One long flow, then 20 flows join at once
+    BenchScenario flash = {"flash_crowd", rate, 2 * bdp, 0.0, 20 * sec,
+                           {{false, 0, 20000}}, {}, "", {0.50, 0.0, 0.0}};
+    for (int i = 0; i < 20; i++) {
+        flash.flows.push_back({false, 5 * sec, 20000});
+    }
+    scenarios.push_back(flash);
+
+    // Buffer depth: 0.25 BDP vs 4 BDP
+    scenarios.push_back({"shallow_buffer", rate, bdp / 4, 0.0, 20 * sec,
+                         {{false, 0, 20000}, {false, 0, 20000}}, {}, "", {0.30, 0.0, 0.0}});
+    scenarios.push_back({"deep_buffer", rate, 4 * bdp, 0.0, 20 * sec,
+                         {{false, 0, 20000}, {false, 0, 20000}}, {}, "", {0.30, 0.0, 0.0}});
+
+    // Random loss. Loss-based algorithms legitimately fall far below capacity at 1% and 5%,
+    // so these floors only catch a flow stalled in back-to-back RTOs
+    scenarios.push_back({"loss_0.1pct", rate, 2 * bdp, 0.001, 20 * sec,
+                         {{false, 0, 20000}}, {}, "", {0.15, 0.0, 0.0}});
+    scenarios.push_back({"loss_1pct", rate, 2 * bdp, 0.01, 20 * sec,
+                         {{false, 0, 20000}}, {}, "", {0.10, 0.0, 0.0}});
+    scenarios.push_back({"loss_5pct", rate, 2 * bdp, 0.05, 20 * sec,
+                         {{false, 0, 20000}}, {}, "", {0.05, 0.0, 0.0}});
+
+    // Competition against CUBIC, the Internet default
+    scenarios.push_back({"mixed_vs_cubic", rate, 2 * bdp, 0.0, 30 * sec,
+                         {{false, 0, 20000}, {true, 0, 20000}}, {}, "cubic", {0.80, 0.0, 0.0}});
+
+    return scenarios;
+}
+
+// Run one scenario with one algorithm
+BenchResult BenchmarkRunner::Run(const BenchScenario& scenario, const BenchAlgorithm& algorithm) {
+    BenchResult result;
+    result.scenario = scenario.name;
+    result.algorithm = algorithm.name;
+    result.pass = true;
+
+    auto link = std::make_unique<FixedRateLink>(scenario.rate_bps);
+    FixedRateLink* linkPtr = link.get();
+    Simulator sim(std::move(link), scenario.buffer_bytes);
+    if (scenario.loss_rate > 0.0) {
+        sim.SetLossModel(std::make_unique<BernoulliLoss>(scenario.loss_rate));
+    }
+
+    // INT only reaches algorithms that read it (HPCC)
+    sim.SetInt(true);
+
+    MetricsEngine metrics;
+    sim.AttachMetrics(&metrics);
+
+    const BenchAlgorithm* competitor = FindAlgorithm(scenario.competitor);
+    std::vector<uint32_t> tested;
+    for (const auto& flow : scenario.flows) {
+        SimFlowConfig config;
+        config.cc = flow.competitor && competitor != nullptr ? competitor->create() : algorithm.create();
+        config.start_us = flow.start_us;
+        config.base_rtt_us = flow.base_rtt_us;
+        uint32_t id = sim.AddFlow(std::move(config));
+        if (!flow.competitor) {
+            tested.push_back(id);
+        }
+    }
+
+    for (const auto& step : scenario.rate_steps) {
+        if (step.time_us >= scenario.duration_us) {
+            break;
+        }
+        sim.Run(step.time_us);
+        linkPtr->SetRateBps(step.rate_bps, step.time_us);
+    }
+    sim.Run(scenario.duration_us);
+
+    uint64_t testedBytes = 0;
+    for (uint32_t id : tested) {
+        testedBytes += sim.GetFlowStats(id).delivered_bytes;
+    }
+    result.lost_packets = 0;
+    for (size_t id = 0; id < sim.GetFlowCount(); id++) {
+        result.lost_packets += sim.GetFlowStats(static_cast<uint32_t>(id)).lost_packets;
+    }
+
+    MetricsSummary summary = metrics.GetSummary();
+    result.throughput_mbps = static_cast<double>(testedBytes) * 8.0 / static_cast<double>(scenario.duration_us);
+    result.utilization = summary.utilization;
+    result.delay_p50_ms = summary.queue_delay_p50_us / 1000.0;
+    result.delay_p99_ms = summary.queue_delay_p99_us / 1000.0;
+    result.jain = summary.windows > 0 ? summary.jain_mean : 1.0;
+
+    // Absolute envelope
+    const BenchEnvelope& env = scenario.envelope;
+    if (env.min_utilization > 0.0 && result.utilization < env.min_utilization) {
+        result.pass = false;
+        result.reason = "utilization below envelope";
+    } else if (env.max_delay_p99_ms > 0.0 && result.delay_p99_ms > env.max_delay_p99_ms) {
+        result.pass = false;
+        result.reason = "delay above envelope";
+    } else if (env.min_jain > 0.0 && result.jain < env.min_jain) {
+        result.pass = false;
+        result.reason = "fairness below envelope";
+    }
+
+    return result;
+}
+
+// Find a registered algorithm by name
+const BenchAlgorithm* BenchmarkRunner::FindAlgorithm(const std::string& name) const {
+    if (name.empty()) {
+        return nullptr;
+    }
+    for (const auto& algorithm : m_algorithms) {
+        if (algorithm.name == name) {
+            return &algorithm;
+        }
+    }
+    return nullptr;
+}
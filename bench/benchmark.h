@@ -0,0 +1,122 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 10:02:41
+@Description: Standard scenario benchmark suite with performance envelopes
+@Language: C++17
+*/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "../sim/simulator.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Algorithm under test
+struct BenchAlgorithm {
+    std::string name;
+    std::function<std::unique_ptr<CongestionControl>()> create;
+};
+
+// One flow of a scenario
+struct BenchFlow {
+    bool competitor;            // driven by the scenario's competitor instead of the algorithm under test
+    SimTime start_us;
+    uint32_t base_rtt_us;
+};
+
+// Bottleneck rate change at a given time
+struct BenchRateStep {
+    SimTime time_us;
+    uint64_t rate_bps;
+};
+
+// Absolute bounds every algorithm must meet (0 disables a bound)
+struct BenchEnvelope {
+    double min_utilization;
+    double max_delay_p99_ms;
+    double min_jain;
+};
+
+// Benchmark scenario
+struct BenchScenario {
+    std::string name;
+    uint64_t rate_bps;                      // initial bottleneck rate
+    uint32_t buffer_bytes;
+    double loss_rate;                       // Bernoulli loss, 0 = none
+    SimTime duration_us;
+    std::vector<BenchFlow> flows;
+    std::vector<BenchRateStep> rate_steps;
+    std::string competitor;                 // algorithm of competitor flows, empty = none
+    BenchEnvelope envelope;
+};
+
+// Result of one scenario x algorithm run
+struct BenchResult {
+    std::string scenario;
+    std::string algorithm;
+    double throughput_mbps;     // goodput of the flows under test
+    double utilization;         // bottleneck utilisation (all flows)
+    double delay_p50_ms;        // queueing delay
+    double delay_p99_ms;
+    double jain;                // mean Jain index over all flows
+    uint64_t lost_packets;
+    bool pass;
+    std::string reason;         // first violated bound
+};
+
+/*
+ * Benchmark runner.
+ *
+ * Every scenario is run once per algorithm on the dumbbell simulator. A
+ * run fails if it leaves its scenario's absolute envelope or, when a
+ * baseline results file is given, if throughput, delay or fairness
+ * regress by more than the tolerance. Results are written as TSV so a
+ * new run can serve as the baseline of the next one.
+ */
+class BenchmarkRunner {
+public:
+    BenchmarkRunner();
+
+    void AddAlgorithm(BenchAlgorithm algorithm);
+    void AddScenario(BenchScenario scenario);
+
+    // Restrict runs to names containing the filter (empty = all)
+    void SetScenarioFilter(const std::string& filter);
+    void SetAlgorithmFilter(const std::string& filter);
+
+    // Run every scenario against every algorithm
+    std::vector<BenchResult> RunAll();
+
+    /**
+     * @brief Check results against a baseline run.
+     *
+     * @param results results to check, `pass`/`reason` are updated
+     * @param baseline earlier results, matched by scenario and algorithm
+     * @param tolerance allowed relative regression (0.2 = 20%)
+     */
+    static void CompareToBaseline(std::vector<BenchResult>& results,
+                                  const std::vector<BenchResult>& baseline, double tolerance);
+
+    static bool WriteResults(const std::string& path, const std::vector<BenchResult>& results);
+    static bool LoadResults(const std::string& path, std::vector<BenchResult>& results);
+
+    // Every algorithm of the repository
+    static std::vector<BenchAlgorithm> DefaultAlgorithms();
+
+    // RTT unfairness, rate steps, flash crowd, buffer depth, random loss, mixed competition
+    static std::vector<BenchScenario> DefaultScenarios();
+
+private:
+    BenchResult Run(const BenchScenario& scenario, const BenchAlgorithm& algorithm);
+    const BenchAlgorithm* FindAlgorithm(const std::string& name) const;
+
+    std::vector<BenchAlgorithm> m_algorithms;
+    std::vector<BenchScenario> m_scenarios;
+    std::string m_scenarioFilter;
+    std::string m_algorithmFilter;
+};
+
+#endif // BENCHMARK_H
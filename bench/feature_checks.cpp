@@ -0,0 +1,894 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 09:12:05
+@Description: Runnable checks for the behaviour that feature changes claim
+@Language: C++17
+*/
+
+#include "benchmark.h"
+#include "../reno/reno.h"
+#include "../bic/bic.h"
+#include "../cubic/cubic.h"
+#include "../bbr/bbr.h"
+#include "../copa/copa.h"
+#include "../dctcp/dctcp.h"
+#include "../hpcc/hpcc.h"
+#include "../timely/timely.h"
+#include "../ledbat/ledbat.h"
+#include "../utils/cold_flow_table.h"
+#include "../utils/lazy_cc.h"
+#include "../utils/min_rtt_service.h"
+#include "../utils/quic_adapter.h"
+#include "../sim/workload.h"
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Each check drives the algorithms or the simulator through a small
+ * scenario and compares the outcome with a bound that leaves some slack
+ * around the measured value. Everything runs on simulated time, so the
+ * results do not depend on the host and a failure is a real change in
+ * behaviour. The process exits non-zero when any check fails.
+ */
+
+// One check: returns true on success and describes what it measured
+struct FeatureCheck {
+    const char* name;
+    bool (*run)(std::string& detail);
+};
+
+// An algorithm under test and how to build a fresh instance of it
+struct Subject {
+    const char* name;
+    std::unique_ptr<CongestionControl> (*create)();
+};
+
+// printf into a std::string
+static std::string Format(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return buffer;
+}
+
+// ---------------------------------------------------------------------------
+// Stretch ACKs: window growth must not depend on how segments are grouped
+// into ACKs.
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t STRETCH_MSS = 536;
+
+// cwnd at the start of each round of congestion avoidance with `perAck` segments per ACK
+static std::vector<uint32_t> GrowthWithAckSize(std::unique_ptr<CongestionControl> cc, uint32_t perAck) {
+    // A 536 byte MSS leaves room to grow under the algorithms' 64KB max window
+    static constexpr uint32_t RTT_US = 100000;
+    static constexpr uint32_t ROUNDS = 20;
+    std::unique_ptr<SocketState> socket = std::make_unique<SocketState>();
+    socket->mss_bytes_ = STRETCH_MSS;
+    socket->cwnd_ = 40 * socket->mss_bytes_;
+    socket->now_us_ = 1;
+
+    // Prime the RTT, then leave slow start through a loss as the stack would
+    cc->PktsAcked(socket, 1, RTT_US);
+    cc->IncreaseWindow(socket, 1);
+    cc->CwndEvent(socket, CongestionEvent::PacketLoss);
+    socket->cwnd_ = std::min(socket->cwnd_, socket->ssthresh_);
+    cc->CongestionStateSet(socket, TCPState::Open);
+
+    // Each round acknowledges one window, spread evenly over the RTT
+    std::vector<uint32_t> trajectory;
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        trajectory.push_back(socket->cwnd_);
+        uint32_t window = std::max<uint32_t>(socket->cwnd_ / socket->mss_bytes_, 1);
+        uint64_t roundStart = socket->now_us_;
+        for (uint32_t acked = 0; acked < window;) {
+            uint32_t segments = std::min(perAck, window - acked);
+            acked += segments;
+            socket->now_us_ = roundStart + static_cast<uint64_t>(RTT_US) * acked / window;
+            cc->PktsAcked(socket, segments, RTT_US);
+            cc->IncreaseWindow(socket, segments);
+        }
+    }
+    trajectory.push_back(socket->cwnd_);
+    return trajectory;
+}
+
+// Largest per-round difference between two trajectories, in segments
+static double MaxDeviation(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+        worst = std::max(worst, std::fabs(static_cast<double>(a[i]) - b[i]) / STRETCH_MSS);
+    }
+    return worst;
+}
+
+static bool CheckStretchAckGrowth(std::string& detail) {
+    const Subject subjects[] = {
+        {"reno",  [] { return std::unique_ptr<CongestionControl>(new Reno()); }},
+        {"bic",   [] { return std::unique_ptr<CongestionControl>(new BIC()); }},
+        {"cubic", [] { return std::unique_ptr<CongestionControl>(new Cubic()); }},
+    };
+
+    // Per round, 2 or 8 segments per ACK stay within two segments of 1 per ACK; Cubic's
+    // per-ACK cnt rounding near W_max can move one increase across a round boundary
+    bool ok = true;
+    for (const Subject& subject : subjects) {
+        std::vector<uint32_t> one = GrowthWithAckSize(subject.create(), 1);
+        std::vector<uint32_t> two = GrowthWithAckSize(subject.create(), 2);
+        std::vector<uint32_t> eight = GrowthWithAckSize(subject.create(), 8);
+
+        double worst = std::max(MaxDeviation(one, two), MaxDeviation(one, eight));
+        ok = ok && worst <= 2.0 && one.back() > one.front();
+        detail += Format("%s%s %u->%u seg dev %.1f", detail.empty() ? "" : ", ", subject.name,
+                         one.front() / STRETCH_MSS, one.back() / STRETCH_MSS, worst);
+    }
+    detail += " (1 vs 2/8 segments per ACK)";
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Pacing from CcDecision: window-based algorithms paced at cwnd/RTT x 1.2
+// (x 2 in slow start) must still fill the link.
+// ---------------------------------------------------------------------------
+
+// Goodput of one long flow over 10 Mbps / 20ms with a 2 BDP buffer, in Mbps
+static double LongFlowGoodput(std::unique_ptr<CongestionControl> cc, bool pacing, uint64_t& bursts) {
+    static constexpr SimTime DURATION_US = 20000000;
+    Simulator sim(std::make_unique<FixedRateLink>(10000000), 50000);
+    sim.SetPacing(pacing);
+    SimFlowConfig config;
+    config.cc = std::move(cc);
+    uint32_t id = sim.AddFlow(std::move(config));
+    sim.Run(DURATION_US);
+    bursts = sim.GetFlowStats(id).send_bursts;
+    return sim.GetFlowStats(id).delivered_bytes * 8.0 / DURATION_US;
+}
+
+static bool CheckPacedWindowThroughput(std::string& detail) {
+    const Subject subjects[] = {
+        {"reno",  [] { return std::unique_ptr<CongestionControl>(new Reno()); }},
+        {"cubic", [] { return std::unique_ptr<CongestionControl>(new Cubic()); }},
+    };
+
+    bool ok = true;
+    for (const Subject& subject : subjects) {
+        uint64_t unpacedBursts = 0;
+        uint64_t pacedBursts = 0;
+        double unpaced = LongFlowGoodput(subject.create(), false, unpacedBursts);
+        double paced = LongFlowGoodput(subject.create(), true, pacedBursts);
+        ok = ok && pacedBursts > 0 && paced >= 9.0 && paced >= 0.95 * unpaced;
+        detail += Format("%s%s %.2f Mbps paced vs %.2f unpaced", detail.empty() ? "" : ", ",
+                         subject.name, paced, unpaced);
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Send quantum: a paced sender hands the NIC about 1ms of data per pacing
+// slot (2 MSS below 24 Mbps) instead of one packet, without losing rate.
+// ---------------------------------------------------------------------------
+
+// One paced BBR flow over `rateBps` / 2ms for 5s; returns goodput as a share of the link
+static double PacedBursts(uint64_t rateBps, uint64_t& packets, uint64_t& bursts) {
+    static constexpr SimTime DURATION_US = 5000000;
+    Simulator sim(std::make_unique<FixedRateLink>(rateBps), 500000);
+    sim.SetPacing(true);
+    SimFlowConfig config;
+    config.cc = std::unique_ptr<CongestionControl>(new BBR());
+    config.base_rtt_us = 2000;
+    uint32_t mss = config.mss;
+    uint32_t id = sim.AddFlow(std::move(config));
+    sim.Run(DURATION_US);
+    const SimFlowStats& stats = sim.GetFlowStats(id);
+    packets = stats.sent_bytes / mss;
+    bursts = stats.send_bursts;
+    return stats.delivered_bytes * 8.0 * 1000000 / DURATION_US / rateBps;
+}
+
+static bool CheckSendQuantumBursts(std::string& detail) {
+    uint64_t fastPackets = 0;
+    uint64_t fastBursts = 0;
+    uint64_t slowPackets = 0;
+    uint64_t slowBursts = 0;
+    double fast = PacedBursts(100000000, fastPackets, fastBursts);
+    double slow = PacedBursts(10000000, slowPackets, slowBursts);
+    double fastRatio = static_cast<double>(fastPackets) / std::max<uint64_t>(fastBursts, 1);
+    double slowRatio = static_cast<double>(slowPackets) / std::max<uint64_t>(slowBursts, 1);
+
+    // 1ms at 100 Mbps is 8 full segments; 10 Mbps falls in the 2 MSS band
+    detail = Format("100 Mbps: %.1f packets per burst, util %.3f; 10 Mbps: %.1f per burst, util %.3f",
+                    fastRatio, fast, slowRatio, slow);
+    return fastRatio >= 6.0 && fast >= 0.95 && slowRatio >= 1.5 && slowRatio <= 2.5 && slow >= 0.95;
+}
+
+// ---------------------------------------------------------------------------
+// BBR ACK aggregation: when ACKs arrive in batches, extra_acked tracks the
+// batch and the window it adds keeps the pacing sender from stalling
+// between batches.
+// ---------------------------------------------------------------------------
+
+// BBR without the extra_acked window, as before aggregation compensation existed
+class BbrWithoutAckAggregation: public BBR {
+protected:
+    uint32_t GetAckAggregationCwnd() const override { return 0; }
+};
+
+// Link utilization of one paced BBR flow, 20 Mbps / 10ms, ACKs released every
+// `intervalUs` (0 = no aggregation) for 20s
+static double AggregatedAckUtilization(BBR* bbr, uint32_t intervalUs, uint32_t& extraAcked) {
+    static constexpr uint64_t RATE_BPS = 20000000;
+    static constexpr SimTime DURATION_US = 20000000;
+    Simulator sim(std::make_unique<FixedRateLink>(RATE_BPS), 200000);
+    sim.SetPacing(true);
+    AckPathConfig ackPath;
+    ackPath.aggregation = intervalUs != 0;
+    ackPath.aggregation_interval_us = intervalUs;
+    sim.SetAckPath(std::move(ackPath));
+    SimFlowConfig config;
+    config.cc = std::unique_ptr<CongestionControl>(bbr);
+    config.base_rtt_us = 10000;
+    uint32_t id = sim.AddFlow(std::move(config));
+    sim.Run(DURATION_US);
+    extraAcked = bbr->GetExtraAcked();
+    return sim.GetFlowStats(id).delivered_bytes * 8.0 * 1000000 / DURATION_US / RATE_BPS;
+}
+
+static bool CheckBbrAckAggregation(std::string& detail) {
+    static constexpr uint32_t INTERVAL_US = 10000;
+    uint32_t plainExtra = 0;
+    uint32_t withExtra = 0;
+    uint32_t withoutExtra = 0;
+    double plain = AggregatedAckUtilization(new BBR(), 0, plainExtra);
+    double with = AggregatedAckUtilization(new BBR(), INTERVAL_US, withExtra);
+    double without = AggregatedAckUtilization(new BbrWithoutAckAggregation(), INTERVAL_US, withoutExtra);
+
+    // One 10ms batch at 20 Mbps is 25000 bytes
+    detail = Format("10ms ACK batches: util %.3f with extra_acked (%u bytes) vs %.3f without, "
+                    "%.3f unaggregated (extra_acked %u)",
+                    with, withExtra, without, plain, plainExtra);
+    return with >= 0.95 && with >= without + 0.15 && withExtra >= 15000 && withExtra <= 40000 &&
+           plainExtra <= 2 * 1460;
+}
+
+// ---------------------------------------------------------------------------
+// BBR lt_bw: behind a token-bucket policer, paced BBR pins its bandwidth
+// to the policed rate and loses fewer packets than without lt_bw.
+// ---------------------------------------------------------------------------
+
+// BBR with long-term sampling switched off, as before lt_bw existed
+class BbrWithoutLtBw: public BBR {
+protected:
+    void UpdateLongTermBandwidth(std::unique_ptr<SocketState>& socket) override {}
+};
+
+// One paced BBR flow, 20 Mbps / 20ms, through a 5 Mbps policer with a 30KB bucket for 20s.
+// Returns the share of sent bytes that was lost
+static double PolicedLoss(BBR* bbr, double& pinnedShare, uint64_t& ltBw) {
+    static constexpr SimTime DURATION_US = 20000000;
+    Simulator sim(std::make_unique<FixedRateLink>(20000000), 100000);
+    sim.SetPacing(true);
+    sim.SetLossModel(std::unique_ptr<LossModel>(new TokenBucketPolicer(5000000, 30000)));
+    SimFlowConfig config;
+    config.cc = std::unique_ptr<CongestionControl>(bbr);
+    uint32_t mss = config.mss;
+    uint32_t id = sim.AddFlow(std::move(config));
+
+    // Sample the pin every 100ms
+    uint32_t pinned = 0;
+    uint32_t samples = 0;
+    ltBw = 0;
+    for (SimTime t = 100000; t <= DURATION_US; t += 100000) {
+        sim.Run(t);
+        if (bbr->IsUsingLongTermBandwidth()) {
+            pinned++;
+            ltBw = bbr->GetLongTermBandwidth();
+        }
+        samples++;
+    }
+    pinnedShare = static_cast<double>(pinned) / samples;
+
+    const SimFlowStats& stats = sim.GetFlowStats(id);
+    return static_cast<double>(stats.lost_packets) * mss / stats.sent_bytes;
+}
+
+static bool CheckBbrPolicerLtBw(std::string& detail) {
+    double pinnedShare = 0.0;
+    double unusedShare = 0.0;
+    uint64_t ltBw = 0;
+    uint64_t unusedBw = 0;
+    double withLtBw = PolicedLoss(new BBR(), pinnedShare, ltBw);
+    double withoutLtBw = PolicedLoss(new BbrWithoutLtBw(), unusedShare, unusedBw);
+
+    double ltMbps = ltBw * 8.0 / 1e6;
+    detail = Format("lt_bw %.2f Mbps for %.0f%% of the run, loss %.1f%% vs %.1f%% without lt_bw",
+                    ltMbps, 100.0 * pinnedShare, 100.0 * withLtBw, 100.0 * withoutLtBw);
+    return std::fabs(ltMbps - 5.0) <= 0.5 && pinnedShare >= 0.5 && withLtBw <= 0.75 * withoutLtBw;
+}
+
+// ---------------------------------------------------------------------------
+// Shared min RTT: BBR flows to one destination use the group's min RTT and
+// probe it together instead of each on its own schedule.
+// ---------------------------------------------------------------------------
+
+// Outcome of one shared min RTT run
+struct ProbeRttRun {
+    double probing;             // share of ticks in which some flow is in PROBE_RTT
+    uint32_t min_rtt_low;       // lowest and highest min RTT across the flows
+    uint32_t min_rtt_high;
+    uint32_t group_min_rtt;     // the service's min RTT, 0 without a service
+    uint64_t group_probes;
+};
+
+// 20 BBR flows over 100 Mbps / 20ms starting over 9.5s, 60s run, sampled every 50ms after 12s
+static ProbeRttRun RunProbeRtt(MinRttService* service) {
+    static constexpr int FLOWS = 20;
+    Simulator sim(std::make_unique<FixedRateLink>(100000000), 250000);
+    BBR* flows[FLOWS];
+    for (int i = 0; i < FLOWS; i++) {
+        flows[i] = new BBR();
+        if (service != nullptr) {
+            flows[i]->SetMinRttService(service, 1);
+        }
+        SimFlowConfig config;
+        config.cc = std::unique_ptr<CongestionControl>(flows[i]);
+        config.start_us = i * 473000;
+        sim.AddFlow(std::move(config));
+    }
+
+    uint32_t probing = 0;
+    uint32_t ticks = 0;
+    for (SimTime t = 12050000; t <= 60000000; t += 50000) {
+        sim.Run(t);
+        for (BBR* bbr : flows) {
+            if (bbr->GetMode() == BBRMode::PROBE_RTT) {
+                probing++;
+                break;
+            }
+        }
+        ticks++;
+    }
+
+    // The group goes away with its members, so read it while the flows exist
+    ProbeRttRun run;
+    run.probing = static_cast<double>(probing) / ticks;
+    run.min_rtt_low = 0xFFFFFFFF;
+    run.min_rtt_high = 0;
+    std::unique_ptr<SocketState> unused;
+    for (BBR* bbr : flows) {
+        uint32_t minRtt = bbr->GetModelSnapshot(unused).min_rtt_us;
+        run.min_rtt_low = std::min(run.min_rtt_low, minRtt);
+        run.min_rtt_high = std::max(run.min_rtt_high, minRtt);
+    }
+    run.group_min_rtt = service != nullptr ? service->GetMinRtt(1) : 0;
+    run.group_probes = service != nullptr ? service->GetProbeCount(1) : 0;
+    return run;
+}
+
+static bool CheckSharedMinRtt(std::string& detail) {
+    MinRttService service;
+    ProbeRttRun own = RunProbeRtt(nullptr);
+    ProbeRttRun shared = RunProbeRtt(&service);
+
+    detail = Format("PROBE_RTT in %.1f%% of ticks vs %.1f%% on own timers (%llu group probes), "
+                    "min RTT %u us in every flow vs %u..%u us",
+                    100.0 * shared.probing, 100.0 * own.probing,
+                    static_cast<unsigned long long>(shared.group_probes), shared.min_rtt_low,
+                    own.min_rtt_low, own.min_rtt_high);
+    return shared.probing <= 0.05 && shared.probing * 4 <= own.probing &&
+           shared.min_rtt_low == shared.min_rtt_high && shared.min_rtt_low == shared.group_min_rtt;
+}
+
+// ---------------------------------------------------------------------------
+// Determinism: the benchmark gate only works if a run depends on nothing
+// but the simulated clock.
+// ---------------------------------------------------------------------------
+
+static bool SameResult(const BenchResult& a, const BenchResult& b) {
+    return a.scenario == b.scenario && a.algorithm == b.algorithm &&
+           a.throughput_mbps == b.throughput_mbps && a.utilization == b.utilization &&
+           a.delay_p50_ms == b.delay_p50_ms && a.delay_p99_ms == b.delay_p99_ms &&
+           a.jain == b.jain && a.lost_packets == b.lost_packets;
+}
+
+static bool CheckDeterministicRuns(std::string& detail) {
+    // Loss and competition exercise the loss epochs and RTT windows of every algorithm
+    std::vector<BenchResult> runs[2];
+    for (std::vector<BenchResult>& results : runs) {
+        BenchmarkRunner runner;
+        for (BenchAlgorithm& algorithm : BenchmarkRunner::DefaultAlgorithms()) {
+            runner.AddAlgorithm(std::move(algorithm));
+        }
+        for (BenchScenario& scenario : BenchmarkRunner::DefaultScenarios()) {
+            runner.AddScenario(std::move(scenario));
+        }
+        runner.SetScenarioFilter("loss_1pct");
+        results = runner.RunAll();
+        runner.SetScenarioFilter("mixed_vs_cubic");
+        std::vector<BenchResult> mixed = runner.RunAll();
+        results.insert(results.end(), mixed.begin(), mixed.end());
+    }
+
+    size_t differing = 0;
+    for (size_t i = 0; i < runs[0].size(); i++) {
+        if (i >= runs[1].size() || !SameResult(runs[0][i], runs[1][i])) {
+            if (differing == 0) {
+                detail = Format("first difference %s/%s, ", runs[0][i].scenario.c_str(),
+                                runs[0][i].algorithm.c_str());
+            }
+            differing++;
+        }
+    }
+    detail += Format("%zu of %zu runs differ between two passes", differing, runs[0].size());
+    return differing == 0 && !runs[0].empty() && runs[0].size() == runs[1].size();
+}
+
+// ---------------------------------------------------------------------------
+// RTO recovery: the one-segment ABC limit of the loss state must end once
+// the data outstanding at the timeout has been acknowledged.
+// ---------------------------------------------------------------------------
+
+// Drops every packet sent inside a time window
+class BlackoutLoss: public LossModel {
+public:
+    BlackoutLoss(SimTime startUs, SimTime endUs) : m_startUs(startUs), m_endUs(endUs) {}
+
+    bool ShouldDrop(const SimPacket& packet) override {
+        return packet.sent_us >= m_startUs && packet.sent_us < m_endUs;
+    }
+
+private:
+    SimTime m_startUs;
+    SimTime m_endUs;
+};
+
+static bool CheckRtoLeavesLossState(std::string& detail) {
+    const Subject subjects[] = {
+        {"reno",  [] { return std::unique_ptr<CongestionControl>(new Reno()); }},
+        {"bic",   [] { return std::unique_ptr<CongestionControl>(new BIC()); }},
+        {"dctcp", [] { return std::unique_ptr<CongestionControl>(new DCTCP()); }},
+    };
+
+    // 10 Mbps, 20ms, everything sent between 1s and 1.5s is lost
+    bool ok = true;
+    for (const Subject& subject : subjects) {
+        Simulator sim(std::make_unique<FixedRateLink>(10000000), 50000);
+        sim.SetLossModel(std::make_unique<BlackoutLoss>(1000000, 1500000));
+        SimFlowConfig config;
+        config.cc = subject.create();
+        uint32_t id = sim.AddFlow(std::move(config));
+        sim.Run(4000000);
+
+        const SimFlowStats& stats = sim.GetFlowStats(id);
+        TCPState state = sim.GetSocket(id)->tcp_state_;
+        ok = ok && stats.timeouts > 0 && state == TCPState::Open;
+        detail += Format("%s%s %llu RTOs, %s", detail.empty() ? "" : ", ", subject.name,
+                         static_cast<unsigned long long>(stats.timeouts),
+                         state == TCPState::Open ? "open" : "still in loss");
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Lazy construction: most short flows of a web-like workload finish on the
+// young slow start without building the real algorithm.
+// ---------------------------------------------------------------------------
+
+static constexpr uint64_t LAZY_LINK_BPS = 100000000;
+static constexpr uint32_t LAZY_RTT_US = 2000;
+
+// Poisson web workload at 50% load; returns the number of flows
+static size_t RunWebWorkload(uint64_t seed, const CongestionControlFactory& factory) {
+    FlowSizeCdf cdf;
+    cdf.AddPoint(1000, 0);
+    cdf.AddPoint(10000, 50);
+    cdf.AddPoint(50000, 80);
+    cdf.AddPoint(200000, 95);
+    cdf.AddPoint(2000000, 100);
+    WorkloadGenerator workload(seed);
+    workload.AddPoisson(cdf, 0.5, LAZY_LINK_BPS, 0, 2000000, 8);
+
+    Simulator sim(std::make_unique<FixedRateLink>(LAZY_LINK_BPS), 200000);
+    std::vector<uint32_t> ids = workload.Install(sim, factory, LAZY_RTT_US);
+    sim.Run(5000000);
+    return ids.size();
+}
+
+static bool CheckLazyShortFlows(std::string& detail) {
+    const Subject subjects[] = {
+        {"BBR",  [] { return std::unique_ptr<CongestionControl>(new BBR()); }},
+        {"Copa", [] { return std::unique_ptr<CongestionControl>(new Copa()); }},
+    };
+
+    bool ok = true;
+    for (const Subject& subject : subjects) {
+        // The wrapper reports the real algorithm's type id before building it
+        TypeId typeId = subject.create()->GetTypeId();
+        size_t flows = 0;
+        size_t built = 0;
+        for (uint64_t seed = 1; seed <= 3; seed++) {
+            auto create = subject.create;
+            CongestionControlFactory counted = [&built, create] {
+                built++;
+                return create();
+            };
+            flows += RunWebWorkload(seed, LazyCongestionControl::MakeFactory(typeId, subject.name, counted));
+        }
+        double neverBuilt = flows > 0 ? 1.0 - static_cast<double>(built) / flows : 0.0;
+        ok = ok && neverBuilt >= 0.7;
+        detail += Format("%s%s %.0f%% of %zu flows never built", detail.empty() ? "" : ", ",
+                         subject.name, 100.0 * neverBuilt, flows);
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Cold flows: a frozen flow costs its 32-byte summary plus the slot array's
+// growth slack, and idle time runs from the flow's last activity rather
+// than from the freeze.
+// ---------------------------------------------------------------------------
+
+static bool CheckColdFlowRestart(std::string& detail) {
+    ColdFlowTable table;
+    table.SetFactory(CongestionAlgorithm::CUBIC, [] { return std::unique_ptr<CongestionControl>(new Cubic()); });
+    table.SetFactory(CongestionAlgorithm::BBR, [] { return std::unique_ptr<CongestionControl>(new BBR()); });
+
+    // Frozen at the 5s idle timeout, traffic resumes 100ms later: 5.1s idle, 23 RTOs
+    std::unique_ptr<CongestionControl> cc(new Cubic());
+    std::unique_ptr<SocketState> socket = std::make_unique<SocketState>();
+    socket->cwnd_ = 60000;
+    socket->ssthresh_ = 40000;
+    socket->rto_us_ = 220000;
+    uint64_t lastActivity = 1000000;
+    uint64_t freezeAt = lastActivity + ColdFlowTable::DEFAULT_IDLE_TIMEOUT_US;
+    uint32_t handle = table.Freeze(cc, socket, lastActivity);
+    bool thawed = table.Thaw(handle, freezeAt + 100000, cc, socket);
+    uint32_t restartCwnd = ColdFlowTable::RESTART_WINDOW_SEGMENTS * socket->mss_bytes_;
+    bool restartOk = thawed && socket->cwnd_ == restartCwnd && socket->ssthresh_ == 45000;
+    detail = Format("cubic after 5.1s idle cwnd %u ssthresh %u", socket->cwnd_, socket->ssthresh_);
+
+    // BBR models survive 6s of idle time but not 11s
+    uint64_t bandwidth[2] = {0, 0};
+    const uint64_t idleTimes[2] = {6000000, 11000000};
+    for (int i = 0; i < 2; i++) {
+        std::unique_ptr<CongestionControl> bbr(new BBR());
+        std::unique_ptr<SocketState> bbrSocket = std::make_unique<SocketState>();
+        uint64_t now = 1000;
+        for (int ack = 0; ack < 2000; ack++) {
+            now += 100;
+            bbrSocket->now_us_ = now;
+            bbr->PktsAcked(bbrSocket, 1, 20000);
+            bbr->IncreaseWindow(bbrSocket, 1);
+        }
+        handle = table.Freeze(bbr, bbrSocket, now);
+        thawed = thawed && table.Thaw(handle, now + idleTimes[i], bbr, bbrSocket);
+        bandwidth[i] = bbr->GetModelSnapshot(bbrSocket).bandwidth;
+    }
+    bool modelOk = bandwidth[0] > 0 && bandwidth[1] == 0;
+    detail += Format(", bbr model after 6s %s, after 11s %s", bandwidth[0] > 0 ? "restored" : "lost",
+                     bandwidth[1] > 0 ? "restored" : "dropped");
+
+    // Resident cost of 100k frozen flows: 100k summaries in 128k slots
+    for (int i = 0; i < 100000; i++) {
+        std::unique_ptr<CongestionControl> idle(new Cubic());
+        std::unique_ptr<SocketState> idleSocket = std::make_unique<SocketState>();
+        table.Freeze(idle, idleSocket, 0);
+    }
+    double perFlow = static_cast<double>(table.GetMemoryBytes()) / table.Size();
+    detail += Format(", %.1f bytes per frozen flow (%zu-byte summary)", perFlow, sizeof(ColdFlowSummary));
+
+    return thawed && restartOk && modelOk && perFlow <= 1.5 * sizeof(ColdFlowSummary);
+}
+
+// ---------------------------------------------------------------------------
+// QUIC ECN: new CE counts are a congestion signal even on a frame that
+// acknowledges nothing new, dated by the frame's largest acknowledged packet.
+// ---------------------------------------------------------------------------
+
+static bool CheckQuicEcnCounts(std::string& detail) {
+    QuicCongestionAdapter quic(std::unique_ptr<CongestionControl>(new Reno()));
+    QuicEcnCounts ecn;
+    for (uint64_t pn = 0; pn < 10; pn++) {
+        quic.OnPacketSent(pn, 1200, 1000 + pn * 100);
+    }
+    quic.OnAckFrame({{0, 9}}, 0, &ecn, 30000);
+    uint32_t before = quic.GetCongestionWindow();
+
+    // Same ranges again, only the CE count moved
+    ecn.ce = 1;
+    quic.OnAckFrame({{0, 9}}, 0, &ecn, 31000);
+    uint32_t afterRepeat = quic.GetCongestionWindow();
+    bool repeatOk = afterRepeat < before && quic.InRecovery();
+
+    // A further CE mark for packets sent before the recovery period started is the same event
+    ecn.ce = 2;
+    quic.OnAckFrame({{0, 9}}, 0, &ecn, 32000);
+    bool onceOk = quic.GetCongestionWindow() == afterRepeat;
+
+    detail = Format("cwnd %u -> %u on a repeated frame with a new CE count, %u after a second mark in recovery",
+                    before, afterRepeat, quic.GetCongestionWindow());
+    return repeatOk && onceOk;
+}
+
+// ---------------------------------------------------------------------------
+// HPCC: with INT on, two flows converge to a fair share of a 1 Gbps link
+// while the queue stays within a few packets.
+// ---------------------------------------------------------------------------
+
+static double Jain(double a, double b) {
+    return (a + b) * (a + b) / (2.0 * (a * a + b * b));
+}
+
+static bool CheckHpccConvergence(std::string& detail) {
+    static constexpr uint64_t RATE_BPS = 1000000000;
+    Simulator sim(std::make_unique<FixedRateLink>(RATE_BPS), 1000000);
+    sim.SetPacing(true);
+    sim.SetInt(true);
+
+    // Second flow joins 2ms later; measure from 20ms to 60ms
+    uint32_t ids[2];
+    for (int i = 0; i < 2; i++) {
+        SimFlowConfig config;
+        config.cc = std::unique_ptr<CongestionControl>(new HPCC());
+        config.base_rtt_us = 100;
+        config.start_us = i * 2000;
+        ids[i] = sim.AddFlow(std::move(config));
+    }
+
+    sim.Run(20000);
+    uint64_t start[2] = {sim.GetFlowStats(ids[0]).delivered_bytes, sim.GetFlowStats(ids[1]).delivered_bytes};
+    uint64_t queueSum = 0;
+    uint32_t queueMax = 0;
+    uint32_t samples = 0;
+    for (SimTime t = 20100; t <= 60000; t += 100) {
+        sim.Run(t);
+        queueSum += sim.GetQueueBytes();
+        queueMax = std::max(queueMax, sim.GetQueueBytes());
+        samples++;
+    }
+
+    double rate[2];
+    for (int i = 0; i < 2; i++) {
+        rate[i] = (sim.GetFlowStats(ids[i]).delivered_bytes - start[i]) * 8.0 / 40000e-6 / RATE_BPS;
+    }
+    double jain = Jain(rate[0], rate[1]);
+    double queueMean = static_cast<double>(queueSum) / samples;
+    detail = Format("shares %.2f / %.2f of 1 Gbps, jain %.3f, queue mean %.0f max %u bytes",
+                    rate[0], rate[1], jain, queueMean, queueMax);
+    return jain >= 0.95 && rate[0] + rate[1] >= 0.9 && queueMax <= 15000;
+}
+
+// ---------------------------------------------------------------------------
+// TIMELY: the RTT gradient keeps the queue near empty on a 1 Gbps / 30us
+// fabric, where DCTCP (ECN at 20KB) settles around its marking threshold,
+// and an 8-to-1 incast loses nothing.
+// ---------------------------------------------------------------------------
+
+static constexpr uint64_t FABRIC_RATE_BPS = 1000000000;
+static constexpr uint32_t FABRIC_RTT_US = 30;
+static constexpr uint32_t FABRIC_ECN_BYTES = 20000;
+
+// Two long flows, the second 20ms late; mean queue and utilization from 40ms to 200ms
+static void FabricLongFlows(std::unique_ptr<CongestionControl> (*create)(), bool timely,
+                            double& queueMean, double& utilization) {
+    Simulator sim(std::make_unique<FixedRateLink>(FABRIC_RATE_BPS), 500000);
+    sim.SetPacing(timely);
+    if (!timely) {
+        sim.SetEcnThreshold(FABRIC_ECN_BYTES);
+    }
+    uint32_t ids[2];
+    for (int i = 0; i < 2; i++) {
+        SimFlowConfig config;
+        config.cc = create();
+        config.base_rtt_us = FABRIC_RTT_US;
+        config.start_us = i * 20000;
+        ids[i] = sim.AddFlow(std::move(config));
+    }
+
+    sim.Run(40000);
+    uint64_t start = sim.GetFlowStats(ids[0]).delivered_bytes + sim.GetFlowStats(ids[1]).delivered_bytes;
+    uint64_t queueSum = 0;
+    uint32_t samples = 0;
+    for (SimTime t = 40100; t <= 200000; t += 100) {
+        sim.Run(t);
+        queueSum += sim.GetQueueBytes();
+        samples++;
+    }
+    uint64_t delivered = sim.GetFlowStats(ids[0]).delivered_bytes + sim.GetFlowStats(ids[1]).delivered_bytes - start;
+    queueMean = static_cast<double>(queueSum) / samples;
+    utilization = delivered * 8.0 / 160000e-6 / FABRIC_RATE_BPS;
+}
+
+static bool CheckTimelyQueue(std::string& detail) {
+    auto timely = [] { return std::unique_ptr<CongestionControl>(new Timely()); };
+    auto dctcp = [] { return std::unique_ptr<CongestionControl>(new DCTCP()); };
+
+    double timelyQueue = 0.0;
+    double timelyUtil = 0.0;
+    double dctcpQueue = 0.0;
+    double dctcpUtil = 0.0;
+    FabricLongFlows(timely, true, timelyQueue, timelyUtil);
+    FabricLongFlows(dctcp, false, dctcpQueue, dctcpUtil);
+
+    // 8-to-1 incast of 200KB each
+    WorkloadGenerator workload(1);
+    workload.AddIncast(8, 200000, 1000, 50);
+    Simulator sim(std::make_unique<FixedRateLink>(FABRIC_RATE_BPS), 200000);
+    sim.SetPacing(true);
+    std::vector<uint32_t> ids = workload.Install(sim, timely, FABRIC_RTT_US);
+    sim.Run(5000000);
+    uint64_t lost = 0;
+    size_t finished = 0;
+    for (uint32_t id : ids) {
+        lost += sim.GetFlowStats(id).lost_packets;
+        finished += sim.GetFlowStats(id).finished ? 1 : 0;
+    }
+
+    detail = Format("queue %.1f KB at util %.2f (dctcp %.1f KB at %.2f), incast 8x200KB %llu lost, %zu/%zu done",
+                    timelyQueue / 1000, timelyUtil, dctcpQueue / 1000, dctcpUtil,
+                    static_cast<unsigned long long>(lost), finished, ids.size());
+    // DCTCP holding its queue near the marking threshold shows its ECN path works
+    return timelyQueue <= 10000 && timelyQueue * 5 <= dctcpQueue && dctcpQueue <= 1.5 * FABRIC_ECN_BYTES &&
+           timelyUtil >= 0.85 && lost == 0 && finished == ids.size();
+}
+
+// ---------------------------------------------------------------------------
+// Receiver-driven mode: SRPT grants and trimming finish an N-to-1 incast
+// close to the ideal time, where sender-driven DCTCP falls into RTOs: its
+// initial windows overflow the buffer before the first CE echo returns.
+// ---------------------------------------------------------------------------
+
+// Slowest completion of a `fanIn`-to-1 incast of 64KB each (1 Gbps, 100us, 200KB buffer)
+static SimTime IncastSlowestFct(uint32_t fanIn, bool receiverDriven, uint64_t& timeouts) {
+    WorkloadGenerator workload(1);
+    workload.AddIncast(fanIn, 64000, 1000, 20);
+    Simulator sim(std::make_unique<FixedRateLink>(FABRIC_RATE_BPS), 200000);
+    if (receiverDriven) {
+        sim.SetReceiverDriven(ReceiverDrivenConfig());
+    } else {
+        sim.SetEcnThreshold(FABRIC_ECN_BYTES);
+    }
+    std::vector<uint32_t> ids = workload.Install(
+        sim, [] { return std::unique_ptr<CongestionControl>(new DCTCP()); }, 100);
+    sim.Run(20000000);
+
+    SimTime slowest = 0;
+    timeouts = 0;
+    for (uint32_t id : ids) {
+        const SimFlowStats& stats = sim.GetFlowStats(id);
+        timeouts += stats.timeouts;
+        slowest = std::max(slowest, stats.finished ? stats.finish_us - stats.start_us : SimTime(20000000));
+    }
+    return slowest;
+}
+
+static bool CheckReceiverDrivenIncast(std::string& detail) {
+    bool ok = true;
+    for (uint32_t fanIn : {32u, 100u}) {
+        uint64_t rdTimeouts = 0;
+        uint64_t dctcpTimeouts = 0;
+        SimTime receiverDriven = IncastSlowestFct(fanIn, true, rdTimeouts);
+        SimTime dctcp = IncastSlowestFct(fanIn, false, dctcpTimeouts);
+
+        // Everything through the bottleneck back to back
+        double ideal = fanIn * 64000 * 8.0 / FABRIC_RATE_BPS * 1e6;
+        ok = ok && rdTimeouts == 0 && receiverDriven <= 1.2 * ideal && dctcp >= 10 * receiverDriven;
+        detail += Format("%s%u-to-1 %.1f ms (ideal %.1f, dctcp %.1f ms, %llu RTOs)", detail.empty() ? "" : ", ",
+                         fanIn, receiverDriven / 1000.0, ideal / 1000.0, dctcp / 1000.0,
+                         static_cast<unsigned long long>(dctcpTimeouts));
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// LEDBAT: a background flow fills an idle link but yields to a foreground
+// CUBIC flow, and a late LEDBAT flow gets its fair share of the link.
+// ---------------------------------------------------------------------------
+
+static constexpr uint64_t LEDBAT_LINK_BPS = 4000000;
+static constexpr uint32_t LEDBAT_RTT_US = 20000;
+
+// Foreground 2MB CUBIC flow starting at 5s next to a long background flow.
+// Returns the foreground completion time, 0 when it does not finish by 10s
+static SimTime ForegroundFct(std::unique_ptr<CongestionControl> background, double& backgroundMbps) {
+    Simulator sim(std::make_unique<FixedRateLink>(LEDBAT_LINK_BPS), 100000);
+
+    SimFlowConfig back;
+    back.cc = std::move(background);
+    back.base_rtt_us = LEDBAT_RTT_US;
+    uint32_t backId = sim.AddFlow(std::move(back));
+
+    SimFlowConfig fore;
+    fore.cc = std::unique_ptr<CongestionControl>(new Cubic());
+    fore.base_rtt_us = LEDBAT_RTT_US;
+    fore.start_us = 5000000;
+    fore.size_bytes = 2000000;
+    uint32_t foreId = sim.AddFlow(std::move(fore));
+
+    sim.Run(5000000);
+    backgroundMbps = sim.GetFlowStats(backId).delivered_bytes * 8.0 / 5.0 / 1e6;
+    sim.Run(10000000);
+
+    const SimFlowStats& stats = sim.GetFlowStats(foreId);
+    return stats.finished ? stats.finish_us - stats.start_us : 0;
+}
+
+static bool CheckLedbatScavenger(std::string& detail) {
+    double ledbatAlone = 0;
+    double cubicAlone = 0;
+    SimTime withLedbat = ForegroundFct(std::unique_ptr<CongestionControl>(new Ledbat()), ledbatAlone);
+    SimTime withCubic = ForegroundFct(std::unique_ptr<CongestionControl>(new Cubic()), cubicAlone);
+
+    // Two LEDBAT flows, the second 5s late; measure from 20s to 30s
+    Simulator sim(std::make_unique<FixedRateLink>(LEDBAT_LINK_BPS), 100000);
+    uint32_t ids[2];
+    for (int i = 0; i < 2; i++) {
+        SimFlowConfig config;
+        config.cc = std::unique_ptr<CongestionControl>(new Ledbat());
+        config.base_rtt_us = LEDBAT_RTT_US;
+        config.start_us = i * 5000000;
+        ids[i] = sim.AddFlow(std::move(config));
+    }
+    sim.Run(20000000);
+    uint64_t start[2] = {sim.GetFlowStats(ids[0]).delivered_bytes, sim.GetFlowStats(ids[1]).delivered_bytes};
+    sim.Run(30000000);
+    double rate[2];
+    for (int i = 0; i < 2; i++) {
+        rate[i] = (sim.GetFlowStats(ids[i]).delivered_bytes - start[i]) * 8.0 / 10.0 / 1e6;
+    }
+    double jain = Jain(rate[0], rate[1]);
+
+    detail = Format("alone %.2f Mbps, 2MB cubic fct %.2f s next to ledbat (%s next to cubic), "
+                    "late flow %.2f / %.2f Mbps (jain %.3f)",
+                    ledbatAlone, withLedbat / 1e6,
+                    withCubic == 0 ? "unfinished" : Format("%.2f s", withCubic / 1e6).c_str(),
+                    rate[0], rate[1], jain);
+    return ledbatAlone >= 3.5 && withLedbat != 0 && withLedbat <= 6000000 && withCubic == 0 && jain >= 0.9;
+}
+
+// ---------------------------------------------------------------------------
+
+static const FeatureCheck CHECKS[] = {
+    {"stretch_ack_growth", CheckStretchAckGrowth},
+    {"paced_window_throughput", CheckPacedWindowThroughput},
+    {"send_quantum_bursts", CheckSendQuantumBursts},
+    {"bbr_ack_aggregation", CheckBbrAckAggregation},
+    {"bbr_policer_lt_bw", CheckBbrPolicerLtBw},
+    {"shared_min_rtt", CheckSharedMinRtt},
+    {"deterministic_runs", CheckDeterministicRuns},
+    {"rto_leaves_loss_state", CheckRtoLeavesLossState},
+    {"lazy_short_flows", CheckLazyShortFlows},
+    {"cold_flow_restart", CheckColdFlowRestart},
+    {"quic_ecn_counts", CheckQuicEcnCounts},
+    {"hpcc_convergence", CheckHpccConvergence},
+    {"timely_queue", CheckTimelyQueue},
+    {"receiver_driven_incast", CheckReceiverDrivenIncast},
+    {"ledbat_scavenger", CheckLedbatScavenger},
+};
+
+// Usage: feature_checks [name-prefix]
+int main(int argc, char** argv) {
+    const char* prefix = argc > 1 ? argv[1] : "";
+
+    int run = 0;
+    int failed = 0;
+    for (const FeatureCheck& check : CHECKS) {
+        if (std::strncmp(check.name, prefix, std::strlen(prefix)) != 0) {
+            continue;
+        }
+        std::string detail;
+        bool ok = check.run(detail);
+        std::printf("%-28s %s  %s\n", check.name, ok ? "PASS" : "FAIL", detail.c_str());
+        run++;
+        failed += ok ? 0 : 1;
+    }
+
+    std::printf("%d checks, %d failed\n", run, failed);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
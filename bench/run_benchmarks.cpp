@@ -0,0 +1,93 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 10:02:41
+@Description: Benchmark suite entry point
+@Language: C++17
+*/
+
+#include "benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [-o results.tsv] [-b baseline.tsv] [-t tolerance] [-s scenario] [-a algorithm]\n",
+                 program);
+}
+
+// Usage: run_benchmarks [-o results.tsv] [-b baseline.tsv] [-t tolerance] [-s scenario] [-a algorithm]
+int main(int argc, char** argv) {
+    std::string output = "bench_results.tsv";
+    std::string baselinePath;
+    double tolerance = 0.2;
+
+    BenchmarkRunner runner;
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag != "-o" && flag != "-b" && flag != "-t" && flag != "-s" && flag != "-a") {
+            std::fprintf(stderr, "unknown option %s\n", argv[i]);
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "option %s needs a value\n", argv[i]);
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        if (flag == "-o") {
+            output = argv[i + 1];
+        } else if (flag == "-b") {
+            baselinePath = argv[i + 1];
+        } else if (flag == "-t") {
+            char* end = nullptr;
+            tolerance = std::strtod(argv[i + 1], &end);
+            if (end == argv[i + 1] || *end != '\0' || tolerance < 0.0) {
+                std::fprintf(stderr, "invalid tolerance %s\n", argv[i + 1]);
+                PrintUsage(argv[0]);
+                return 2;
+            }
+        } else if (flag == "-s") {
+            runner.SetScenarioFilter(argv[i + 1]);
+        } else {
+            runner.SetAlgorithmFilter(argv[i + 1]);
+        }
+    }
+
+    for (auto& algorithm : BenchmarkRunner::DefaultAlgorithms()) {
+        runner.AddAlgorithm(std::move(algorithm));
+    }
+    for (auto& scenario : BenchmarkRunner::DefaultScenarios()) {
+        runner.AddScenario(std::move(scenario));
+    }
+
+    std::vector<BenchResult> results = runner.RunAll();
+
+    if (!baselinePath.empty()) {
+        std::vector<BenchResult> baseline;
+        if (!BenchmarkRunner::LoadResults(baselinePath, baseline)) {
+            std::fprintf(stderr, "cannot read baseline %s\n", baselinePath.c_str());
+            return 2;
+        }
+        BenchmarkRunner::CompareToBaseline(results, baseline, tolerance);
+    }
+
+    int failures = 0;
+    for (const auto& r : results) {
+        std::printf("%-16s %-6s %7.2f Mbps  util %.2f  p99 %7.2f ms  jain %.2f  %s %s\n",
+                    r.scenario.c_str(), r.algorithm.c_str(), r.throughput_mbps, r.utilization,
+                    r.delay_p99_ms, r.jain, r.pass ? "PASS" : "FAIL", r.reason.c_str());
+        if (!r.pass) {
+            failures++;
+        }
+    }
+
+    if (!BenchmarkRunner::WriteResults(output, results)) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 2;
+    }
+
+    std::printf("%zu runs, %d failed, results in %s\n", results.size(), failures, output.c_str());
+    return failures > 0 ? 1 : 0;
+}
@@ -6,6 +6,7 @@
 */
 
 #include "bic.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
@@ -25,9 +26,8 @@ BIC::BIC()
       m_lowWindow(14),              // Low window threshold
       m_smoothPart(0),              // Smooth increase counter
       m_foundNewMax(false),         // Haven't found new max yet
-      m_ackCount(0)                 // No ACKs counted yet
+      m_bytesAcked(0)               // Nothing ACKed yet
 {
-    m_epochStart = std::chrono::steady_clock::now();
 }
 
 // Copy constructor
@@ -45,8 +45,7 @@ BIC::BIC(const BIC& other)
       m_lowWindow(other.m_lowWindow),
       m_smoothPart(other.m_smoothPart),
       m_foundNewMax(other.m_foundNewMax),
-      m_ackCount(other.m_ackCount),
-      m_epochStart(other.m_epochStart)
+      m_bytesAcked(other.m_bytesAcked)
 {
 }
 
@@ -96,12 +95,20 @@ void BIC::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segments
     if (socket->tcp_state_ == TCPState::Recovery) {
         // Fast recovery
         m_cwnd = FastRecovery(socket, segmentsAcked);
-    } else if (m_cwnd < m_ssthresh) {
-        // Slow start phase
-        m_cwnd = SlowStart(socket, segmentsAcked);
     } else {
+        // Slow start phase; a stretch ACK crossing ssthresh carries
+        // its remaining segments into congestion avoidance
+        if (m_cwnd < m_ssthresh) {
+            uint32_t mss = socket->mss_bytes_;
+            uint32_t ssSegments = std::min(segmentsAcked, (m_ssthresh - m_cwnd + mss - 1) / mss);
+            m_cwnd = SlowStart(socket, ssSegments);
+            segmentsAcked -= ssSegments;
+        }
+
         // Congestion avoidance phase - use BIC algorithm
-        m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        if (segmentsAcked > 0 && m_cwnd >= m_ssthresh) {
+            m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        }
     }
 
     // Ensure we don't exceed maximum window
@@ -117,6 +124,7 @@ void BIC::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     
     // Basic RTT variance calculation (simplified)
     if (socket->rtt_var_ == 0) {
@@ -127,9 +135,6 @@ void BIC::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked
 
     // Update RTO (simplified: RTO = RTT + 4 * RTT_VAR)
     socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
-
-    // Count ACKs for BIC algorithm
-    m_ackCount += segmentsAcked;
 }
 
 // Set congestion state
@@ -154,6 +159,7 @@ void BIC::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
         return;
     }
 
+    CC_PROBE_CWND_EVENT(bic_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     switch (congestionEvent) {
@@ -182,8 +188,7 @@ void BIC::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
                 socket->tcp_state_ = TCPState::Recovery;
             }
             
-            m_epochStart = std::chrono::steady_clock::now();
-            m_ackCount = 0;
+            m_bytesAcked = 0;
             break;
 
         case CongestionEvent::ECN:
@@ -194,6 +199,7 @@ void BIC::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
             socket->tcp_state_ = TCPState::CWR;
             m_minWin = m_ssthresh;
             m_foundNewMax = false;
+            m_bytesAcked = 0;
             break;
 
         case CongestionEvent::FastRecovery:
@@ -233,8 +239,9 @@ uint32_t BIC::SlowStart(std::unique_ptr<SocketState>& socket, uint32_t segmentsA
         return m_cwnd;
     }
 
-    // Increase cwnd by segmentsAcked * MSS (exponential growth)
-    uint32_t newCwnd = m_cwnd + (segmentsAcked * socket->mss_bytes_);
+    // RFC 3465: grow by the bytes ACKed, at most L MSS per ACK (L = 1 after an RTO)
+    uint32_t limit = socket->tcp_state_ == TCPState::Loss ? 1 : ABC_LIMIT;
+    uint32_t newCwnd = m_cwnd + std::min(segmentsAcked, limit) * socket->mss_bytes_;
     
     // Don't exceed ssthresh in slow start
     if (newCwnd > m_ssthresh) {
@@ -251,7 +258,7 @@ uint32_t BIC::CongestionAvoidance(std::unique_ptr<SocketState>& socket, uint32_t
     }
 
     // Update BIC state and get new window size
-    BicUpdate(socket);
+    BicUpdate(socket, segmentsAcked);
 
     return m_cwnd;
 }
@@ -269,13 +276,13 @@ uint32_t BIC::FastRecovery(std::unique_ptr<SocketState>& socket, uint32_t segmen
 }
 
 // BIC-specific window update algorithm
-void BIC::BicUpdate(std::unique_ptr<SocketState>& socket) {
+void BIC::BicUpdate(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
     if (socket == nullptr) {
         return;
     }
 
     uint32_t mss = socket->mss_bytes_;
-    m_ackCount++;
+    uint32_t increment;             // Growth per RTT (bytes)
 
     // Calculate the target window size
     uint32_t targetWin = m_lastMaxCwnd;
@@ -285,17 +292,15 @@ void BIC::BicUpdate(std::unique_ptr<SocketState>& socket) {
         targetWin = m_cwnd + m_maxIncr * mss;
     }
 
-    // Calculate the distance to the target
-    int32_t dist = (targetWin - m_cwnd) / mss;
+    // Calculate the distance to the target (negative once past it)
+    int32_t dist = (static_cast<int32_t>(targetWin) - static_cast<int32_t>(m_cwnd)) / static_cast<int32_t>(mss);
 
     if (dist > static_cast<int32_t>(m_maxIncr)) {
         // We're far from target: additive increase with Smax
-        m_cwnd += m_maxIncr * mss;
+        increment = m_maxIncr * mss;
     } else if (dist > 0) {
         // Binary search increase
         // Use binary search to find the optimal window
-        uint32_t increment;
-        
         if (dist > static_cast<int32_t>(m_minIncr)) {
             // Binary search phase
             increment = (dist / 2) * mss;
@@ -306,8 +311,6 @@ void BIC::BicUpdate(std::unique_ptr<SocketState>& socket) {
             // Linear increase near target
             increment = m_minIncr * mss;
         }
-        
-        m_cwnd += increment;
     } else {
         // We've reached or passed the target
         if (!m_foundNewMax) {
@@ -318,13 +321,23 @@ void BIC::BicUpdate(std::unique_ptr<SocketState>& socket) {
         
         // Slow increase beyond previous max
         if (m_cwnd < m_lastMaxCwnd + m_maxIncr * mss) {
-            m_cwnd += m_minIncr * mss;
+            increment = m_minIncr * mss;
         } else {
-            m_cwnd += m_maxIncr * mss;
+            increment = m_maxIncr * mss;
             m_lastMaxCwnd = m_cwnd;
         }
     }
 
+    // Spread the per-RTT increment over a window of ACKed bytes (RFC 3465
+    // style), so growth does not depend on how segments were grouped into ACKs
+    uint32_t bytesPerMss = static_cast<uint32_t>(std::max<uint64_t>(static_cast<uint64_t>(m_cwnd) * mss / increment, 1));
+    m_bytesAcked += segmentsAcked * mss;
+    if (m_bytesAcked >= bytesPerMss) {
+        uint32_t delta = m_bytesAcked / bytesPerMss;
+        m_bytesAcked -= delta * bytesPerMss;
+        m_cwnd += delta * mss;
+    }
+
     // Ensure minimum window size
     if (m_cwnd < m_minWin) {
         m_cwnd = m_minWin;
@@ -337,8 +350,6 @@ void BIC::BicReset() {
     m_lastCwnd = 0;
     m_minWin = 0;
     m_foundNewMax = false;
-    m_ackCount = 0;
+    m_bytesAcked = 0;
     m_smoothPart = 0;
-    m_epochStart = std::chrono::steady_clock::now();
 }
-
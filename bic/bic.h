@@ -46,7 +46,7 @@ protected:
     virtual uint32_t FastRecovery(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked);
 
     // BIC-specific window update
-    virtual void BicUpdate(std::unique_ptr<SocketState>& socket);
+    virtual void BicUpdate(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked);
 
     // Reset BIC state
     virtual void BicReset();
@@ -71,8 +71,7 @@ private:
     
     // State tracking
     bool m_foundNewMax;            // Whether we found a new max window
-    uint32_t m_ackCount;           // Count of ACKs in current RTT
-    std::chrono::steady_clock::time_point m_epochStart;  // Start of current epoch
+    uint32_t m_bytesAcked;         // RFC 3465 bytes_acked: bytes ACKed towards the next 1 MSS increase
 };
 
 #endif // BIC_H
@@ -6,13 +6,14 @@
 */
 
 #include "copa.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
 
 // Default constructor
 Copa::Copa() 
-    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::RENO), "Copa"),
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::COPA), "Copa"),
       m_ssthresh(0x7fffffff),      // Initially very large
       m_cwnd(0),                    // Will be set based on MSS
       m_maxCwnd(65535),             // Default max window
@@ -38,7 +39,7 @@ Copa::Copa()
 
 // Copy constructor
 Copa::Copa(const Copa& other) 
-    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::RENO), "Copa"),
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::COPA), "Copa"),
       m_ssthresh(other.m_ssthresh),
       m_cwnd(other.m_cwnd),
       m_maxCwnd(other.m_maxCwnd),
@@ -71,7 +72,7 @@ Copa::~Copa() {
 
 // Get type ID
 TypeId Copa::GetTypeId() {
-    return static_cast<TypeId>(CongestionAlgorithm::RENO);  // Using RENO as placeholder
+    return static_cast<TypeId>(CongestionAlgorithm::COPA);
 }
 
 // Get algorithm name
@@ -133,6 +134,7 @@ void Copa::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcke
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     
     // Update RTT variance
     if (socket->rtt_var_ == 0) {
@@ -172,6 +174,7 @@ void Copa::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
         return;
     }
 
+    CC_PROBE_CWND_EVENT(copa_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     switch (congestionEvent) {
@@ -233,6 +236,43 @@ void Copa::CongControl(std::unique_ptr<SocketState>& socket,
     }
 }
 
+// Get pacing rate
+uint64_t Copa::GetPacingRate() const {
+    return m_targetRate;
+}
+
+// Get send quantum
+uint32_t Copa::GetSendQuantum(const std::unique_ptr<SocketState>& socket) const {
+    if (socket == nullptr) {
+        return 0;
+    }
+    if (m_targetRate == 0) {
+        return CongestionControl::GetSendQuantum(socket);
+    }
+    return SendQuantumForRate(m_targetRate, socket->mss_bytes_);
+}
+
+// Get decision
+CcDecision Copa::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    CcDecision decision = CongestionControl::GetDecision(socket);
+    decision.mode = static_cast<uint8_t>(static_cast<int>(m_mode) + 1);
+    if (socket == nullptr) {
+        return decision;
+    }
+    if (m_targetRate != 0) {
+        decision.pacing_rate = m_targetRate;
+    }
+
+    uint32_t minRtt = m_minRTT != 0xFFFFFFFF ? m_minRTT : socket->rtt_us_;
+    FillAckFrequency(decision, socket->mss_bytes_, minRtt, m_mode == CopaMode::SLOW_START);
+    return decision;
+}
+
+// Get current mode
+CopaMode Copa::GetMode() const {
+    return m_mode;
+}
+
 // Enter slow start mode
 void Copa::EnterSlowStart() {
     m_mode = CopaMode::SLOW_START;
@@ -246,6 +286,8 @@ void Copa::EnterCompetitiveMode() {
     m_mode = CopaMode::COMPETITIVE;
     m_inSlowStart = false;
     m_velocity = 0.0;
+
+    CC_PROBE5(copa_enter_competitive, static_cast<void*>(this), m_cwnd, m_minRTT, m_standingRTT, CC_PROBE_FIXED(m_delta));
 }
 
 // Enter velocity mode
@@ -254,18 +296,22 @@ void Copa::EnterVelocityMode() {
     m_inSlowStart = false;
     m_velocity = 0.0;
     m_prevQueueingDelay = GetQueueingDelay();
+
+    CC_PROBE5(copa_enter_velocity, static_cast<void*>(this), m_cwnd, m_minRTT, m_standingRTT, CC_PROBE_FIXED(m_delta));
 }
 
 // Copa main update logic
 void Copa::CopaUpdate(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes, uint64_t rtt) {
+    uint64_t now = socket->NowUs();
+
     // Update RTT measurements
-    UpdateRTT(rtt);
+    UpdateRTT(rtt, now);
     
     // Clean up old samples
-    CleanupOldRTTSamples();
+    CleanupOldRTTSamples(now);
     
     // Check for mode transitions
-    CheckModeTransition();
+    CheckModeTransition(now);
     
     if (m_mode == CopaMode::VELOCITY || m_mode == CopaMode::COMPETITIVE) {
         // Calculate velocity based on queueing delay
@@ -277,7 +323,7 @@ void Copa::CopaUpdate(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes,
 }
 
 // Update RTT measurements
-void Copa::UpdateRTT(uint64_t rtt) {
+void Copa::UpdateRTT(uint64_t rtt, uint64_t nowUs) {
     if (rtt == 0) {
         return;
     }
@@ -285,7 +331,7 @@ void Copa::UpdateRTT(uint64_t rtt) {
     uint32_t rtt_us = static_cast<uint32_t>(rtt);
     
     // Add new sample
-    m_rttSamples.push_back(CopaRTTMeasurement(rtt_us));
+    m_rttSamples.push_back(CopaRTTMeasurement(rtt_us, nowUs));
     
     // Keep only recent samples
     while (m_rttSamples.size() > RTT_SAMPLE_WINDOW) {
@@ -295,7 +341,7 @@ void Copa::UpdateRTT(uint64_t rtt) {
     // Update min RTT if this is smaller
     if (rtt_us < m_minRTT) {
         m_minRTT = rtt_us;
-        m_minRTTTimestamp = std::chrono::steady_clock::now();
+        m_minRTTTimestamp = nowUs;
     }
     
     // Update standing RTT (recent average)
@@ -425,13 +471,11 @@ bool Copa::ShouldExitSlowStart() {
 }
 
 // Check for mode transitions
-void Copa::CheckModeTransition() {
+void Copa::CheckModeTransition(uint64_t nowUs) {
     // Check if min RTT measurement is stale
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        now - m_minRTTTimestamp);
+    uint64_t elapsedUs = nowUs - m_minRTTTimestamp;
     
-    if (elapsed.count() >= MIN_RTT_WINDOW_SEC) {
+    if (elapsedUs >= MIN_RTT_WINDOW_SEC * 1000000ull) {
         // Min RTT is stale, need to re-measure
         // Could transition to a probe mode here
     }
@@ -443,14 +487,11 @@ void Copa::CheckModeTransition() {
 }
 
 // Clean up old RTT samples
-void Copa::CleanupOldRTTSamples() {
-    auto now = std::chrono::steady_clock::now();
-    
+void Copa::CleanupOldRTTSamples(uint64_t nowUs) {
     // Remove samples older than 10 seconds
     while (!m_rttSamples.empty()) {
-        auto age = std::chrono::duration_cast<std::chrono::seconds>(
-            now - m_rttSamples.front().timestamp);
-        if (age.count() > 10) {
+        uint64_t ageUs = nowUs - m_rttSamples.front().timestamp_us;
+        if (ageUs > 10000000) {
             m_rttSamples.pop_front();
         } else {
             break;
@@ -460,7 +501,8 @@ void Copa::CleanupOldRTTSamples() {
 
 // Initialize parameters
 void Copa::InitializeParameters() {
-    m_minRTTTimestamp = std::chrono::steady_clock::now();
-    m_rttStart = std::chrono::steady_clock::now();
+    // Timestamps come from the first ACK
+    m_minRTTTimestamp = 0;
+    m_rttStart = 0;
 }
 
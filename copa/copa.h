@@ -25,10 +25,10 @@ enum class CopaMode {
 // RTT measurement structure
 struct CopaRTTMeasurement {
     uint32_t rtt_us;                                      // RTT in microseconds
-    std::chrono::steady_clock::time_point timestamp;      // When measured
+    uint64_t timestamp_us;                                // When measured
     
-    CopaRTTMeasurement(uint32_t rtt = 0) 
-        : rtt_us(rtt), timestamp(std::chrono::steady_clock::now()) {}
+    CopaRTTMeasurement(uint32_t rtt = 0, uint64_t timestamp = 0) 
+        : rtt_us(rtt), timestamp_us(timestamp) {}
 };
 
 class Copa: public CongestionControl {
@@ -55,6 +55,18 @@ public:
 
     void CongControl(std::unique_ptr<SocketState>& socket, const CongestionEvent& congestionEvent, const RTTSample& rtt) override;
 
+    // Send quantum from the target rate
+    uint32_t GetSendQuantum(const std::unique_ptr<SocketState>& socket) const override;
+
+    // Decision with the target rate as pacing rate
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    // Current target rate (bytes/sec), used as the pacing rate
+    uint64_t GetPacingRate() const;
+
+    // Current operating mode
+    CopaMode GetMode() const;
+
 protected:
     // Copa state machine
     virtual void EnterSlowStart();
@@ -65,7 +77,7 @@ protected:
     virtual void CopaUpdate(std::unique_ptr<SocketState>& socket, uint32_t ackedBytes, uint64_t rtt);
     
     // RTT tracking
-    virtual void UpdateRTT(uint64_t rtt);
+    virtual void UpdateRTT(uint64_t rtt, uint64_t nowUs);
     virtual uint32_t GetMinRTT() const;
     virtual uint32_t GetStandingQueueDelay() const;
     
@@ -76,7 +88,7 @@ protected:
     
     // Mode transitions
     virtual bool ShouldExitSlowStart();
-    virtual void CheckModeTransition();
+    virtual void CheckModeTransition(uint64_t nowUs);
 
 private:
     // Standard TCP parameters
@@ -91,7 +103,7 @@ private:
     std::deque<CopaRTTMeasurement> m_rttSamples;  // Recent RTT samples
     uint32_t m_minRTT;             // Minimum RTT observed (base RTT, microseconds)
     uint32_t m_standingRTT;        // Standing RTT (with queueing delay)
-    std::chrono::steady_clock::time_point m_minRTTTimestamp;  // When minRTT was updated
+    uint64_t m_minRTTTimestamp;    // When minRTT was updated (microseconds)
     
     // Copa parameters
     double m_delta;                // Target queueing delay (in RTTs), typically 0.5
@@ -105,7 +117,7 @@ private:
     // Rate tracking
     uint64_t m_lastRateUpdate;     // Last time rate was updated (microseconds)
     uint32_t m_deliveredBytes;     // Bytes delivered in current RTT
-    std::chrono::steady_clock::time_point m_rttStart;  // Start of current RTT
+    uint64_t m_rttStart;           // Start of current RTT (microseconds)
     
     // Slow start parameters
     uint32_t m_ssExitThreshold;    // Exit slow start if queueing delay exceeds this
@@ -127,7 +139,7 @@ private:
     static constexpr uint32_t SS_EXIT_THRESHOLD_US = 1000;// 1ms queueing delay to exit SS
     
     // Helper methods
-    void CleanupOldRTTSamples();
+    void CleanupOldRTTSamples(uint64_t nowUs);
     void InitializeParameters();
     double GetQueueingDelay() const;  // Current queueing delay in RTTs
 };
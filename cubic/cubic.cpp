@@ -6,6 +6,7 @@
 */
 
 #include "cubic.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
@@ -24,6 +25,7 @@ Cubic::Cubic()
       m_fastConvergence(true),      // Fast convergence enabled
       m_tcpFriendly(true),          // TCP-friendly mode enabled
       m_tcpCwnd(0),                 // TCP Reno estimate
+      m_epochStartUs(0),            // Epoch starts on the first update
       m_lastTime(0.0),              // No time elapsed yet
       m_ackCount(0),                // No ACKs counted yet
       m_cntRtt(0),                  // RTT counter
@@ -33,7 +35,6 @@ Cubic::Cubic()
       m_hystartDelayMin(0xFFFFFFFF),// Minimum delay in round
       m_hystartDelayMax(0)          // Maximum delay in round
 {
-    m_epochStart = std::chrono::steady_clock::now();
 }
 
 // Copy constructor
@@ -50,7 +51,7 @@ Cubic::Cubic(const Cubic& other)
       m_fastConvergence(other.m_fastConvergence),
       m_tcpFriendly(other.m_tcpFriendly),
       m_tcpCwnd(other.m_tcpCwnd),
-      m_epochStart(other.m_epochStart),
+      m_epochStartUs(other.m_epochStartUs),
       m_lastTime(other.m_lastTime),
       m_ackCount(other.m_ackCount),
       m_cntRtt(other.m_cntRtt),
@@ -120,12 +121,20 @@ void Cubic::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmen
     if (socket->tcp_state_ == TCPState::Recovery) {
         // Fast recovery
         m_cwnd = FastRecovery(socket, segmentsAcked);
-    } else if (m_cwnd < m_ssthresh) {
-        // Slow start phase
-        m_cwnd = SlowStart(socket, segmentsAcked);
     } else {
+        // Slow start phase; a stretch ACK crossing ssthresh carries
+        // its remaining segments into congestion avoidance
+        if (m_cwnd < m_ssthresh) {
+            uint32_t mss = socket->mss_bytes_;
+            uint32_t ssSegments = std::min(segmentsAcked, (m_ssthresh - m_cwnd + mss - 1) / mss);
+            m_cwnd = SlowStart(socket, ssSegments);
+            segmentsAcked -= ssSegments;
+        }
+
         // Congestion avoidance phase - use CUBIC algorithm
-        m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        if (segmentsAcked > 0 && m_cwnd >= m_ssthresh) {
+            m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        }
     }
 
     // Ensure we don't exceed maximum window
@@ -141,6 +150,7 @@ void Cubic::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     
     // Basic RTT variance calculation (simplified)
     if (socket->rtt_var_ == 0) {
@@ -174,8 +184,7 @@ void Cubic::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
         }
     }
 
-    // Count ACKs for CUBIC algorithm
-    m_ackCount += segmentsAcked;
+    // ACKed segments are counted by CubicUpdate, in congestion avoidance only
     m_cntRtt++;
 }
 
@@ -199,6 +208,7 @@ void Cubic::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEven
         return;
     }
 
+    CC_PROBE_CWND_EVENT(cubic_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     switch (congestionEvent) {
@@ -221,7 +231,7 @@ void Cubic::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEven
             }
             
             // Reset epoch
-            m_epochStart = std::chrono::steady_clock::now();
+            m_epochStartUs = socket->NowUs();
             m_lastTime = 0.0;
             m_ackCount = 0;
             m_tcpCwnd = 0;
@@ -237,7 +247,7 @@ void Cubic::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEven
             m_cwnd = m_ssthresh;
             socket->cwnd_ = m_cwnd;
             socket->tcp_state_ = TCPState::CWR;
-            m_epochStart = std::chrono::steady_clock::now();
+            m_epochStartUs = socket->NowUs();
             m_lastTime = 0.0;
             break;
 
@@ -299,7 +309,7 @@ uint32_t Cubic::CongestionAvoidance(std::unique_ptr<SocketState>& socket, uint32
     }
 
     // Update CUBIC state and get new window size
-    CubicUpdate(socket);
+    CubicUpdate(socket, segmentsAcked);
 
     return m_cwnd;
 }
@@ -317,17 +327,19 @@ uint32_t Cubic::FastRecovery(std::unique_ptr<SocketState>& socket, uint32_t segm
 }
 
 // CUBIC-specific window update algorithm
-void Cubic::CubicUpdate(std::unique_ptr<SocketState>& socket) {
+void Cubic::CubicUpdate(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
     if (socket == nullptr) {
         return;
     }
 
-    m_ackCount++;
+    m_ackCount += segmentsAcked;
     
     // Calculate elapsed time since epoch start
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_epochStart);
-    double t = elapsed.count() / 1000.0;  // Convert to seconds
+    uint64_t now = socket->NowUs();
+    if (m_epochStartUs == 0) {
+        m_epochStartUs = now;
+    }
+    double t = (now - m_epochStartUs) / 1000000.0;  // Convert to seconds
     
     // Calculate target cwnd using CUBIC function
     uint32_t cubicTarget = CubicWindowCalculation(t);
@@ -355,28 +367,24 @@ void Cubic::CubicUpdate(std::unique_ptr<SocketState>& socket) {
         }
     }
     
-    // Calculate the increment
+    // ACKed segments per 1 MSS increase
+    uint32_t mss = socket->mss_bytes_;
+    uint32_t cnt;
     if (cubicTarget > m_cwnd) {
-        // Calculate how many segments to add
-        uint32_t delta = cubicTarget - m_cwnd;
-        uint32_t mss = socket->mss_bytes_;
-        uint32_t cnt = m_cwnd / delta;
-        
-        if (cnt == 0) {
-            cnt = 1;
-        }
-        
-        // Increase cwnd
-        if (m_ackCount >= cnt) {
-            m_cwnd += mss;
-            m_ackCount = 0;
-        }
+        cnt = m_cwnd / (cubicTarget - m_cwnd);
     } else {
-        // We're above the target, slow increase
-        if (m_ackCount >= m_cwnd / socket->mss_bytes_) {
-            m_cwnd += socket->mss_bytes_;
-            m_ackCount = 0;
-        }
+        // We're above the target, slow increase: 1 MSS per window
+        cnt = m_cwnd / mss;
+    }
+
+    // At most 1 MSS per 2 segments ACKed (1.5x per RTT), as Linux does
+    cnt = std::max<uint32_t>(cnt, 2);
+
+    // One MSS per cnt segments, however they were grouped into ACKs (tcp_cong_avoid_ai)
+    if (m_ackCount >= cnt) {
+        uint32_t delta = m_ackCount / cnt;
+        m_ackCount -= delta * cnt;
+        m_cwnd += delta * mss;
     }
     
     m_lastTime = t;
@@ -421,6 +429,8 @@ void Cubic::CalculateK() {
 
 // Reset CUBIC state
 void Cubic::CubicReset() {
+    CC_PROBE4(cubic_reset, static_cast<void*>(this), m_cwnd, m_lastMaxCwnd, m_ssthresh);
+
     m_lastMaxCwnd = 0;
     m_lastCwnd = 0;
     m_k = 0.0;
@@ -431,6 +441,6 @@ void Cubic::CubicReset() {
     m_delayMin = 0xFFFFFFFF;
     m_hystartDelayMin = 0xFFFFFFFF;
     m_hystartDelayMax = 0;
-    m_epochStart = std::chrono::steady_clock::now();
+    m_epochStartUs = 0;
 }
 
@@ -45,8 +45,8 @@ protected:
 
     virtual uint32_t FastRecovery(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked);
 
-    // CUBIC-specific window update
-    virtual void CubicUpdate(std::unique_ptr<SocketState>& socket);
+    // CUBIC-specific window update for segmentsAcked newly ACKed segments
+    virtual void CubicUpdate(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked);
 
     // Calculate CUBIC window based on time
     virtual uint32_t CubicWindowCalculation(double elapsedTime);
@@ -78,11 +78,11 @@ private:
     uint32_t m_tcpCwnd;            // Estimated TCP Reno cwnd
     
     // Time tracking
-    std::chrono::steady_clock::time_point m_epochStart;  // Start of current epoch
+    uint64_t m_epochStartUs;       // Start of current epoch (microseconds), 0 = next update
     double m_lastTime;             // Last update time since epoch start
     
     // ACK counting
-    uint32_t m_ackCount;           // Count of ACKs in current RTT
+    uint32_t m_ackCount;           // Segments ACKed towards the next 1 MSS increase
     uint32_t m_cntRtt;             // RTT counter for updates
     
     // Delay tracking
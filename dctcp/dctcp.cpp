@@ -6,6 +6,7 @@
 */
 
 #include "dctcp.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
@@ -25,6 +26,7 @@ DCTCP::DCTCP()
       m_priorRcvNxt(0),             // No prior sequence
       m_priorRcvNxtFlag(0),         // No flag
       m_nextSeq(0),                 // Start sequence
+      m_bytesAcked(0),              // Nothing ACKed in congestion avoidance yet
       m_initialized(false),         // Not initialized
       m_ecnEchoSeq(0)               // No ECN echo
 {
@@ -46,6 +48,7 @@ DCTCP::DCTCP(const DCTCP& other)
       m_priorRcvNxt(other.m_priorRcvNxt),
       m_priorRcvNxtFlag(other.m_priorRcvNxtFlag),
       m_nextSeq(other.m_nextSeq),
+      m_bytesAcked(other.m_bytesAcked),
       m_initialized(other.m_initialized),
       m_ecnEchoSeq(other.m_ecnEchoSeq)
 {
@@ -97,12 +100,20 @@ void DCTCP::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmen
     if (socket->tcp_state_ == TCPState::Recovery) {
         // Fast recovery
         m_cwnd = FastRecovery(socket, segmentsAcked);
-    } else if (InSlowStart()) {
-        // Slow start phase - use standard TCP behavior
-        m_cwnd = SlowStart(socket, segmentsAcked);
     } else {
-        // Congestion avoidance phase - use DCTCP behavior
-        m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        // Slow start phase; a stretch ACK crossing ssthresh carries
+        // its remaining segments into congestion avoidance
+        if (InSlowStart()) {
+            uint32_t mss = socket->mss_bytes_;
+            uint32_t ssSegments = std::min(segmentsAcked, (m_ssthresh - m_cwnd + mss - 1) / mss);
+            m_cwnd = SlowStart(socket, ssSegments);
+            segmentsAcked -= ssSegments;
+        }
+
+        // Congestion avoidance phase
+        if (segmentsAcked > 0 && !InSlowStart()) {
+            m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        }
     }
 
     // Ensure we don't exceed maximum window
@@ -118,6 +129,7 @@ void DCTCP::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     
     // Basic RTT variance calculation
     if (socket->rtt_var_ == 0) {
@@ -133,13 +145,8 @@ void DCTCP::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
     uint32_t ackedBytes = segmentsAcked * socket->mss_bytes_;
     m_ackedBytesTotal += ackedBytes;
     
-    // Process ECN marking (simulated - in real implementation would come from packet)
-    // Here we assume ECN info is available through some mechanism
-    bool ecnMarked = false;  // Would be extracted from actual packet in real implementation
-    
-    if (ecnMarked) {
-        m_ackedBytesEcn += ackedBytes;
-    }
+    // Bytes of this ACK that were CE marked, as counted by the caller (RFC 8257 3.3)
+    m_ackedBytesEcn += std::min(socket->ecn_ce_segments_, segmentsAcked) * socket->mss_bytes_;
     
     // Check if we've completed a window and should update alpha
     // This happens approximately once per RTT
@@ -157,9 +164,9 @@ void DCTCP::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPSt
 
     socket->tcp_state_ = congestionState;
 
-    // When entering recovery or loss, adjust parameters
+    // Loss is not an ECN signal: the α-scaled cut only applies to marks
     if (congestionState == TCPState::Recovery || congestionState == TCPState::Loss) {
-        GetSsThresh(socket, 0);
+        ReactToLoss(socket);
     }
 }
 
@@ -169,15 +176,17 @@ void DCTCP::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEven
         return;
     }
 
+    CC_PROBE_CWND_EVENT(dctcp_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     switch (congestionEvent) {
         case CongestionEvent::PacketLoss:
-            // Packet loss: use DCTCP reduction
-            GetSsThresh(socket, 0);
+            // Packet loss: halve like Reno (Linux dctcp_react_to_loss)
+            ReactToLoss(socket);
             m_cwnd = m_ssthresh;
             socket->cwnd_ = m_cwnd;
             socket->tcp_state_ = TCPState::Recovery;
+            m_bytesAcked = 0;
             break;
 
         case CongestionEvent::Timeout:
@@ -191,18 +200,17 @@ void DCTCP::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEven
             // Reset alpha to conservative value
             m_alpha = 1.0;
             ResetECNCounters();
+            m_bytesAcked = 0;
             break;
 
         case CongestionEvent::ECN:
-            // ECN: DCTCP's primary congestion signal
+            // ECN: DCTCP's primary congestion signal. A mark in slow
+            // start ends it too (Linux tcp_enter_cwr)
             ProcessECN(true);
-            
-            // Only reduce cwnd if not in slow start
-            if (!InSlowStart()) {
-                GetSsThresh(socket, 0);
-                m_cwnd = m_ssthresh;
-                socket->cwnd_ = m_cwnd;
-            }
+            GetSsThresh(socket, 0);
+            m_cwnd = m_ssthresh;
+            socket->cwnd_ = m_cwnd;
+            m_bytesAcked = 0;
             socket->tcp_state_ = TCPState::CWR;
             break;
 
@@ -243,8 +251,9 @@ uint32_t DCTCP::SlowStart(std::unique_ptr<SocketState>& socket, uint32_t segment
         return m_cwnd;
     }
 
-    // Increase cwnd by segmentsAcked * MSS (exponential growth)
-    uint32_t newCwnd = m_cwnd + (segmentsAcked * socket->mss_bytes_);
+    // RFC 3465: grow by the bytes ACKed, at most L MSS per ACK (L = 1 after an RTO)
+    uint32_t limit = socket->tcp_state_ == TCPState::Loss ? 1 : ABC_LIMIT;
+    uint32_t newCwnd = m_cwnd + std::min(segmentsAcked, limit) * socket->mss_bytes_;
     
     // Don't exceed ssthresh in slow start
     if (newCwnd > m_ssthresh) {
@@ -260,16 +269,14 @@ uint32_t DCTCP::CongestionAvoidance(std::unique_ptr<SocketState>& socket, uint32
         return m_cwnd;
     }
 
-    // Increase cwnd by approximately MSS per RTT
-    // Formula: cwnd += MSS * MSS / cwnd (for each ACK)
-    uint32_t mss = socket->mss_bytes_;
-    uint32_t increment = (segmentsAcked * mss * mss) / m_cwnd;
-    
-    if (increment == 0 && segmentsAcked > 0) {
-        increment = 1;  // Ensure at least some progress
+    // RFC 3465: one MSS for every cwnd worth of bytes ACKed, whatever
+    // the ACK pattern; a stretch ACK may cover more than one window
+    uint32_t newCwnd = m_cwnd;
+    m_bytesAcked += segmentsAcked * socket->mss_bytes_;
+    while (m_bytesAcked >= newCwnd && newCwnd > 0) {
+        m_bytesAcked -= newCwnd;
+        newCwnd += socket->mss_bytes_;
     }
-
-    uint32_t newCwnd = m_cwnd + increment;
     return std::min(newCwnd, m_maxCwnd);
 }
 
@@ -300,6 +307,9 @@ void DCTCP::UpdateAlpha() {
     
     // Clamp alpha to valid range [0, 1]
     m_alpha = std::max(0.0, std::min(DCTCP_MAX_ALPHA, m_alpha));
+
+    CC_PROBE5(dctcp_update_alpha, static_cast<void*>(this), CC_PROBE_FIXED(F), CC_PROBE_FIXED(m_alpha),
+              m_ackedBytesEcn, m_ackedBytesTotal);
 }
 
 // Process ECN feedback
@@ -322,7 +332,7 @@ uint32_t DCTCP::CalculateNewCwnd() {
     uint32_t newCwnd = static_cast<uint32_t>(m_cwnd * reduction_factor);
     
     // Ensure minimum window size
-    newCwnd = std::max(newCwnd, 2 * 1460);  // At least 2 MSS
+    newCwnd = std::max<uint32_t>(newCwnd, 2 * 1460);  // At least 2 MSS
     
     return newCwnd;
 }
@@ -350,3 +360,9 @@ bool DCTCP::InSlowStart() const {
     return m_cwnd < m_ssthresh;
 }
 
+// Loss response: ssthresh = cwnd / 2 (Linux dctcp_react_to_loss). α only
+// measures marking; on a path that drops instead of marking it decays to 0
+void DCTCP::ReactToLoss(std::unique_ptr<SocketState>& socket) {
+    m_ssthresh = std::max(socket->cwnd_ / 2, 2 * socket->mss_bytes_);
+    socket->ssthresh_ = m_ssthresh;
+}
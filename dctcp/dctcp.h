@@ -71,6 +71,7 @@ private:
     uint64_t m_priorRcvNxt;        // Sequence number at start of window
     uint64_t m_priorRcvNxtFlag;    // Flag to indicate start of new window
     uint32_t m_nextSeq;            // Next expected sequence number
+    uint32_t m_bytesAcked;         // RFC 3465 bytes_acked: bytes ACKed towards the next 1 MSS increase
     bool m_initialized;            // Whether DCTCP is initialized
     
     // Statistics
@@ -84,6 +85,7 @@ private:
     // Helper methods
     void InitializeDCTCP();
     bool InSlowStart() const;
+    void ReactToLoss(std::unique_ptr<SocketState>& socket);  // Halve ssthresh like Reno
 };
 
 #endif // DCTCP_H
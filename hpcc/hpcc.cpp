@@ -0,0 +1,368 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 23:05:42
+@Description: HPCC (High Precision Congestion Control) Algorithm Implementation
+@Language: C++17
+*/
+
+#include "hpcc.h"
+#include "../utils/probes.h"
+#include <algorithm>
+#include <cstdint>
+
+// Default constructor
+HPCC::HPCC()
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::HPCC), "HPCC"),
+      m_cwnd(0),                    // Will be set from the socket
+      m_maxCwnd(65535),             // Default max window
+      m_window(0.0),                // Seeded from the socket
+      m_referenceWindow(0.0),
+      m_utilization(0.0),           // Idle path until INT says otherwise
+      m_incStage(0),
+      m_initialized(false),
+      m_lastHopCount(0),            // No INT record yet
+      m_lineRateWindow(0),
+      m_bytesAcked(0),
+      m_roundEndBytes(0),           // First update moves Wc
+      m_baseRtt(0),                 // Learn T
+      m_minRTT(0xFFFFFFFF),         // Maximum initial value
+      m_minRTTTimestamp(0),
+      m_additiveIncrease(0)         // W_init x (1 - eta) / N
+{
+}
+
+// Copy constructor
+HPCC::HPCC(const HPCC& other)
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::HPCC), "HPCC"),
+      m_cwnd(other.m_cwnd),
+      m_maxCwnd(other.m_maxCwnd),
+      m_window(other.m_window),
+      m_referenceWindow(other.m_referenceWindow),
+      m_utilization(other.m_utilization),
+      m_incStage(other.m_incStage),
+      m_initialized(other.m_initialized),
+      m_lastHopCount(other.m_lastHopCount),
+      m_lineRateWindow(other.m_lineRateWindow),
+      m_bytesAcked(other.m_bytesAcked),
+      m_roundEndBytes(other.m_roundEndBytes),
+      m_baseRtt(other.m_baseRtt),
+      m_minRTT(other.m_minRTT),
+      m_minRTTTimestamp(other.m_minRTTTimestamp),
+      m_additiveIncrease(other.m_additiveIncrease)
+{
+    std::copy(other.m_lastHops, other.m_lastHops + AckMetadata::MAX_INT_HOPS, m_lastHops);
+}
+
+// Destructor
+HPCC::~HPCC() {
+    // No dynamic memory to clean up
+}
+
+// Get type ID
+TypeId HPCC::GetTypeId() {
+    return static_cast<TypeId>(CongestionAlgorithm::HPCC);
+}
+
+// Get algorithm name
+std::string HPCC::GetAlgorithmName() {
+    return "HPCC";
+}
+
+// HPCC has no slow start threshold
+uint32_t HPCC::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    return 0x7fffffff;
+}
+
+// The window follows INT, not ACK counting
+void HPCC::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+}
+
+// Count acknowledged bytes and track the RTT
+void HPCC::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+    if (socket == nullptr || segmentsAcked == 0) {
+        return;
+    }
+
+    // Update RTT information
+    socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
+
+    // Update RTT variance
+    if (socket->rtt_var_ == 0) {
+        socket->rtt_var_ = rtt / 2;
+    } else {
+        socket->rtt_var_ = (3 * socket->rtt_var_ + rtt) / 4;
+    }
+    socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
+
+    m_bytesAcked += static_cast<uint64_t>(segmentsAcked) * socket->mss_bytes_;
+
+    uint64_t now = socket->now_us_ != 0 ? socket->now_us_ : m_minRTTTimestamp;
+    UpdateRTT(static_cast<uint32_t>(rtt), now);
+}
+
+// Set congestion state
+void HPCC::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    socket->tcp_state_ = congestionState;
+}
+
+// Handle congestion window events
+void HPCC::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    CC_PROBE_CWND_EVENT(hpcc_cwnd_event, socket, congestionEvent);
+    socket->congestion_event_ = congestionEvent;
+
+    switch (congestionEvent) {
+        case CongestionEvent::PacketLoss:
+            // Loss is not a congestion signal on a lossless fabric; INT already saw the queue
+            break;
+
+        case CongestionEvent::Timeout:
+            // Start over from one packet; INT brings the window back within a few RTTs
+            m_referenceWindow = socket->mss_bytes_;
+            m_window = m_referenceWindow;
+            m_incStage = 0;
+            m_roundEndBytes = m_bytesAcked;
+            ApplyCwnd(socket);
+            socket->tcp_state_ = TCPState::Loss;
+            break;
+
+        case CongestionEvent::ECN:
+            // HPCC replaces ECN with INT
+            break;
+
+        case CongestionEvent::FastRecovery:
+            socket->tcp_state_ = TCPState::Recovery;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Check if congestion control is enabled
+bool HPCC::HasCongControl() const {
+    return true;
+}
+
+// Main congestion control logic
+void HPCC::CongControl(std::unique_ptr<SocketState>& socket,
+                       const CongestionEvent& congestionEvent,
+                       const RTTSample& rtt) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    // Handle the congestion event
+    CwndEvent(socket, congestionEvent);
+
+    // Update with RTT if valid
+    if (rtt.rtt.count() > 0) {
+        PktsAcked(socket, 1, rtt.rtt.count());
+    }
+}
+
+// Get decision
+CcDecision HPCC::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    CcDecision decision = CongestionControl::GetDecision(socket);
+    if (socket == nullptr) {
+        return decision;
+    }
+
+    // RDMA NICs pace packet by packet; a TSO-sized burst would be a whole window
+    uint64_t rate = GetPacingRate();
+    if (rate != 0) {
+        decision.pacing_rate = rate;
+        decision.send_quantum = socket->mss_bytes_;
+    }
+
+    uint32_t baseRtt = GetBaseRtt();
+    FillAckFrequency(decision, socket->mss_bytes_, baseRtt != 0 ? baseRtt : socket->rtt_us_, false);
+    return decision;
+}
+
+// NewAck: recompute W from the INT records
+void HPCC::OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) {
+    if (socket == nullptr || metadata.hop_count == 0) {
+        return;
+    }
+
+    uint32_t hopCount = std::min(metadata.hop_count, AckMetadata::MAX_INT_HOPS);
+    uint32_t baseRtt = GetBaseRtt();
+
+    if (!m_initialized) {
+        m_maxCwnd = socket->max_cwnd_;
+        m_referenceWindow = socket->cwnd_;
+        m_window = m_referenceWindow;
+        m_initialized = true;
+    }
+
+    // Records of another path are not comparable
+    if (hopCount == m_lastHopCount && baseRtt != 0) {
+        double utilization = MeasureInflight(metadata, baseRtt);
+
+        bool updateReference = m_bytesAcked >= m_roundEndBytes;
+        m_window = ComputeWindow(utilization, updateReference);
+        if (updateReference) {
+            m_roundEndBytes = m_bytesAcked + socket->cwnd_;
+            CC_PROBE5(hpcc_update_window, static_cast<void*>(this), CC_PROBE_FIXED(m_utilization),
+                      static_cast<uint64_t>(m_referenceWindow), static_cast<uint64_t>(m_window), m_incStage);
+        }
+        ApplyCwnd(socket);
+    }
+
+    // Line-rate window of the slowest hop caps W
+    if (baseRtt != 0) {
+        uint64_t lineRate = 0;
+        for (uint32_t i = 0; i < hopCount; i++) {
+            if (lineRate == 0 || metadata.hops[i].link_rate_bps < lineRate) {
+                lineRate = metadata.hops[i].link_rate_bps;
+            }
+        }
+        m_lineRateWindow = lineRate / 8 * baseRtt / 1000000;
+    }
+
+    std::copy(metadata.hops, metadata.hops + hopCount, m_lastHops);
+    m_lastHopCount = hopCount;
+}
+
+// Set base RTT
+void HPCC::SetBaseRtt(uint32_t baseRttUs) {
+    m_baseRtt = baseRttUs;
+}
+
+// Set additive increase
+void HPCC::SetAdditiveIncrease(uint32_t bytes) {
+    m_additiveIncrease = bytes;
+}
+
+// Get pacing rate
+uint64_t HPCC::GetPacingRate() const {
+    uint32_t baseRtt = GetBaseRtt();
+    if (baseRtt == 0 || m_cwnd == 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(m_cwnd) * 1000000 / baseRtt;
+}
+
+// Get normalized inflight
+double HPCC::GetUtilization() const {
+    return m_utilization;
+}
+
+// Get reference window
+double HPCC::GetReferenceWindow() const {
+    return m_referenceWindow;
+}
+
+// MeasureInflight (Algorithm 1)
+double HPCC::MeasureInflight(const AckMetadata& metadata, uint32_t baseRtt) {
+    double maxInflight = 0.0;
+    double tau = 0.0;
+    uint32_t hopCount = std::min(metadata.hop_count, AckMetadata::MAX_INT_HOPS);
+
+    for (uint32_t i = 0; i < hopCount; i++) {
+        const IntHop& hop = metadata.hops[i];
+        const IntHop& last = m_lastHops[i];
+        if (hop.link_rate_bps == 0 || hop.timestamp_us <= last.timestamp_us || hop.tx_bytes < last.tx_bytes) {
+            continue;
+        }
+
+        // Bytes per microsecond
+        double interval = static_cast<double>(hop.timestamp_us - last.timestamp_us);
+        double rate = static_cast<double>(hop.link_rate_bps) / 8.0 / 1000000.0;
+        double txRate = static_cast<double>(hop.tx_bytes - last.tx_bytes) / interval;
+
+        double inflight = static_cast<double>(std::min(hop.queue_bytes, last.queue_bytes)) / (rate * baseRtt) +
+                          txRate / rate;
+        if (inflight > maxInflight) {
+            maxInflight = inflight;
+            tau = interval;
+        }
+    }
+
+    if (tau == 0.0) {
+        return m_utilization;
+    }
+
+    tau = std::min(tau, static_cast<double>(baseRtt));
+    m_utilization = (1.0 - tau / baseRtt) * m_utilization + tau / baseRtt * maxInflight;
+    return m_utilization;
+}
+
+// ComputeWind (Algorithm 1)
+double HPCC::ComputeWindow(double utilization, bool updateReference) {
+    double window;
+    if (utilization >= ETA || m_incStage >= MAX_STAGE) {
+        // Multiplicative step toward eta utilization
+        window = m_referenceWindow / (std::max(utilization, MIN_UTILIZATION) / ETA) + GetAdditiveIncrease();
+        if (updateReference) {
+            m_incStage = 0;
+        }
+    } else {
+        // Additive step
+        window = m_referenceWindow + GetAdditiveIncrease();
+        if (updateReference) {
+            m_incStage++;
+        }
+    }
+
+    // Never above line rate
+    if (m_lineRateWindow != 0) {
+        window = std::min(window, static_cast<double>(m_lineRateWindow));
+    }
+
+    if (updateReference) {
+        m_referenceWindow = window;
+    }
+    return window;
+}
+
+// Track min RTT
+void HPCC::UpdateRTT(uint32_t rtt, uint64_t nowUs) {
+    if (rtt == 0) {
+        return;
+    }
+
+    // A stale minimum is replaced (path change)
+    if (rtt <= m_minRTT || nowUs - m_minRTTTimestamp > MIN_RTT_WINDOW_US) {
+        m_minRTT = rtt;
+        m_minRTTTimestamp = nowUs;
+    }
+}
+
+// Clamp and publish the window
+void HPCC::ApplyCwnd(std::unique_ptr<SocketState>& socket) {
+    uint32_t maxCwnd = std::max(socket->max_cwnd_, socket->mss_bytes_);
+    double window = std::min(std::max(m_window, static_cast<double>(socket->mss_bytes_)), static_cast<double>(maxCwnd));
+
+    m_maxCwnd = maxCwnd;
+    m_cwnd = static_cast<uint32_t>(window);
+    socket->cwnd_ = m_cwnd;
+}
+
+// Get W_AI
+double HPCC::GetAdditiveIncrease() const {
+    if (m_additiveIncrease != 0) {
+        return m_additiveIncrease;
+    }
+    if (m_lineRateWindow == 0) {
+        return MIN_W_AI;
+    }
+    return std::max(static_cast<double>(m_lineRateWindow) * (1.0 - ETA) / EXPECTED_FLOWS, static_cast<double>(MIN_W_AI));
+}
+
+// Get T
+uint32_t HPCC::GetBaseRtt() const {
+    if (m_baseRtt != 0) {
+        return m_baseRtt;
+    }
+    return m_minRTT != 0xFFFFFFFF ? m_minRTT : 0;
+}
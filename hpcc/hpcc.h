@@ -0,0 +1,138 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 23:05:42
+@Description: HPCC (High Precision Congestion Control) Algorithm
+@Language: C++17
+*/
+
+#ifndef HPCC_H
+#define HPCC_H
+
+#include "../utils/cong.h"
+
+#include <string>
+
+/*
+ * HPCC (Li et al., SIGCOMM 2019).
+ *
+ * Every ACK echoes the INT records (queue length, tx bytes, timestamp,
+ * link rate) the switches stamped on the data packet. From two records
+ * of the same hop HPCC computes that link's normalized inflight
+ *
+ *     u = min(qlen, qlen') / (B x T) + txRate / B
+ *
+ * keeps an EWMA U of the most loaded hop over one base RTT T, and sets
+ * the window so the bottleneck runs at the target utilization eta:
+ *
+ *     W = Wc / (U / eta) + W_AI      if U >= eta or after maxStage AI rounds
+ *     W = Wc + W_AI                  otherwise
+ *
+ * The reference window Wc takes W once per RTT; in between, every ACK
+ * recomputes W from Wc, so reactions are fast without overreacting.
+ * The flow is paced at W / T.
+ *
+ * The paper's rounds end when an ACK passes the snd_nxt of the last
+ * update; the API has no sequence numbers, so a round here ends after
+ * one window of acknowledged bytes. Flows start from the stack's
+ * initial window instead of line rate (there is no PFC in the
+ * simulator) and reach it through the multiplicative step.
+ */
+class HPCC: public CongestionControl {
+public:
+    HPCC();
+    HPCC(const HPCC& other);
+    ~HPCC() override;
+
+    TypeId GetTypeId();
+
+    std::string GetAlgorithmName() override;
+
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
+    void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
+
+    void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
+
+    void CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) override;
+
+    void CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) override;
+
+    bool HasCongControl() const override;
+
+    void CongControl(std::unique_ptr<SocketState>& socket, const CongestionEvent& congestionEvent, const RTTSample& rtt) override;
+
+    // Paced at W / T
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    // INT records drive the window
+    void OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) override;
+
+    // Base RTT T (microseconds), 0 = learn the min RTT
+    void SetBaseRtt(uint32_t baseRttUs);
+
+    // Additive increase W_AI (bytes), 0 = W_init x (1 - eta) / EXPECTED_FLOWS
+    void SetAdditiveIncrease(uint32_t bytes);
+
+    // Get pacing rate (bytes/sec)
+    uint64_t GetPacingRate() const;
+
+    // Normalized inflight estimate U
+    double GetUtilization() const;
+
+    // Reference window Wc (bytes)
+    double GetReferenceWindow() const;
+
+protected:
+    // MeasureInflight: fold the most loaded hop into U
+    virtual double MeasureInflight(const AckMetadata& metadata, uint32_t baseRtt);
+
+    // ComputeWind: window from U, moving Wc once per round
+    virtual double ComputeWindow(double utilization, bool updateReference);
+
+    // Track min RTT
+    virtual void UpdateRTT(uint32_t rtt, uint64_t nowUs);
+
+private:
+    // Clamp W and publish it to the socket
+    void ApplyCwnd(std::unique_ptr<SocketState>& socket);
+
+    // T: configured base RTT or the learned min RTT, 0 = unknown
+    uint32_t GetBaseRtt() const;
+
+    // W_AI: configured, or derived from the line-rate window as in the paper
+    double GetAdditiveIncrease() const;
+
+    // Standard TCP parameters
+    uint32_t m_cwnd;               // Published congestion window (bytes)
+    uint32_t m_maxCwnd;            // Maximum congestion window
+
+    // HPCC state
+    double m_window;               // W (bytes)
+    double m_referenceWindow;      // Wc (bytes)
+    double m_utilization;          // U
+    uint32_t m_incStage;           // AI rounds since the last multiplicative step
+    bool m_initialized;            // Wc seeded from the socket
+    IntHop m_lastHops[AckMetadata::MAX_INT_HOPS];  // Previous record of each hop
+    uint32_t m_lastHopCount;       // Hops in m_lastHops, 0 = none yet
+    uint64_t m_lineRateWindow;     // B x T of the slowest hop (bytes), 0 = unknown
+
+    // Rounds
+    uint64_t m_bytesAcked;         // Total bytes acknowledged
+    uint64_t m_roundEndBytes;      // m_bytesAcked that ends the current round
+
+    // RTT
+    uint32_t m_baseRtt;            // Configured T, 0 = learn
+    uint32_t m_minRTT;             // Learned min RTT (microseconds)
+    uint64_t m_minRTTTimestamp;    // When m_minRTT was last confirmed
+    uint32_t m_additiveIncrease;   // Configured W_AI (bytes), 0 = derive
+
+    // Configuration constants
+    static constexpr double ETA = 0.95;                     // Target utilization
+    static constexpr uint32_t MAX_STAGE = 5;                // AI rounds before a multiplicative step
+    static constexpr uint32_t EXPECTED_FLOWS = 1;           // N in W_AI = W_init x (1 - eta) / N
+    static constexpr uint32_t MIN_W_AI = 80;                // Bytes
+    static constexpr double MIN_UTILIZATION = 0.01;         // Bounds the multiplicative step
+    static constexpr uint64_t MIN_RTT_WINDOW_US = 10000000; // Min RTT validity window (10s)
+};
+
+#endif // HPCC_H
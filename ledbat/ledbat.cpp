@@ -0,0 +1,378 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 01:27:40
+@Description: LEDBAT++ (lower-than-best-effort scavenger) Algorithm Implementation
+@Language: C++17
+*/
+
+#include "ledbat.h"
+#include "../utils/probes.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// Default constructor
+Ledbat::Ledbat()
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::LEDBAT), "Ledbat"),
+      m_cwnd(0),                    // Will be set from the socket
+      m_maxCwnd(65535),             // Default max window
+      m_ssthresh(0x7fffffff),       // Initially very large (effectively no limit)
+      m_window(0.0),
+      m_phase(LedbatPhase::SLOW_START),
+      m_lastRtt(0),
+      m_target(DEFAULT_TARGET_US),
+      m_nextSlowdownUs(0),          // First slowdown follows the initial slow start
+      m_slowdownStartUs(0),
+      m_slowdownEndUs(0),
+      m_lastDecreaseUs(0)           // No decrease yet
+{
+}
+
+// Copy constructor
+Ledbat::Ledbat(const Ledbat& other)
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::LEDBAT), "Ledbat"),
+      m_cwnd(other.m_cwnd),
+      m_maxCwnd(other.m_maxCwnd),
+      m_ssthresh(other.m_ssthresh),
+      m_window(other.m_window),
+      m_phase(other.m_phase),
+      m_baseHistory(other.m_baseHistory),
+      m_currentDelays(other.m_currentDelays),
+      m_lastRtt(other.m_lastRtt),
+      m_target(other.m_target),
+      m_nextSlowdownUs(other.m_nextSlowdownUs),
+      m_slowdownStartUs(other.m_slowdownStartUs),
+      m_slowdownEndUs(other.m_slowdownEndUs),
+      m_lastDecreaseUs(other.m_lastDecreaseUs)
+{
+}
+
+// Destructor
+Ledbat::~Ledbat() {
+    // Deques clean up automatically
+}
+
+// Get type ID
+TypeId Ledbat::GetTypeId() {
+    return static_cast<TypeId>(CongestionAlgorithm::LEDBAT);
+}
+
+// Get algorithm name
+std::string Ledbat::GetAlgorithmName() {
+    return "Ledbat";
+}
+
+// Get slow start threshold
+uint32_t Ledbat::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    if (socket == nullptr) {
+        return m_ssthresh;
+    }
+
+    // Halve the window, like Reno
+    m_ssthresh = std::max(socket->cwnd_ / 2, MIN_CWND * socket->mss_bytes_);
+
+    socket->ssthresh_ = m_ssthresh;
+    return m_ssthresh;
+}
+
+// Increase congestion window
+void Ledbat::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+    if (socket == nullptr || segmentsAcked == 0) {
+        return;
+    }
+
+    // Pick up changes made outside the algorithm (recovery exit)
+    if (socket->cwnd_ != m_cwnd || m_window == 0.0) {
+        m_window = socket->cwnd_;
+    }
+    uint64_t now = socket->NowUs();
+
+    switch (m_phase) {
+        case LedbatPhase::SLOWDOWN:
+            // Hold 2 segments until the queue has drained, then regain the old window
+            if (now < m_slowdownEndUs) {
+                return;
+            }
+            m_phase = LedbatPhase::SLOW_START;
+            SlowStart(socket, segmentsAcked, now);
+            break;
+
+        case LedbatPhase::SLOW_START:
+            SlowStart(socket, segmentsAcked, now);
+            break;
+
+        case LedbatPhase::CONGESTION_AVOIDANCE:
+            if (m_nextSlowdownUs != 0 && now >= m_nextSlowdownUs && m_lastRtt != 0) {
+                StartSlowdown(socket, now);
+                return;
+            }
+            CongestionAvoidance(socket, segmentsAcked);
+            break;
+    }
+
+    ApplyCwnd(socket);
+}
+
+// Update RTT and delay estimates
+void Ledbat::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+    if (socket == nullptr || segmentsAcked == 0) {
+        return;
+    }
+
+    // Update RTT information
+    socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
+
+    // Update RTT variance
+    if (socket->rtt_var_ == 0) {
+        socket->rtt_var_ = rtt / 2;
+    } else {
+        socket->rtt_var_ = (3 * socket->rtt_var_ + rtt) / 4;
+    }
+    socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
+
+    if (rtt == 0) {
+        return;
+    }
+    m_lastRtt = static_cast<uint32_t>(rtt);
+    UpdateBaseDelay(m_lastRtt, socket->NowUs());
+    UpdateCurrentDelay(m_lastRtt);
+}
+
+// Set congestion state
+void Ledbat::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    socket->tcp_state_ = congestionState;
+}
+
+// Handle congestion window events
+void Ledbat::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    CC_PROBE_CWND_EVENT(ledbat_cwnd_event, socket, congestionEvent);
+    socket->congestion_event_ = congestionEvent;
+    uint64_t now = socket->NowUs();
+
+    switch (congestionEvent) {
+        case CongestionEvent::PacketLoss:
+        case CongestionEvent::ECN: {
+            // RFC 6817: halve at most once per RTT; a slowdown is already at the floor
+            bool recent = m_lastDecreaseUs != 0 && now - m_lastDecreaseUs < m_lastRtt;
+            if (m_phase != LedbatPhase::SLOWDOWN && !recent) {
+                m_ssthresh = std::max(socket->cwnd_ / 2, MIN_CWND * socket->mss_bytes_);
+                m_lastDecreaseUs = now;
+                if (m_phase == LedbatPhase::SLOW_START) {
+                    ExitSlowStart(now);
+                }
+            } else {
+                m_ssthresh = std::max(socket->cwnd_, MIN_CWND * socket->mss_bytes_);
+            }
+            socket->ssthresh_ = m_ssthresh;
+            if (congestionEvent == CongestionEvent::ECN) {
+                m_window = std::min(static_cast<double>(socket->cwnd_), static_cast<double>(m_ssthresh));
+                ApplyCwnd(socket);
+                socket->tcp_state_ = TCPState::CWR;
+            } else {
+                socket->tcp_state_ = TCPState::Recovery;
+            }
+            break;
+        }
+
+        case CongestionEvent::Timeout:
+            // Back to one segment and slow start
+            m_ssthresh = std::max(socket->cwnd_ / 2, MIN_CWND * socket->mss_bytes_);
+            socket->ssthresh_ = m_ssthresh;
+            m_window = socket->mss_bytes_;
+            m_phase = LedbatPhase::SLOW_START;
+            m_lastDecreaseUs = now;
+            socket->tcp_state_ = TCPState::Loss;
+            ApplyCwnd(socket);
+            break;
+
+        case CongestionEvent::FastRecovery:
+            socket->tcp_state_ = TCPState::Recovery;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Check if congestion control is enabled
+bool Ledbat::HasCongControl() const {
+    return true;
+}
+
+// Main congestion control logic
+void Ledbat::CongControl(std::unique_ptr<SocketState>& socket,
+                         const CongestionEvent& congestionEvent,
+                         const RTTSample& rtt) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    // Handle the congestion event
+    CwndEvent(socket, congestionEvent);
+
+    // Update with RTT if valid
+    if (rtt.rtt.count() > 0) {
+        PktsAcked(socket, 1, rtt.rtt.count());
+        IncreaseWindow(socket, 1);
+    }
+}
+
+// Set target queueing delay
+void Ledbat::SetTarget(uint32_t targetUs) {
+    m_target = std::max(targetUs, 1u);
+}
+
+// Get base delay
+uint32_t Ledbat::GetBaseDelay() const {
+    if (m_baseHistory.empty()) {
+        return 0;
+    }
+    uint32_t base = 0xFFFFFFFF;
+    for (const auto& sample : m_baseHistory) {
+        base = std::min(base, sample.rtt_us);
+    }
+    return base;
+}
+
+// Get queueing delay
+uint32_t Ledbat::GetQueuingDelay() const {
+    if (m_currentDelays.empty()) {
+        return 0;
+    }
+    uint32_t current = *std::min_element(m_currentDelays.begin(), m_currentDelays.end());
+    uint32_t base = GetBaseDelay();
+    return current > base ? current - base : 0;
+}
+
+// Get phase
+LedbatPhase Ledbat::GetPhase() const {
+    return m_phase;
+}
+
+// Modified slow start: GAIN segments per ACKed segment
+void Ledbat::SlowStart(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, uint64_t nowUs) {
+    // Leave early once the queue reaches 3/4 of the target; after a slowdown
+    // the old window is regained whatever the delay, as the draft specifies
+    bool early = m_slowdownStartUs == 0 && GetQueuingDelay() > m_target / 4 * 3;
+    if (early || m_window >= m_ssthresh) {
+        ExitSlowStart(nowUs);
+        CongestionAvoidance(socket, segmentsAcked);
+        return;
+    }
+
+    // RFC 3465 limit on stretch ACKs
+    uint32_t limit = (socket->tcp_state_ == TCPState::Loss) ? 1 : ABC_LIMIT;
+    m_window += GetGain() * std::min(segmentsAcked, limit) * socket->mss_bytes_;
+    m_window = std::min(m_window, static_cast<double>(m_ssthresh));
+}
+
+// Delay-based window update
+void Ledbat::CongestionAvoidance(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+    if (m_currentDelays.empty() || m_window <= 0.0) {
+        return;
+    }
+
+    double mss = socket->mss_bytes_;
+    double segments = m_window / mss;
+    double gain = GetGain();
+    uint32_t queuing = GetQueuingDelay();
+
+    // Increase by GAIN per RTT under the target; above it, decrease with the
+    // excess delay, by at most half a window per RTT
+    double perRtt = gain;
+    if (queuing >= m_target) {
+        double excess = static_cast<double>(queuing) / m_target - 1.0;
+        perRtt = std::max(gain - segments * excess, -segments / 2.0);
+    }
+    m_window += perRtt * mss * segmentsAcked / segments;
+}
+
+// Track base delay (RFC 6817 base history)
+void Ledbat::UpdateBaseDelay(uint32_t rtt, uint64_t nowUs) {
+    if (rtt == 0) {
+        return;
+    }
+
+    // A new interval starts every minute; the oldest one ages out
+    if (m_baseHistory.empty() || nowUs - m_baseHistory.back().timestamp_us >= BASE_INTERVAL_US) {
+        m_baseHistory.push_back(LedbatDelaySample(rtt, nowUs));
+        while (m_baseHistory.size() > BASE_HISTORY) {
+            m_baseHistory.pop_front();
+        }
+        return;
+    }
+
+    // Update the current interval if this is smaller
+    m_baseHistory.back().rtt_us = std::min(m_baseHistory.back().rtt_us, rtt);
+}
+
+// Track current delay
+void Ledbat::UpdateCurrentDelay(uint32_t rtt) {
+    m_currentDelays.push_back(rtt);
+    while (m_currentDelays.size() > CURRENT_FILTER) {
+        m_currentDelays.pop_front();
+    }
+}
+
+// GAIN = 1 / min(16, ceil(2 x TARGET / base))
+double Ledbat::GetGain() const {
+    uint32_t base = GetBaseDelay();
+    if (base == 0) {
+        return 1.0 / MAX_GAIN_DIVISOR;
+    }
+    double divisor = std::ceil(2.0 * m_target / base);
+    divisor = std::min(std::max(divisor, 1.0), static_cast<double>(MAX_GAIN_DIVISOR));
+    return 1.0 / divisor;
+}
+
+// Periodic slowdown
+void Ledbat::StartSlowdown(std::unique_ptr<SocketState>& socket, uint64_t nowUs) {
+    // Slow start brings the window back to where it was
+    m_ssthresh = static_cast<uint32_t>(m_window);
+    socket->ssthresh_ = m_ssthresh;
+    m_phase = LedbatPhase::SLOWDOWN;
+    m_slowdownStartUs = nowUs;
+    m_slowdownEndUs = nowUs + static_cast<uint64_t>(SLOWDOWN_RTTS) * m_lastRtt;
+    m_nextSlowdownUs = 0;
+    m_window = MIN_CWND * socket->mss_bytes_;
+    ApplyCwnd(socket);
+
+    CC_PROBE5(ledbat_slowdown, static_cast<void*>(this), m_ssthresh, GetBaseDelay(),
+              GetQueuingDelay(), m_lastRtt);
+}
+
+// Leave slow start
+void Ledbat::ExitSlowStart(uint64_t nowUs) {
+    m_phase = LedbatPhase::CONGESTION_AVOIDANCE;
+
+    // The first slowdown follows the initial slow start after 2 RTTs; later
+    // ones wait 9x the slowdown's duration, for at most ~10% utilization cost
+    if (m_slowdownStartUs != 0) {
+        m_nextSlowdownUs = nowUs + SLOWDOWN_INTERVAL_FACTOR * (nowUs - m_slowdownStartUs);
+        m_slowdownStartUs = 0;
+    } else if (m_nextSlowdownUs == 0) {
+        m_nextSlowdownUs = nowUs + static_cast<uint64_t>(SLOWDOWN_RTTS) * m_lastRtt;
+    }
+}
+
+// Publish the window
+void Ledbat::ApplyCwnd(std::unique_ptr<SocketState>& socket) {
+    m_maxCwnd = socket->max_cwnd_;
+    double floor = static_cast<double>(MIN_CWND) * socket->mss_bytes_;
+    if (socket->tcp_state_ == TCPState::Loss) {
+        floor = socket->mss_bytes_;
+    }
+    m_window = std::min(std::max(m_window, floor), static_cast<double>(m_maxCwnd));
+    m_cwnd = static_cast<uint32_t>(m_window);
+    socket->cwnd_ = m_cwnd;
+}
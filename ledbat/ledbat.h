@@ -0,0 +1,145 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 01:27:40
+@Description: LEDBAT++ (lower-than-best-effort scavenger) Algorithm
+@Language: C++17
+*/
+
+#ifndef LEDBAT_H
+#define LEDBAT_H
+
+#include "../utils/cong.h"
+
+#include <string>
+#include <deque>
+
+// LEDBAT++ phases
+enum class LedbatPhase {
+    SLOW_START,             // Modified slow start: GAIN segments per ACK
+    CONGESTION_AVOIDANCE,   // Delay-based window control
+    SLOWDOWN,               // Periodic slowdown: 2 segments to re-measure the base delay
+};
+
+// One base delay history entry: minimum delay of a one-minute interval
+struct LedbatDelaySample {
+    uint32_t rtt_us;            // Minimum RTT in the interval (microseconds)
+    uint64_t timestamp_us;      // Start of the interval
+
+    LedbatDelaySample(uint32_t rtt = 0, uint64_t timestamp = 0)
+        : rtt_us(rtt), timestamp_us(timestamp) {}
+};
+
+/*
+ * LEDBAT++ (RFC 6817, draft-irtf-iccrg-ledbat-plus-plus).
+ *
+ * A scavenger: it keeps the queueing delay it adds below a target and
+ * yields to any flow that builds a queue. Queueing delay is the current
+ * delay (min of the last CURRENT_FILTER RTTs) minus the base delay (min
+ * of BASE_HISTORY one-minute minima). Delay is measured as RTT, as the
+ * draft does, since no one-way timestamps are available.
+ *
+ * Per ACK, with W = cwnd in segments and GAIN = 1 / min(16, ceil(2 x
+ * TARGET / base)):
+ *
+ *     delay < target:  W += GAIN / W
+ *     delay >= target: W += max(GAIN - W x (delay / target - 1), -W / 2) / W
+ *
+ * so the window halves at most once per RTT of excess delay. Slow start
+ * adds GAIN per ACKed segment and ends at 3/4 of the target. Every so
+ * often the window drops to 2 segments for 2 RTTs so that competing
+ * LEDBAT flows drain the queue and agree on the base delay; the next
+ * slowdown follows after 9 times the time it took to recover, which
+ * keeps the utilization cost near 10%.
+ */
+class Ledbat: public CongestionControl {
+public:
+    Ledbat();
+    Ledbat(const Ledbat& other);
+    ~Ledbat() override;
+
+    TypeId GetTypeId();
+
+    std::string GetAlgorithmName() override;
+
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
+    void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
+
+    void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
+
+    void CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) override;
+
+    void CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) override;
+
+    bool HasCongControl() const override;
+
+    void CongControl(std::unique_ptr<SocketState>& socket, const CongestionEvent& congestionEvent, const RTTSample& rtt) override;
+
+    // Target queueing delay (microseconds)
+    void SetTarget(uint32_t targetUs);
+
+    // Base delay: min of the history (microseconds), 0 = no sample
+    uint32_t GetBaseDelay() const;
+
+    // Current delay minus base delay (microseconds)
+    uint32_t GetQueuingDelay() const;
+
+    LedbatPhase GetPhase() const;
+
+protected:
+    // Modified slow start
+    virtual void SlowStart(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, uint64_t nowUs);
+
+    // Delay-based increase / decrease
+    virtual void CongestionAvoidance(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked);
+
+    // Track base delay (RFC 6817 base history)
+    virtual void UpdateBaseDelay(uint32_t rtt, uint64_t nowUs);
+
+    // Track current delay
+    virtual void UpdateCurrentDelay(uint32_t rtt);
+
+private:
+    // GAIN for the current base delay
+    double GetGain() const;
+
+    // Drop to 2 segments for SLOWDOWN_RTTS
+    void StartSlowdown(std::unique_ptr<SocketState>& socket, uint64_t nowUs);
+
+    // Leave slow start and schedule the next slowdown
+    void ExitSlowStart(uint64_t nowUs);
+
+    // Publish the window
+    void ApplyCwnd(std::unique_ptr<SocketState>& socket);
+
+    // Standard TCP parameters
+    uint32_t m_cwnd;               // Congestion window (bytes)
+    uint32_t m_maxCwnd;            // Maximum congestion window
+    uint32_t m_ssthresh;           // Slow start threshold
+    double m_window;               // Fractional window (bytes)
+    LedbatPhase m_phase;
+
+    // Delay state
+    std::deque<LedbatDelaySample> m_baseHistory;  // Per-minute minima, newest last
+    std::deque<uint32_t> m_currentDelays;         // Last CURRENT_FILTER RTTs
+    uint32_t m_lastRtt;            // Latest RTT sample
+    uint32_t m_target;             // Target queueing delay (microseconds)
+
+    // Slowdown schedule
+    uint64_t m_nextSlowdownUs;     // 0 = not scheduled
+    uint64_t m_slowdownStartUs;    // Start of the last slowdown, 0 = none pending
+    uint64_t m_slowdownEndUs;      // End of the current slowdown
+    uint64_t m_lastDecreaseUs;     // Last loss / ECN decrease, 0 = none
+
+    // Configuration constants
+    static constexpr uint32_t DEFAULT_TARGET_US = 60000;        // 60ms (draft)
+    static constexpr uint32_t MAX_GAIN_DIVISOR = 16;            // GAIN >= 1/16
+    static constexpr uint32_t MIN_CWND = 2;                     // Segments
+    static constexpr uint32_t CURRENT_FILTER = 4;               // RTTs in the current delay filter
+    static constexpr uint32_t BASE_HISTORY = 10;                // One-minute minima kept
+    static constexpr uint64_t BASE_INTERVAL_US = 60000000;      // 1 minute
+    static constexpr uint32_t SLOWDOWN_RTTS = 2;                // Slowdown length
+    static constexpr uint32_t SLOWDOWN_INTERVAL_FACTOR = 9;     // Next slowdown after 9x its cost
+};
+
+#endif // LEDBAT_H
@@ -6,6 +6,7 @@
 */
 
 #include "reno.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 
@@ -14,7 +15,8 @@ Reno::Reno()
     : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::RENO), "Reno"),
       m_ssthresh(0x7fffffff),  // Initially very large (effectively no limit)
       m_cwnd(0),                // Will be set based on MSS
-      m_maxCwnd(65535)          // Default max window
+      m_maxCwnd(65535),         // Default max window
+      m_bytesAcked(0)           // Nothing ACKed in congestion avoidance yet
 {
 }
 
@@ -23,7 +25,8 @@ Reno::Reno(const Reno& other)
     : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::RENO), "Reno"),
       m_ssthresh(other.m_ssthresh),
       m_cwnd(other.m_cwnd),
-      m_maxCwnd(other.m_maxCwnd)
+      m_maxCwnd(other.m_maxCwnd),
+      m_bytesAcked(other.m_bytesAcked)
 {
 }
 
@@ -42,6 +45,19 @@ std::string Reno::GetAlgorithmName() {
     return "Reno";
 }
 
+// Get slow start threshold
+uint32_t Reno::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    if (socket == nullptr) {
+        return m_ssthresh;
+    }
+
+    // Reno: halve the window (RFC 5681)
+    m_ssthresh = std::max(socket->cwnd_ / 2, 2 * socket->mss_bytes_);
+
+    socket->ssthresh_ = m_ssthresh;
+    return m_ssthresh;
+}
+
 // Increase congestion window based on current state
 void Reno::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
     if (socket == nullptr || segmentsAcked == 0) {
@@ -56,12 +72,20 @@ void Reno::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segment
     if (socket->tcp_state_ == TCPState::Recovery) {
         // Fast recovery - handled separately
         m_cwnd = FastRecovery(socket, segmentsAcked);
-    } else if (m_cwnd < m_ssthresh) {
-        // Slow start phase
-        m_cwnd = SlowStart(socket, segmentsAcked);
     } else {
+        // Slow start phase; a stretch ACK crossing ssthresh carries
+        // its remaining segments into congestion avoidance
+        if (m_cwnd < m_ssthresh) {
+            uint32_t mss = socket->mss_bytes_;
+            uint32_t ssSegments = std::min(segmentsAcked, (m_ssthresh - m_cwnd + mss - 1) / mss);
+            m_cwnd = SlowStart(socket, ssSegments);
+            segmentsAcked -= ssSegments;
+        }
+
         // Congestion avoidance phase
-        m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        if (segmentsAcked > 0 && m_cwnd >= m_ssthresh) {
+            m_cwnd = CongestionAvoidance(socket, segmentsAcked);
+        }
     }
 
     // Ensure we don't exceed maximum window
@@ -77,6 +101,7 @@ void Reno::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcke
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     
     // Basic RTT variance calculation (simplified)
     if (socket->rtt_var_ == 0) {
@@ -110,6 +135,7 @@ void Reno::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
         return;
     }
 
+    CC_PROBE_CWND_EVENT(reno_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     switch (congestionEvent) {
@@ -118,6 +144,7 @@ void Reno::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
             // Reduce window and enter slow start
             m_ssthresh = std::max(socket->cwnd_ / 2, 2 * socket->mss_bytes_);
             socket->ssthresh_ = m_ssthresh;
+            m_bytesAcked = 0;
             
             if (congestionEvent == CongestionEvent::Timeout) {
                 // Timeout: reset cwnd to initial window
@@ -137,6 +164,7 @@ void Reno::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent
             socket->ssthresh_ = m_ssthresh;
             socket->cwnd_ = m_cwnd;
             socket->tcp_state_ = TCPState::CWR;
+            m_bytesAcked = 0;
             break;
 
         case CongestionEvent::FastRecovery:
@@ -176,8 +204,9 @@ uint32_t Reno::SlowStart(std::unique_ptr<SocketState>& socket, uint32_t segments
         return m_cwnd;
     }
 
-    // Increase cwnd by segmentsAcked * MSS (exponential growth)
-    uint32_t newCwnd = m_cwnd + (segmentsAcked * socket->mss_bytes_);
+    // RFC 3465: grow by the bytes ACKed, at most L MSS per ACK (L = 1 after an RTO)
+    uint32_t limit = socket->tcp_state_ == TCPState::Loss ? 1 : ABC_LIMIT;
+    uint32_t newCwnd = m_cwnd + std::min(segmentsAcked, limit) * socket->mss_bytes_;
     
     // Don't exceed ssthresh in slow start
     if (newCwnd > m_ssthresh) {
@@ -193,16 +222,14 @@ uint32_t Reno::CongestionAvoidance(std::unique_ptr<SocketState>& socket, uint32_
         return m_cwnd;
     }
 
-    // Increase cwnd by approximately MSS per RTT
-    // Formula: cwnd += MSS * MSS / cwnd (for each ACK)
-    uint32_t mss = socket->mss_bytes_;
-    uint32_t increment = (segmentsAcked * mss * mss) / m_cwnd;
-    
-    if (increment == 0 && segmentsAcked > 0) {
-        increment = 1;  // Ensure at least some progress
+    // RFC 3465: one MSS for every cwnd worth of bytes ACKed, whatever
+    // the ACK pattern; a stretch ACK may cover more than one window
+    uint32_t newCwnd = m_cwnd;
+    m_bytesAcked += segmentsAcked * socket->mss_bytes_;
+    while (m_bytesAcked >= newCwnd && newCwnd > 0) {
+        m_bytesAcked -= newCwnd;
+        newCwnd += socket->mss_bytes_;
     }
-
-    uint32_t newCwnd = m_cwnd + increment;
     return std::min(newCwnd, m_maxCwnd);
 }
 
@@ -22,6 +22,8 @@ public:
 
     std::string GetAlgorithmName() override;
 
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
     void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
 
     void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
@@ -46,6 +48,7 @@ private:
     uint32_t m_ssthresh;
     uint32_t m_cwnd;
     uint32_t m_maxCwnd;
+    uint32_t m_bytesAcked;      // RFC 3465 bytes_acked: bytes ACKed towards the next 1 MSS increase
 };
 
 #endif // RENO_H
\ No newline at end of file
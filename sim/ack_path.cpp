@@ -0,0 +1,190 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 13:02:47
+@Description: Reverse (ACK) path impairments implementation
+@Language: C++17
+*/
+
+#include "ack_path.h"
+
+#include <algorithm>
+
+// Delayed ACK state constructor
+DelayedAckState::DelayedAckState()
+    : m_highestSeq(0),
+      m_pending(0),
+      m_pendingCe(false),
+      m_pendingCeCount(0),
+      m_generation(0),
+      m_timerArmed(false)
+{
+}
+
+// Account a received packet
+void DelayedAckState::Add(const SimPacket& packet) {
+    if (m_pending == 0 || packet.seq > m_highestSeq) {
+        m_highestSeq = packet.seq;
+    }
+    m_pendingCe = m_pendingCe || packet.ecn_ce;
+    m_pendingCeCount += packet.ecn_ce ? 1 : 0;
+    if (packet.int_hop.link_rate_bps != 0) {
+        m_pendingInt = packet.int_hop;
+    }
+    m_pending++;
+}
+
+// Build an ACK for all pending packets
+SimAck DelayedAckState::Flush(uint32_t flowId) {
+    SimAck ack;
+    ack.flow_id = flowId;
+    ack.cum_seq = m_highestSeq;
+    ack.segments = m_pending;
+    ack.ecn_echo = m_pendingCe;
+    ack.ce_segments = m_pendingCeCount;
+    ack.int_hop = m_pendingInt;
+
+    m_pending = 0;
+    m_pendingCe = false;
+    m_pendingCeCount = 0;
+    m_pendingInt = IntHop();
+    m_generation++;
+    m_timerArmed = false;
+    return ack;
+}
+
+// Get number of unacknowledged packets
+uint32_t DelayedAckState::GetPending() const {
+    return m_pending;
+}
+
+// Get CE state of pending packets
+bool DelayedAckState::GetPendingCe() const {
+    return m_pendingCe;
+}
+
+// Get timer generation
+uint64_t DelayedAckState::GetGeneration() const {
+    return m_generation;
+}
+
+// Check if the delayed ACK timer is armed
+bool DelayedAckState::IsTimerArmed() const {
+    return m_timerArmed;
+}
+
+// Mark the delayed ACK timer armed
+void DelayedAckState::ArmTimer() {
+    m_timerArmed = true;
+}
+
+// Reverse queue constructor
+ReverseAckQueue::ReverseAckQueue(std::unique_ptr<LinkModel> link, uint32_t bufferBytes, uint32_t ackSize,
+                                 bool thinning, uint32_t maxMerge)
+    : m_link(std::move(link)),
+      m_bufferBytes(bufferBytes),
+      m_ackSize(ackSize),
+      m_thinning(thinning),
+      m_maxMerge(maxMerge),
+      m_busy(false)
+{
+}
+
+// Queue an ACK, merging it into a waiting ACK of the same flow when thinning
+bool ReverseAckQueue::Enqueue(const SimAck& ack, AckPathStats& stats) {
+    // Control packets (GRANT, NACK) are never thinned
+    if (m_thinning && ack.segments > 0) {
+        // The head may already be on the wire; only waiting ACKs can be replaced
+        size_t first = m_busy ? 1 : 0;
+        for (size_t i = m_queue.size(); i > first; i--) {
+            SimAck& queued = m_queue[i - 1];
+            if (queued.flow_id != ack.flow_id || queued.segments == 0) {
+                continue;
+            }
+            if (queued.merged + 1 >= m_maxMerge) {
+                break;
+            }
+
+            // Cumulative ACKs: the newer one covers the older one
+            queued.cum_seq = std::max(queued.cum_seq, ack.cum_seq);
+            queued.segments += ack.segments;
+            queued.ecn_echo = queued.ecn_echo || ack.ecn_echo;
+            queued.ce_segments += ack.ce_segments;
+            if (ack.int_hop.link_rate_bps != 0) {
+                queued.int_hop = ack.int_hop;
+            }
+            queued.merged += ack.merged + 1;
+            stats.acks_thinned++;
+            return false;
+        }
+    }
+
+    if ((m_queue.size() + 1) * m_ackSize > m_bufferBytes) {
+        stats.acks_dropped++;
+        return false;
+    }
+
+    m_queue.push_back(ack);
+    return !m_busy;
+}
+
+// Start serializing the head ACK
+SimTime ReverseAckQueue::StartTransmission(SimTime now) {
+    m_busy = true;
+    return m_link->Transmit(now, m_ackSize);
+}
+
+// Remove the head ACK after serialization
+SimAck ReverseAckQueue::Pop() {
+    SimAck ack = m_queue.front();
+    m_queue.pop_front();
+    m_busy = false;
+    return ack;
+}
+
+// Check if the queue is empty
+bool ReverseAckQueue::Empty() const {
+    return m_queue.empty();
+}
+
+// Aggregator constructor
+AckAggregator::AckAggregator(SimTime interval, uint32_t maxBurst)
+    : m_interval(std::max<SimTime>(interval, 1)),
+      m_maxBurst(maxBurst),
+      m_scheduled(false)
+{
+}
+
+// Hold an ACK until the next TXOP
+SimTime AckAggregator::Add(const SimAck& ack, SimTime now) {
+    m_held.push_back(ack);
+    if (m_scheduled) {
+        return 0;
+    }
+
+    m_scheduled = true;
+    return NextBoundary(now);
+}
+
+// Release up to m_maxBurst ACKs
+SimTime AckAggregator::Release(SimTime now, std::deque<SimAck>& out) {
+    size_t count = m_held.size();
+    if (m_maxBurst > 0) {
+        count = std::min<size_t>(count, m_maxBurst);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        out.push_back(m_held.front());
+        m_held.pop_front();
+    }
+
+    if (m_held.empty()) {
+        m_scheduled = false;
+        return 0;
+    }
+    return NextBoundary(now);
+}
+
+// First TXOP boundary strictly after now
+SimTime AckAggregator::NextBoundary(SimTime now) const {
+    return (now / m_interval + 1) * m_interval;
+}
@@ -0,0 +1,166 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 13:02:47
+@Description: Reverse (ACK) path impairments: delayed ACK, aggregation, thinning, reverse bottleneck
+@Language: C++17
+*/
+
+#ifndef ACK_PATH_H
+#define ACK_PATH_H
+
+#include "sim_types.h"
+#include "link_model.h"
+
+#include <deque>
+#include <memory>
+
+// Cumulative ACK: every received packet with seq <= cum_seq is acknowledged.
+// Receiver-driven control packets (GRANT, NACK) cover no segments
+struct SimAck {
+    uint32_t flow_id;
+    uint64_t cum_seq;           // highest packet sequence covered, or the NACKed packet
+    uint32_t segments;          // data packets covered by this ACK
+    bool ecn_echo;              // at least one covered packet was CE marked
+    uint32_t ce_segments;       // covered packets that were CE marked (DCTCP-style exact echo)
+    uint32_t merged;            // ACKs folded into this one by thinning
+    IntHop int_hop;             // INT record of the newest covered packet
+    uint64_t grant_offset;      // GRANT: bytes the sender may have transmitted in total, 0 = none
+    bool nack;                  // NACK: packet cum_seq was trimmed, nothing is acknowledged
+
+    SimAck()
+        : flow_id(0), cum_seq(0), segments(0), ecn_echo(false), ce_segments(0), merged(0), grant_offset(0),
+          nack(false) {}
+};
+
+// Reverse path configuration, every impairment is off by default
+struct AckPathConfig {
+    // Delayed ACK: one ACK per `ack_quota` packets or when the timer expires
+    bool delayed_ack;
+    uint32_t ack_quota;
+    SimTime delack_timeout_us;
+
+    // Wi-Fi style aggregation: ACKs wait for the next TXOP and leave in bursts
+    bool aggregation;
+    SimTime aggregation_interval_us;
+    uint32_t aggregation_max_burst;             // 0 = release everything
+
+    // ACK thinning: a new ACK replaces a queued ACK of the same flow
+    bool thinning;
+    uint32_t thinning_max_merge;                // ACKs merged at most into one
+
+    // Asymmetric reverse bottleneck (nullptr = uncongested reverse path)
+    std::unique_ptr<LinkModel> reverse_link;
+    uint32_t reverse_buffer_bytes;
+    uint32_t ack_size_bytes;
+
+    AckPathConfig()
+        : delayed_ack(false), ack_quota(2), delack_timeout_us(40000),
+          aggregation(false), aggregation_interval_us(4000), aggregation_max_burst(0),
+          thinning(false), thinning_max_merge(8),
+          reverse_buffer_bytes(64 * 1024), ack_size_bytes(64) {}
+};
+
+// Reverse path counters
+struct AckPathStats {
+    uint64_t acks_generated;    // ACKs emitted by receivers
+    uint64_t acks_delivered;    // ACKs that reached senders
+    uint64_t acks_thinned;      // ACKs merged into a later ACK
+    uint64_t acks_dropped;      // ACKs dropped by the reverse bottleneck
+    uint64_t max_burst;         // largest aggregated release
+
+    AckPathStats()
+        : acks_generated(0), acks_delivered(0), acks_thinned(0), acks_dropped(0), max_burst(0) {}
+};
+
+// Per-flow receiver state for delayed ACK
+class DelayedAckState {
+public:
+    DelayedAckState();
+
+    // Account a received packet
+    void Add(const SimPacket& packet);
+
+    // Build the ACK for everything pending and reset
+    SimAck Flush(uint32_t flowId);
+
+    uint32_t GetPending() const;
+    bool GetPendingCe() const;
+
+    // Timer bookkeeping: a timer event is valid only for its generation
+    uint64_t GetGeneration() const;
+    bool IsTimerArmed() const;
+    void ArmTimer();
+
+private:
+    uint64_t m_highestSeq;      // Highest packet received
+    uint32_t m_pending;         // Packets not yet acknowledged
+    bool m_pendingCe;           // CE state of pending packets
+    uint32_t m_pendingCeCount;  // Pending packets that were CE marked
+    IntHop m_pendingInt;        // INT record of the newest pending packet
+    uint64_t m_generation;      // Bumped on every flush
+    bool m_timerArmed;
+};
+
+// Reverse bottleneck queue, optionally thinning ACKs of the same flow
+class ReverseAckQueue {
+public:
+    ReverseAckQueue(std::unique_ptr<LinkModel> link, uint32_t bufferBytes, uint32_t ackSize,
+                    bool thinning, uint32_t maxMerge);
+
+    /**
+     * @brief Queue an ACK.
+     *
+     * @param ack ACK to queue
+     * @param stats counters to update
+     * @return true if a new transmission must be started
+     */
+    bool Enqueue(const SimAck& ack, AckPathStats& stats);
+
+    // Start serializing the head ACK, returns its departure time
+    SimTime StartTransmission(SimTime now);
+
+    // Remove the transmitted head ACK
+    SimAck Pop();
+
+    bool Empty() const;
+
+private:
+    std::unique_ptr<LinkModel> m_link;
+    std::deque<SimAck> m_queue;
+    uint32_t m_bufferBytes;
+    uint32_t m_ackSize;
+    bool m_thinning;
+    uint32_t m_maxMerge;
+    bool m_busy;                // Head ACK is being serialized
+};
+
+// Wi-Fi aggregation point: releases ACKs at TXOP boundaries
+class AckAggregator {
+public:
+    AckAggregator(SimTime interval, uint32_t maxBurst);
+
+    /**
+     * @brief Hold an ACK until the next TXOP.
+     *
+     * @return release time to schedule, or 0 if a release is already scheduled
+     */
+    SimTime Add(const SimAck& ack, SimTime now);
+
+    /**
+     * @brief Release one burst.
+     *
+     * @param out released ACKs are appended here
+     * @return time of the next release, or 0 if nothing is left
+     */
+    SimTime Release(SimTime now, std::deque<SimAck>& out);
+
+private:
+    SimTime NextBoundary(SimTime now) const;
+
+    SimTime m_interval;
+    uint32_t m_maxBurst;
+    std::deque<SimAck> m_held;
+    bool m_scheduled;
+};
+
+#endif // ACK_PATH_H
@@ -0,0 +1,407 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 21:03:18
+@Description: Columnar binary result files implementation
+@Language: C++17
+*/
+
+#include "columnar.h"
+
+#include <algorithm>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "columnar files are little-endian; add byte swapping for this target"
+#endif
+
+namespace {
+
+const char MAGIC[4] = {'C', 'C', 'O', 'L'};
+const uint8_t VERSION = 1;
+
+template <typename T>
+void Put(std::vector<uint8_t>& buffer, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool Get(const std::vector<uint8_t>& buffer, size_t& pos, T& value) {
+    if (pos + sizeof(T) > buffer.size()) {
+        return false;
+    }
+    std::memcpy(&value, buffer.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+}  // namespace
+
+// Bytes per value
+size_t ColumnWidth(ColumnType type) {
+    return type == ColumnType::UINT32 ? 4 : 8;
+}
+
+// Writer constructor
+ColumnarWriter::ColumnarWriter(size_t rowGroupRows)
+    : m_rowGroupRows(std::max<size_t>(rowGroupRows, 1)),
+      m_open(false),
+      m_active(&m_groups[0]),
+      m_pending(nullptr),
+      m_stop(false),
+      m_offset(0),
+      m_failed(false),
+      m_rows(0),
+      m_stalls(0)
+{
+}
+
+// Destructor closes an open file
+ColumnarWriter::~ColumnarWriter() {
+    Close();
+}
+
+// Create the file and start the writer thread
+bool ColumnarWriter::Open(const std::string& path, const std::vector<ColumnSpec>& schema) {
+    if (m_open || schema.empty()) {
+        return false;
+    }
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        return false;
+    }
+
+    m_schema = schema;
+    for (RowGroup& group : m_groups) {
+        group.columns.clear();
+        for (const ColumnSpec& column : m_schema) {
+            group.columns.emplace_back(m_rowGroupRows * ColumnWidth(column.type), 0);
+        }
+        group.rows = 0;
+    }
+    m_active = &m_groups[0];
+    m_pending = nullptr;
+    m_stop = false;
+    m_index.clear();
+    m_failed = false;
+    m_rows = 0;
+    m_stalls = 0;
+
+    m_file.write(MAGIC, sizeof(MAGIC));
+    m_file.put(static_cast<char>(VERSION));
+    m_offset = sizeof(MAGIC) + 1;
+
+    m_open = true;
+    m_thread = std::thread(&ColumnarWriter::WriterLoop, this);
+    return true;
+}
+
+// Hand the full buffer to the writer thread and switch to the other one
+void ColumnarWriter::Submit() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_pending != nullptr) {
+        m_stalls++;
+        m_cv.wait(lock, [this] { return m_pending == nullptr; });
+    }
+
+    m_rows += m_active->rows;
+    m_pending = m_active;
+    m_active = m_active == &m_groups[0] ? &m_groups[1] : &m_groups[0];
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+// Writer thread: write row groups as they are submitted
+void ColumnarWriter::WriterLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this] { return m_pending != nullptr || m_stop; });
+        if (m_pending == nullptr) {
+            return;
+        }
+
+        RowGroup* group = m_pending;
+        lock.unlock();
+        WriteGroup(*group);
+        lock.lock();
+
+        m_pending = nullptr;
+        m_cv.notify_all();
+    }
+}
+
+// Write every column chunk of a group, then clear it for reuse
+void ColumnarWriter::WriteGroup(RowGroup& group) {
+    GroupIndex index;
+    index.rows = group.rows;
+
+    for (size_t c = 0; c < m_schema.size(); c++) {
+        size_t bytes = group.rows * ColumnWidth(m_schema[c].type);
+        m_file.write(reinterpret_cast<const char*>(group.columns[c].data()), static_cast<std::streamsize>(bytes));
+        index.offsets.push_back(m_offset);
+        index.sizes.push_back(bytes);
+        m_offset += bytes;
+
+        std::fill(group.columns[c].begin(), group.columns[c].begin() + bytes, 0);
+    }
+
+    if (!m_file) {
+        m_failed = true;
+    }
+    m_index.push_back(std::move(index));
+    group.rows = 0;
+}
+
+// Footer: schema and chunk index
+bool ColumnarWriter::WriteFooter() {
+    std::vector<uint8_t> footer;
+
+    Put<uint32_t>(footer, static_cast<uint32_t>(m_schema.size()));
+    for (const ColumnSpec& column : m_schema) {
+        Put<uint8_t>(footer, static_cast<uint8_t>(column.type));
+        Put<uint16_t>(footer, static_cast<uint16_t>(column.name.size()));
+        footer.insert(footer.end(), column.name.begin(), column.name.end());
+    }
+
+    Put<uint32_t>(footer, static_cast<uint32_t>(m_index.size()));
+    for (const GroupIndex& group : m_index) {
+        Put<uint64_t>(footer, group.rows);
+        for (size_t c = 0; c < m_schema.size(); c++) {
+            Put<uint64_t>(footer, group.offsets[c]);
+            Put<uint64_t>(footer, group.sizes[c]);
+        }
+    }
+
+    Put<uint32_t>(footer, static_cast<uint32_t>(footer.size()));
+    footer.insert(footer.end(), MAGIC, MAGIC + sizeof(MAGIC));
+
+    m_file.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+    return static_cast<bool>(m_file);
+}
+
+// Flush, stop the thread and finish the file
+bool ColumnarWriter::Close() {
+    if (!m_open) {
+        return false;
+    }
+
+    if (m_active->rows > 0) {
+        Submit();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+
+    // A group submitted just before m_stop is written by the loop before it exits
+    bool ok = !m_failed && WriteFooter();
+    m_file.close();
+    m_open = false;
+    return ok && !m_file.fail();
+}
+
+bool ColumnarWriter::IsOpen() const {
+    return m_open;
+}
+
+const std::vector<ColumnSpec>& ColumnarWriter::GetSchema() const {
+    return m_schema;
+}
+
+// Rows handed to the writer thread plus rows in the open group
+uint64_t ColumnarWriter::GetRowCount() const {
+    return m_rows + m_active->rows;
+}
+
+uint64_t ColumnarWriter::GetStallCount() const {
+    return m_stalls;
+}
+
+// Reader constructor
+ColumnarReader::ColumnarReader() {
+}
+
+// Open a file and parse its footer
+bool ColumnarReader::Open(const std::string& path) {
+    m_file.open(path, std::ios::binary);
+    if (!m_file) {
+        return false;
+    }
+
+    char head[sizeof(MAGIC) + 1];
+    if (!m_file.read(head, sizeof(head)) || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), head) ||
+        static_cast<uint8_t>(head[sizeof(MAGIC)]) != VERSION) {
+        return false;
+    }
+
+    // Trailer: footer length and magic
+    char tail[4 + sizeof(MAGIC)];
+    m_file.seekg(0, std::ios::end);
+    std::streamoff fileSize = m_file.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(head) + sizeof(tail))) {
+        return false;
+    }
+    m_file.seekg(fileSize - static_cast<std::streamoff>(sizeof(tail)));
+    if (!m_file.read(tail, sizeof(tail)) || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), tail + 4)) {
+        return false;
+    }
+
+    uint32_t footerLength = 0;
+    std::memcpy(&footerLength, tail, sizeof(footerLength));
+    if (footerLength > fileSize - static_cast<std::streamoff>(sizeof(head) + sizeof(tail))) {
+        return false;
+    }
+
+    std::vector<uint8_t> footer(footerLength);
+    m_file.seekg(fileSize - static_cast<std::streamoff>(sizeof(tail) + footerLength));
+    if (!m_file.read(reinterpret_cast<char*>(footer.data()), footerLength)) {
+        return false;
+    }
+
+    size_t pos = 0;
+    uint32_t columns = 0;
+    if (!Get(footer, pos, columns)) {
+        return false;
+    }
+    m_schema.clear();
+    for (uint32_t c = 0; c < columns; c++) {
+        uint8_t type = 0;
+        uint16_t nameLength = 0;
+        if (!Get(footer, pos, type) || !Get(footer, pos, nameLength) ||
+            type > static_cast<uint8_t>(ColumnType::DOUBLE) || pos + nameLength > footer.size()) {
+            return false;
+        }
+        ColumnSpec spec;
+        spec.name.assign(reinterpret_cast<const char*>(footer.data() + pos), nameLength);
+        spec.type = static_cast<ColumnType>(type);
+        pos += nameLength;
+        m_schema.push_back(spec);
+    }
+
+    uint32_t groups = 0;
+    if (!Get(footer, pos, groups)) {
+        return false;
+    }
+    m_groupRows.assign(groups, 0);
+    m_offsets.assign(groups, std::vector<uint64_t>(columns, 0));
+    m_sizes.assign(groups, std::vector<uint64_t>(columns, 0));
+    for (uint32_t g = 0; g < groups; g++) {
+        if (!Get(footer, pos, m_groupRows[g])) {
+            return false;
+        }
+        for (uint32_t c = 0; c < columns; c++) {
+            if (!Get(footer, pos, m_offsets[g][c]) || !Get(footer, pos, m_sizes[g][c])) {
+                return false;
+            }
+            if (m_sizes[g][c] != m_groupRows[g] * ColumnWidth(m_schema[c].type)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+const std::vector<ColumnSpec>& ColumnarReader::GetSchema() const {
+    return m_schema;
+}
+
+size_t ColumnarReader::GetRowGroupCount() const {
+    return m_groupRows.size();
+}
+
+uint64_t ColumnarReader::GetRowGroupRows(size_t group) const {
+    return group < m_groupRows.size() ? m_groupRows[group] : 0;
+}
+
+uint64_t ColumnarReader::GetRowCount() const {
+    uint64_t rows = 0;
+    for (uint64_t r : m_groupRows) {
+        rows += r;
+    }
+    return rows;
+}
+
+// Find a column by name
+int ColumnarReader::FindColumn(const std::string& name) const {
+    for (size_t c = 0; c < m_schema.size(); c++) {
+        if (m_schema[c].name == name) {
+            return static_cast<int>(c);
+        }
+    }
+    return -1;
+}
+
+// Load the raw bytes of one chunk
+bool ColumnarReader::ReadChunk(size_t group, size_t column) {
+    if (group >= m_groupRows.size() || column >= m_schema.size()) {
+        return false;
+    }
+
+    m_chunk.resize(static_cast<size_t>(m_sizes[group][column]));
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_offsets[group][column]));
+    return static_cast<bool>(m_file.read(reinterpret_cast<char*>(m_chunk.data()),
+                                         static_cast<std::streamsize>(m_chunk.size())));
+}
+
+// Integer column chunk
+bool ColumnarReader::ReadColumn(size_t group, size_t column, std::vector<uint64_t>& values) {
+    values.clear();
+    if (column >= m_schema.size() || m_schema[column].type == ColumnType::DOUBLE || !ReadChunk(group, column)) {
+        return false;
+    }
+
+    size_t rows = static_cast<size_t>(m_groupRows[group]);
+    values.resize(rows);
+    if (m_schema[column].type == ColumnType::UINT32) {
+        for (size_t i = 0; i < rows; i++) {
+            uint32_t v;
+            std::memcpy(&v, m_chunk.data() + i * 4, 4);
+            values[i] = v;
+        }
+    } else {
+        std::memcpy(values.data(), m_chunk.data(), rows * 8);
+    }
+    return true;
+}
+
+// Any column chunk as double
+bool ColumnarReader::ReadColumn(size_t group, size_t column, std::vector<double>& values) {
+    values.clear();
+    if (column >= m_schema.size() || !ReadChunk(group, column)) {
+        return false;
+    }
+
+    size_t rows = static_cast<size_t>(m_groupRows[group]);
+    values.resize(rows);
+    for (size_t i = 0; i < rows; i++) {
+        switch (m_schema[column].type) {
+            case ColumnType::UINT32: {
+                uint32_t v;
+                std::memcpy(&v, m_chunk.data() + i * 4, 4);
+                values[i] = static_cast<double>(v);
+                break;
+            }
+            case ColumnType::UINT64: {
+                uint64_t v;
+                std::memcpy(&v, m_chunk.data() + i * 8, 8);
+                values[i] = static_cast<double>(v);
+                break;
+            }
+            case ColumnType::INT64: {
+                int64_t v;
+                std::memcpy(&v, m_chunk.data() + i * 8, 8);
+                values[i] = static_cast<double>(v);
+                break;
+            }
+            case ColumnType::DOUBLE:
+                std::memcpy(&values[i], m_chunk.data() + i * 8, 8);
+                break;
+        }
+    }
+    return true;
+}
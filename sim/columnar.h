@@ -0,0 +1,179 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 21:03:18
+@Description: Columnar binary result files written by a background thread
+@Language: C++17
+*/
+
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed-width column types
+enum class ColumnType : uint8_t {
+    UINT32 = 0,
+    UINT64 = 1,
+    INT64 = 2,
+    DOUBLE = 3
+};
+
+// One column of a schema
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+// Bytes per value of a column type
+size_t ColumnWidth(ColumnType type);
+
+/*
+ * Columnar writer.
+ *
+ * Rows are buffered column by column into a row group. When the group is
+ * full it is handed to a background thread and the other buffer takes its
+ * place, so the caller only waits if the disk falls a whole row group
+ * behind. File layout (little-endian, the same idea as Parquet without
+ * encodings or Thrift):
+ *
+ *   "CCOL" | u8 version
+ *   row group 0: column 0 values | column 1 values | ...
+ *   row group 1: ...
+ *   footer:
+ *     u32 column_count, per column: u8 type | u16 name_length | name
+ *     u32 group_count, per group: u64 rows | per column: u64 offset | u64 bytes
+ *   u32 footer_length | "CCOL"
+ *
+ * Each column chunk is a plain array of fixed-width values, so it can be
+ * memory-mapped or loaded with numpy.frombuffer / Arrow's from_buffers at
+ * the offset given in the footer.
+ */
+class ColumnarWriter {
+public:
+    explicit ColumnarWriter(size_t rowGroupRows = DEFAULT_ROW_GROUP_ROWS);
+    ~ColumnarWriter();
+
+    // Create the file and start the writer thread, false if it cannot be opened
+    bool Open(const std::string& path, const std::vector<ColumnSpec>& schema);
+
+    // Set a value of the current row (columns left unset are 0)
+    inline void SetUInt32(size_t column, uint32_t value) { Store(column, &value, sizeof(value)); }
+    inline void SetUInt64(size_t column, uint64_t value) { Store(column, &value, sizeof(value)); }
+    inline void SetInt64(size_t column, int64_t value) { Store(column, &value, sizeof(value)); }
+    inline void SetDouble(size_t column, double value) { Store(column, &value, sizeof(value)); }
+
+    // Finish the current row
+    inline void EndRow() {
+        if (++m_active->rows == m_rowGroupRows) {
+            Submit();
+        }
+    }
+
+    /**
+     * @brief Flush the last row group, write the footer and close the file.
+     *
+     * @return false if any write failed
+     */
+    bool Close();
+
+    bool IsOpen() const;
+    const std::vector<ColumnSpec>& GetSchema() const;
+    uint64_t GetRowCount() const;
+
+    // Times the caller had to wait for the writer thread
+    uint64_t GetStallCount() const;
+
+    static constexpr size_t DEFAULT_ROW_GROUP_ROWS = 65536;
+
+private:
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    struct RowGroup {
+        std::vector<std::vector<uint8_t>> columns;  // rows * width bytes each
+        size_t rows;
+    };
+
+    struct GroupIndex {
+        uint64_t rows;
+        std::vector<uint64_t> offsets;
+        std::vector<uint64_t> sizes;
+    };
+
+    inline void Store(size_t column, const void* value, size_t width) {
+        std::memcpy(m_active->columns[column].data() + m_active->rows * width, value, width);
+    }
+
+    void Submit();
+    void WriterLoop();
+    void WriteGroup(RowGroup& group);
+    bool WriteFooter();
+
+    size_t m_rowGroupRows;
+    std::vector<ColumnSpec> m_schema;
+    std::ofstream m_file;
+    bool m_open;
+
+    // Double buffer: the caller fills m_active while the thread writes the other one
+    RowGroup m_groups[2];
+    RowGroup* m_active;
+    RowGroup* m_pending;                // Handed to the thread, nullptr when idle
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop;
+
+    // Owned by the writer thread until it is joined
+    uint64_t m_offset;                  // Next file offset
+    std::vector<GroupIndex> m_index;
+    bool m_failed;
+
+    uint64_t m_rows;
+    uint64_t m_stalls;
+};
+
+// Reads files written by ColumnarWriter
+class ColumnarReader {
+public:
+    ColumnarReader();
+
+    // Open a file and read its footer, false if it is not a valid file
+    bool Open(const std::string& path);
+
+    const std::vector<ColumnSpec>& GetSchema() const;
+    size_t GetRowGroupCount() const;
+    uint64_t GetRowGroupRows(size_t group) const;
+    uint64_t GetRowCount() const;
+
+    // Column index by name, -1 if absent
+    int FindColumn(const std::string& name) const;
+
+    // Read one chunk of an integer column (UINT32, UINT64 or INT64)
+    bool ReadColumn(size_t group, size_t column, std::vector<uint64_t>& values);
+
+    // Read one chunk of any column converted to double
+    bool ReadColumn(size_t group, size_t column, std::vector<double>& values);
+
+private:
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    bool ReadChunk(size_t group, size_t column);
+
+    std::ifstream m_file;
+    std::vector<ColumnSpec> m_schema;
+    std::vector<uint64_t> m_groupRows;
+    std::vector<std::vector<uint64_t>> m_offsets;   // [group][column]
+    std::vector<std::vector<uint64_t>> m_sizes;
+    std::vector<uint8_t> m_chunk;                   // Last chunk read
+};
+
+#endif // COLUMNAR_H
@@ -0,0 +1,105 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 00:36:12
+@Description: Receiver-driven transport: SRPT grant scheduling implementation
+@Language: C++17
+*/
+
+#include "grant_scheduler.h"
+
+#include <algorithm>
+
+// Grant scheduler constructor
+GrantScheduler::GrantScheduler(uint32_t overcommit)
+    : m_overcommit(std::max<uint32_t>(overcommit, 1))
+{
+}
+
+// Register a message
+void GrantScheduler::AddMessage(uint32_t flowId, uint64_t sizeBytes, uint64_t unscheduledBytes,
+                                uint64_t windowBytes) {
+    Message message;
+    message.size = sizeBytes;
+    message.received = 0;
+    message.trimmed = 0;
+    message.granted = unscheduledBytes;
+    message.window = windowBytes;
+    m_messages[flowId] = message;
+}
+
+// Check if a message is known
+bool GrantScheduler::HasMessage(uint32_t flowId) const {
+    return m_messages.count(flowId) != 0;
+}
+
+// Account received payload
+void GrantScheduler::OnData(uint32_t flowId, uint32_t bytes) {
+    auto it = m_messages.find(flowId);
+    if (it == m_messages.end()) {
+        return;
+    }
+
+    Message& message = it->second;
+    message.received += bytes;
+    if (message.size != 0 && message.received >= message.size) {
+        m_messages.erase(it);
+    }
+}
+
+// Account a trimmed packet
+void GrantScheduler::OnTrim(uint32_t flowId, uint32_t bytes) {
+    auto it = m_messages.find(flowId);
+    if (it != m_messages.end()) {
+        it->second.trimmed += bytes;
+    }
+}
+
+// SRPT: the shortest messages get up to one window outstanding
+void GrantScheduler::Schedule(std::vector<Grant>& out) {
+    if (m_messages.empty()) {
+        return;
+    }
+
+    // Fully granted messages leave their slot to the next one, which avoids a bubble at the switch
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    order.reserve(m_messages.size());
+    for (const auto& entry : m_messages) {
+        const Message& message = entry.second;
+        if (message.size != 0 && message.granted >= message.size + message.trimmed) {
+            continue;
+        }
+        order.emplace_back(Remaining(message), entry.first);
+    }
+    size_t count = std::min<size_t>(m_overcommit, order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end());
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t flowId = order[i].second;
+        Message& message = m_messages[flowId];
+
+        // Trimmed bytes are sent again, so they are granted on top
+        uint64_t target = message.received + message.window;
+        if (message.size != 0) {
+            target = std::min(target, message.size);
+        }
+        target += message.trimmed;
+
+        if (target > message.granted) {
+            message.granted = target;
+            out.push_back(Grant{flowId, target});
+        }
+    }
+}
+
+// Get number of incomplete messages
+size_t GrantScheduler::GetActiveMessages() const {
+    return m_messages.size();
+}
+
+// Bytes still to receive
+uint64_t GrantScheduler::Remaining(const Message& message) {
+    if (message.size == 0) {
+        return UINT64_MAX;
+    }
+    return message.size - std::min(message.received, message.size);
+}
@@ -0,0 +1,92 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 00:36:12
+@Description: Receiver-driven transport: SRPT grant scheduling (Homa/NDP style)
+@Language: C++17
+*/
+
+#ifndef GRANT_SCHEDULER_H
+#define GRANT_SCHEDULER_H
+
+#include "sim_types.h"
+
+#include <map>
+#include <vector>
+
+// Receiver-driven mode configuration
+struct ReceiverDrivenConfig {
+    uint64_t unscheduled_bytes;     // blind bytes each message sends in its first RTT, 0 = one BDP
+    uint64_t window_bytes;          // granted but not yet received bytes per message, 0 = one BDP
+    uint32_t overcommit;            // messages granted at once (Homa's degree of overcommitment)
+    bool trimming;                  // NDP: cut packets that overflow the buffer to their header
+
+    ReceiverDrivenConfig()
+        : unscheduled_bytes(0), window_bytes(0), overcommit(1), trimming(true) {}
+};
+
+// Credit for one message: the sender may have transmitted `offset` bytes in total
+struct Grant {
+    uint32_t flow_id;
+    uint64_t offset;
+};
+
+/*
+ * Receiver side of a receiver-driven transport.
+ *
+ * A message is known from its first packet (the header carries the
+ * message length, as in Homa). Its sender starts with the unscheduled
+ * bytes as credit; everything after that needs grants. On every arrival
+ * the receiver ranks the messages that still have ungranted bytes by
+ * remaining bytes (SRPT) and lets the `overcommit` shortest ones have up
+ * to one window granted but not yet received, so grants are clocked by
+ * arriving data and the downlink carries about one window per granted
+ * message.
+ *
+ * Trimmed packets (NDP) are refunded: their bytes are granted again, but
+ * only when the message is scheduled, so messages waiting for their turn
+ * do not retransmit into the burst that trimmed them.
+ */
+class GrantScheduler {
+public:
+    explicit GrantScheduler(uint32_t overcommit);
+
+    /**
+     * @brief Register a message on its first packet.
+     *
+     * @param flowId flow carrying the message
+     * @param sizeBytes message length, 0 = unbounded (ranked last)
+     * @param unscheduledBytes credit the sender started with
+     * @param windowBytes granted but not yet received bytes while scheduled
+     */
+    void AddMessage(uint32_t flowId, uint64_t sizeBytes, uint64_t unscheduledBytes, uint64_t windowBytes);
+
+    bool HasMessage(uint32_t flowId) const;
+
+    // Payload reached the receiver; the message is forgotten once complete
+    void OnData(uint32_t flowId, uint32_t bytes);
+
+    // Only the header of a packet reached the receiver
+    void OnTrim(uint32_t flowId, uint32_t bytes);
+
+    // Raise the grants of the `overcommit` shortest messages, appending each raised one
+    void Schedule(std::vector<Grant>& out);
+
+    size_t GetActiveMessages() const;
+
+private:
+    struct Message {
+        uint64_t size;              // 0 = unbounded
+        uint64_t received;          // payload bytes received
+        uint64_t trimmed;           // payload bytes lost to trimming
+        uint64_t granted;           // credit offset given to the sender
+        uint64_t window;
+    };
+
+    // Bytes still to receive, unbounded messages last
+    static uint64_t Remaining(const Message& message);
+
+    std::map<uint32_t, Message> m_messages;  // Incomplete messages by flow id
+    uint32_t m_overcommit;
+};
+
+#endif // GRANT_SCHEDULER_H
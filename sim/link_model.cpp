@@ -0,0 +1,283 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 10:41:18
+@Description: Bottleneck link capacity models implementation
+@Language: C++17
+*/
+
+#include "link_model.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Default: capacity unknown
+uint64_t LinkModel::GetCapacityBytes(SimTime now) {
+    return 0;
+}
+
+// Default: no nominal rate
+uint64_t LinkModel::GetRateBps() const {
+    return 0;
+}
+
+// Fixed rate link constructor
+FixedRateLink::FixedRateLink(uint64_t rateBps)
+    : m_rateBps(rateBps),
+      m_busyUntil(0),
+      m_rateSince(0),
+      m_capacityBefore(0.0)
+{
+}
+
+// Serialization time = bytes * 8 / rate
+SimTime FixedRateLink::Transmit(SimTime now, uint32_t bytes) {
+    SimTime start = std::max(now, m_busyUntil);
+    if (m_rateBps == 0) {
+        return start;
+    }
+
+    SimTime txTime = (static_cast<uint64_t>(bytes) * 8 * 1000000 + m_rateBps - 1) / m_rateBps;
+    m_busyUntil = start + txTime;
+    return m_busyUntil;
+}
+
+// Integrate the rate over time
+uint64_t FixedRateLink::GetCapacityBytes(SimTime now) {
+    if (now <= m_rateSince) {
+        return static_cast<uint64_t>(m_capacityBefore);
+    }
+    double current = static_cast<double>(now - m_rateSince) * m_rateBps / 8.0 / 1000000.0;
+    return static_cast<uint64_t>(m_capacityBefore + current);
+}
+
+// Get link rate
+uint64_t FixedRateLink::GetRateBps() const {
+    return m_rateBps;
+}
+
+// Change link rate at `now` (takes effect on the next packet)
+void FixedRateLink::SetRateBps(uint64_t rateBps, SimTime now) {
+    if (now > m_rateSince) {
+        m_capacityBefore += static_cast<double>(now - m_rateSince) * m_rateBps / 8.0 / 1000000.0;
+        m_rateSince = now;
+    }
+    m_rateBps = rateBps;
+}
+
+// Trace link constructor
+TraceLink::TraceLink(uint32_t mtu)
+    : m_fd(-1),
+      m_data(nullptr),
+      m_size(0),
+      m_pos(0),
+      m_releasedPos(0),
+      m_mtu(mtu),
+      m_startUs(0),
+      m_periodUs(0),
+      m_wrapOffsetUs(0),
+      m_lastOpportunity(0),
+      m_leftoverBytes(0),
+      m_opportunities(0)
+{
+}
+
+// Destructor
+TraceLink::~TraceLink() {
+    Close();
+}
+
+// Map the trace and find its period (the last timestamp)
+bool TraceLink::Open(const std::string& path, SimTime startUs) {
+    Close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    m_fd = fd;
+    m_data = static_cast<const char*>(addr);
+    m_size = static_cast<size_t>(st.st_size);
+
+    // Scan backwards for the last number instead of parsing the whole file
+    size_t end = m_size;
+    while (end > 0 && (m_data[end - 1] < '0' || m_data[end - 1] > '9')) {
+        end--;
+    }
+    size_t begin = end;
+    while (begin > 0 && m_data[begin - 1] >= '0' && m_data[begin - 1] <= '9') {
+        begin--;
+    }
+    if (begin == end) {
+        Close();
+        return false;
+    }
+
+    uint64_t lastMs = 0;
+    for (size_t i = begin; i < end; i++) {
+        lastMs = lastMs * 10 + static_cast<uint64_t>(m_data[i] - '0');
+    }
+
+    // A trace whose opportunities all sit at t=0 still needs a non-zero period
+    m_periodUs = std::max<uint64_t>(lastMs, 1) * 1000;
+    m_startUs = startUs;
+    m_pos = 0;
+    m_releasedPos = 0;
+    m_wrapOffsetUs = 0;
+    m_lastOpportunity = 0;
+    m_leftoverBytes = 0;
+    m_opportunities = 0;
+    return true;
+}
+
+// Unmap the trace
+void TraceLink::Close() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+    m_pos = 0;
+}
+
+// Check if a trace is mapped
+bool TraceLink::IsOpen() const {
+    return m_data != nullptr;
+}
+
+// Consume as many opportunities as the packet needs
+SimTime TraceLink::Transmit(SimTime now, uint32_t bytes) {
+    if (!IsOpen()) {
+        return now;
+    }
+
+    uint32_t remaining = bytes;
+
+    // Bytes left in an opportunity can only be used at that same instant
+    if (m_leftoverBytes > 0 && m_lastOpportunity >= now) {
+        uint32_t used = std::min(remaining, m_leftoverBytes);
+        m_leftoverBytes -= used;
+        remaining -= used;
+    } else {
+        m_leftoverBytes = 0;
+    }
+
+    SimTime done = std::max(now, m_lastOpportunity);
+    while (remaining > 0) {
+        done = NextOpportunity(now);
+        uint32_t used = std::min(remaining, m_mtu);
+        remaining -= used;
+        m_leftoverBytes = m_mtu - used;
+        m_lastOpportunity = done;
+        now = done;
+    }
+
+    return done;
+}
+
+// Count the opportunities that already passed, wasting the unused ones
+uint64_t TraceLink::GetCapacityBytes(SimTime now) {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    while (true) {
+        size_t pos = m_pos;
+        size_t releasedPos = m_releasedPos;
+        SimTime wrapOffset = m_wrapOffsetUs;
+
+        SimTime t = ReadTimestamp();
+        if (t >= now) {
+            // Not reached yet: put it back
+            m_pos = pos;
+            m_releasedPos = releasedPos;
+            m_wrapOffsetUs = wrapOffset;
+            break;
+        }
+        m_opportunities++;
+    }
+
+    return m_opportunities * m_mtu;
+}
+
+// Get trace period
+SimTime TraceLink::GetPeriodUs() const {
+    return m_periodUs;
+}
+
+// Get number of opportunities consumed or skipped
+uint64_t TraceLink::GetOpportunityCount() const {
+    return m_opportunities;
+}
+
+// Skip opportunities in the past, return the first one at or after now
+SimTime TraceLink::NextOpportunity(SimTime now) {
+    while (true) {
+        SimTime t = ReadTimestamp();
+        m_opportunities++;
+        if (t >= now) {
+            return t;
+        }
+    }
+}
+
+// Parse the next timestamp from the mapped file
+SimTime TraceLink::ReadTimestamp() {
+    while (true) {
+        // Skip separators
+        while (m_pos < m_size && (m_data[m_pos] < '0' || m_data[m_pos] > '9')) {
+            m_pos++;
+        }
+
+        if (m_pos >= m_size) {
+            // Wrap around: the trace repeats every period
+            m_pos = 0;
+            m_releasedPos = 0;
+            m_wrapOffsetUs += m_periodUs;
+            continue;
+        }
+
+        uint64_t ms = 0;
+        while (m_pos < m_size && m_data[m_pos] >= '0' && m_data[m_pos] <= '9') {
+            ms = ms * 10 + static_cast<uint64_t>(m_data[m_pos] - '0');
+            m_pos++;
+        }
+
+        ReleaseConsumedPages();
+        return m_startUs + m_wrapOffsetUs + ms * 1000;
+    }
+}
+
+// Drop consumed pages from our mapping so long traces never stay resident
+void TraceLink::ReleaseConsumedPages() {
+    if (m_pos - m_releasedPos < RELEASE_CHUNK) {
+        return;
+    }
+
+    size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t end = (m_pos / pageSize) * pageSize;
+    if (end > m_releasedPos) {
+        ::madvise(const_cast<char*>(m_data) + m_releasedPos, end - m_releasedPos, MADV_DONTNEED);
+        m_releasedPos = end;
+    }
+}
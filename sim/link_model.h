@@ -0,0 +1,133 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 10:41:18
+@Description: Bottleneck link capacity models (fixed rate and Mahimahi trace replay)
+@Language: C++17
+*/
+
+#ifndef LINK_MODEL_H
+#define LINK_MODEL_H
+
+#include "sim_types.h"
+
+#include <cstddef>
+#include <string>
+
+// Link capacity model: decides when a packet finishes serialization
+class LinkModel {
+public:
+    virtual ~LinkModel() = default;
+
+    /**
+     * @brief Transmit one packet that reaches the head of the queue.
+     *
+     * @param now time the packet starts waiting for the link
+     * @param bytes packet size
+     * @return time the last byte leaves the link
+     */
+    virtual SimTime Transmit(SimTime now, uint32_t bytes) = 0;
+
+    /**
+     * @brief Capacity offered since time 0, used for utilisation.
+     *
+     * @param now current time
+     * @return cumulative bytes the link could have carried, 0 if unknown
+     */
+    virtual uint64_t GetCapacityBytes(SimTime now);
+
+    /**
+     * @brief Nominal rate, reported in INT records.
+     *
+     * @return bits/sec, 0 if the link has no fixed rate
+     */
+    virtual uint64_t GetRateBps() const;
+};
+
+// Constant bit rate link
+class FixedRateLink: public LinkModel {
+public:
+    explicit FixedRateLink(uint64_t rateBps);
+
+    SimTime Transmit(SimTime now, uint32_t bytes) override;
+    uint64_t GetCapacityBytes(SimTime now) override;
+
+    uint64_t GetRateBps() const override;
+    void SetRateBps(uint64_t rateBps, SimTime now = 0);
+
+private:
+    uint64_t m_rateBps;            // Link rate (bits/sec)
+    SimTime m_busyUntil;           // End of the current transmission
+    SimTime m_rateSince;           // When the current rate took effect
+    double m_capacityBefore;       // Capacity (bytes) offered before m_rateSince
+};
+
+/*
+ * Mahimahi-format trace link.
+ *
+ * Each line of the trace holds a millisecond timestamp; every line is one
+ * delivery opportunity of up to MTU bytes. Several lines may share a
+ * timestamp. The trace repeats with a period equal to its last timestamp.
+ *
+ * The file is mmap'ed and parsed incrementally, so multi-hour traces are
+ * streamed from the page cache instead of being loaded into memory.
+ */
+class TraceLink: public LinkModel {
+public:
+    explicit TraceLink(uint32_t mtu = DEFAULT_MTU);
+    ~TraceLink() override;
+
+    /**
+     * @brief Map a trace file.
+     *
+     * @param path Mahimahi trace file
+     * @param startUs simulated time that corresponds to trace time 0
+     * @return false if the file cannot be mapped or holds no opportunity
+     */
+    bool Open(const std::string& path, SimTime startUs = 0);
+    void Close();
+    bool IsOpen() const;
+
+    SimTime Transmit(SimTime now, uint32_t bytes) override;
+
+    // Opportunities up to `now` (consumed or wasted) times MTU
+    uint64_t GetCapacityBytes(SimTime now) override;
+
+    // Trace period in microseconds
+    SimTime GetPeriodUs() const;
+
+    // Delivery opportunities consumed or skipped so far
+    uint64_t GetOpportunityCount() const;
+
+    static constexpr uint32_t DEFAULT_MTU = 1500;
+
+private:
+    TraceLink(const TraceLink&) = delete;
+    TraceLink& operator=(const TraceLink&) = delete;
+
+    // Next opportunity at or after `now`; earlier opportunities are wasted
+    SimTime NextOpportunity(SimTime now);
+
+    // Parse the next timestamp, wrapping to the start of the trace at EOF
+    SimTime ReadTimestamp();
+
+    // Release pages that are already consumed
+    void ReleaseConsumedPages();
+
+    int m_fd;                      // Trace file descriptor
+    const char* m_data;            // Mapped trace
+    size_t m_size;                 // Mapped length
+    size_t m_pos;                  // Parse cursor
+    size_t m_releasedPos;          // Pages below this offset were released
+
+    uint32_t m_mtu;                // Bytes per delivery opportunity
+    SimTime m_startUs;             // Simulated time of trace time 0
+    SimTime m_periodUs;            // Trace period
+    SimTime m_wrapOffsetUs;        // Offset added after each wrap around
+    SimTime m_lastOpportunity;     // Time of the last used opportunity
+    uint32_t m_leftoverBytes;      // Unused bytes of the last opportunity
+    uint64_t m_opportunities;      // Opportunities consumed or skipped
+
+    static constexpr size_t RELEASE_CHUNK = 1 << 20;  // madvise every 1 MB
+};
+
+#endif // LINK_MODEL_H
@@ -0,0 +1,105 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 10:20:05
+@Description: Random and bursty packet loss models implementation
+@Language: C++17
+*/
+
+#include "loss_model.h"
+
+#include <algorithm>
+
+// Bernoulli loss constructor
+BernoulliLoss::BernoulliLoss(double lossRate, uint64_t seed)
+    : m_lossRate(lossRate),
+      m_rng(seed),
+      m_uniform(0.0, 1.0)
+{
+}
+
+// Drop each packet independently with probability m_lossRate
+bool BernoulliLoss::ShouldDrop(const SimPacket& packet) {
+    if (m_lossRate <= 0.0) {
+        return false;
+    }
+    return m_uniform(m_rng) < m_lossRate;
+}
+
+// Gilbert-Elliott loss constructor
+GilbertElliottLoss::GilbertElliottLoss(double pGoodToBad, double pBadToGood,
+                                       double lossGood, double lossBad, uint64_t seed)
+    : m_pGoodToBad(pGoodToBad),
+      m_pBadToGood(pBadToGood),
+      m_lossGood(lossGood),
+      m_lossBad(lossBad),
+      m_bad(false),                 // Channel starts in Good state
+      m_rng(seed),
+      m_uniform(0.0, 1.0)
+{
+}
+
+// Advance the channel state, then draw loss from the state's loss probability
+bool GilbertElliottLoss::ShouldDrop(const SimPacket& packet) {
+    double u = m_uniform(m_rng);
+    if (m_bad) {
+        if (u < m_pBadToGood) {
+            m_bad = false;
+        }
+    } else {
+        if (u < m_pGoodToBad) {
+            m_bad = true;
+        }
+    }
+
+    double lossProb = m_bad ? m_lossBad : m_lossGood;
+    if (lossProb <= 0.0) {
+        return false;
+    }
+    return m_uniform(m_rng) < lossProb;
+}
+
+// Stationary loss rate: pi_bad * lossBad + pi_good * lossGood
+double GilbertElliottLoss::GetAverageLossRate() const {
+    double total = m_pGoodToBad + m_pBadToGood;
+    if (total <= 0.0) {
+        return m_lossGood;
+    }
+    double piBad = m_pGoodToBad / total;
+    return piBad * m_lossBad + (1.0 - piBad) * m_lossGood;
+}
+
+// Check current channel state
+bool GilbertElliottLoss::InBadState() const {
+    return m_bad;
+}
+
+// Token bucket policer constructor
+TokenBucketPolicer::TokenBucketPolicer(uint64_t rateBps, uint32_t bucketBytes)
+    : m_rateBps(rateBps),
+      m_bucketBytes(bucketBytes),
+      m_tokens(bucketBytes),        // Bucket starts full
+      m_lastUs(0),
+      m_drops(0)
+{
+}
+
+// Refill by elapsed time, then spend tokens or drop
+bool TokenBucketPolicer::ShouldDrop(const SimPacket& packet) {
+    if (packet.sent_us > m_lastUs) {
+        m_tokens += static_cast<double>(packet.sent_us - m_lastUs) * m_rateBps / 8e6;
+        m_tokens = std::min(m_tokens, m_bucketBytes);
+        m_lastUs = packet.sent_us;
+    }
+
+    if (m_tokens < packet.size) {
+        m_drops++;
+        return true;
+    }
+    m_tokens -= packet.size;
+    return false;
+}
+
+// Get number of policed packets
+uint64_t TokenBucketPolicer::GetDropCount() const {
+    return m_drops;
+}
@@ -0,0 +1,93 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 10:20:05
+@Description: Random and bursty packet loss models for the simulator
+@Language: C++17
+*/
+
+#ifndef LOSS_MODEL_H
+#define LOSS_MODEL_H
+
+#include "sim_types.h"
+
+#include <random>
+
+// Loss model interface: decides whether a packet leaving the link is lost
+class LossModel {
+public:
+    virtual ~LossModel() = default;
+
+    /**
+     * @brief Decide the fate of the next packet.
+     *
+     * @param packet packet being transmitted
+     * @return true if the packet is lost on the link
+     */
+    virtual bool ShouldDrop(const SimPacket& packet) = 0;
+};
+
+// Independent (Bernoulli) loss with a fixed probability
+class BernoulliLoss: public LossModel {
+public:
+    BernoulliLoss(double lossRate, uint64_t seed = 1);
+
+    bool ShouldDrop(const SimPacket& packet) override;
+
+private:
+    double m_lossRate;                      // Per-packet loss probability
+    std::mt19937_64 m_rng;                  // Random source
+    std::uniform_real_distribution<double> m_uniform;
+};
+
+// Two-state Markov (Gilbert-Elliott) loss for bursty channels
+class GilbertElliottLoss: public LossModel {
+public:
+    /**
+     * @param pGoodToBad transition probability Good -> Bad per packet
+     * @param pBadToGood transition probability Bad -> Good per packet
+     * @param lossGood loss probability while in Good state (1 - k)
+     * @param lossBad loss probability while in Bad state (1 - h)
+     */
+    GilbertElliottLoss(double pGoodToBad, double pBadToGood,
+                       double lossGood = 0.0, double lossBad = 1.0, uint64_t seed = 1);
+
+    bool ShouldDrop(const SimPacket& packet) override;
+
+    // Long-run average loss rate implied by the parameters
+    double GetAverageLossRate() const;
+
+    bool InBadState() const;
+
+private:
+    double m_pGoodToBad;
+    double m_pBadToGood;
+    double m_lossGood;
+    double m_lossBad;
+    bool m_bad;                             // Current channel state
+    std::mt19937_64 m_rng;
+    std::uniform_real_distribution<double> m_uniform;
+};
+
+/*
+ * Token bucket policer, as deployed by carriers to cap a subscriber's rate.
+ * Tokens accrue at `rateBps` up to `bucketBytes`; a packet that finds too
+ * few tokens is dropped. Time is the packet's send time, so the policer
+ * sits in front of the bottleneck whatever order the queue releases in.
+ */
+class TokenBucketPolicer: public LossModel {
+public:
+    TokenBucketPolicer(uint64_t rateBps, uint32_t bucketBytes);
+
+    bool ShouldDrop(const SimPacket& packet) override;
+
+    uint64_t GetDropCount() const;
+
+private:
+    uint64_t m_rateBps;                     // Token rate (bits/sec)
+    double m_bucketBytes;                   // Bucket depth
+    double m_tokens;                        // Available bytes, starts full
+    SimTime m_lastUs;                       // Last refill time
+    uint64_t m_drops;
+};
+
+#endif // LOSS_MODEL_H
@@ -0,0 +1,308 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 14:31:09
+@Description: Streaming fairness, convergence, utilisation and delay metrics implementation
+@Language: C++17
+*/
+
+#include "metrics.h"
+
+#include <algorithm>
+
+// P-square estimator constructor
+P2Quantile::P2Quantile(double quantile)
+    : m_p(quantile),
+      m_count(0)
+{
+    for (int i = 0; i < 5; i++) {
+        m_q[i] = 0.0;
+        m_n[i] = i + 1;
+    }
+    m_np[0] = 1.0;
+    m_np[1] = 1.0 + 2.0 * m_p;
+    m_np[2] = 1.0 + 4.0 * m_p;
+    m_np[3] = 3.0 + 2.0 * m_p;
+    m_np[4] = 5.0;
+    m_dn[0] = 0.0;
+    m_dn[1] = m_p / 2.0;
+    m_dn[2] = m_p;
+    m_dn[3] = (1.0 + m_p) / 2.0;
+    m_dn[4] = 1.0;
+}
+
+// Add a sample
+void P2Quantile::Add(double x) {
+    // The first five samples initialize the markers
+    if (m_count < 5) {
+        m_q[m_count++] = x;
+        if (m_count == 5) {
+            std::sort(m_q, m_q + 5);
+        }
+        return;
+    }
+    m_count++;
+
+    // Find the cell k such that q[k] <= x < q[k+1]
+    int k;
+    if (x < m_q[0]) {
+        m_q[0] = x;
+        k = 0;
+    } else if (x >= m_q[4]) {
+        m_q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (k < 3 && x >= m_q[k + 1]) {
+            k++;
+        }
+    }
+
+    for (int i = k + 1; i < 5; i++) {
+        m_n[i] += 1.0;
+    }
+    for (int i = 0; i < 5; i++) {
+        m_np[i] += m_dn[i];
+    }
+
+    // Adjust the three middle markers
+    for (int i = 1; i <= 3; i++) {
+        double d = m_np[i] - m_n[i];
+        if ((d >= 1.0 && m_n[i + 1] - m_n[i] > 1.0) || (d <= -1.0 && m_n[i - 1] - m_n[i] < -1.0)) {
+            double sign = d > 0 ? 1.0 : -1.0;
+            double q = Parabolic(i, sign);
+            if (m_q[i - 1] < q && q < m_q[i + 1]) {
+                m_q[i] = q;
+            } else {
+                m_q[i] = Linear(i, sign);
+            }
+            m_n[i] += sign;
+        }
+    }
+}
+
+// Get the quantile estimate
+double P2Quantile::Get() const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+
+    if (m_count < 5) {
+        double sorted[5];
+        std::copy(m_q, m_q + m_count, sorted);
+        std::sort(sorted, sorted + m_count);
+        size_t idx = static_cast<size_t>(m_p * (m_count - 1) + 0.5);
+        return sorted[std::min<size_t>(idx, m_count - 1)];
+    }
+
+    return m_q[2];
+}
+
+// Get number of samples
+uint64_t P2Quantile::GetCount() const {
+    return m_count;
+}
+
+// Piecewise-parabolic prediction of marker i moved by d
+double P2Quantile::Parabolic(int i, double d) const {
+    return m_q[i] + d / (m_n[i + 1] - m_n[i - 1]) *
+        ((m_n[i] - m_n[i - 1] + d) * (m_q[i + 1] - m_q[i]) / (m_n[i + 1] - m_n[i]) +
+         (m_n[i + 1] - m_n[i] - d) * (m_q[i] - m_q[i - 1]) / (m_n[i] - m_n[i - 1]));
+}
+
+// Linear prediction of marker i moved by d
+double P2Quantile::Linear(int i, double d) const {
+    int j = i + static_cast<int>(d);
+    return m_q[i] + d * (m_q[j] - m_q[i]) / (m_n[j] - m_n[i]);
+}
+
+// Metrics engine constructor
+MetricsEngine::MetricsEngine(const MetricsConfig& config)
+    : m_config(config),
+      m_ringPos(0),
+      m_activeFlows(0),
+      m_lastJain(1.0),
+      m_jainSum(0.0),
+      m_jainMin(1.0),
+      m_jainWindows(0),
+      m_firstPending(0),
+      m_aboveCount(0),
+      m_aboveSince(0),
+      m_txBytes(0),
+      m_lastTxBytes(0),
+      m_lastCapacity(0),
+      m_utilMin(1.0),
+      m_capacityBytes(0),
+      m_delayP50(0.5),
+      m_delayP99(0.99),
+      m_delayP999(0.999)
+{
+    m_config.window_steps = std::max<uint32_t>(m_config.window_steps, 1);
+    m_config.step_us = std::max<SimTime>(m_config.step_us, 1);
+}
+
+// A flow joined
+void MetricsEngine::OnFlowStart(uint32_t flowId, SimTime now) {
+    FlowWindow& flow = GetFlow(flowId);
+    if (flow.active) {
+        return;
+    }
+
+    flow.active = true;
+    flow.start_us = now;
+    if (flow.ring.empty()) {
+        flow.ring.assign(m_config.window_steps, 0);
+    }
+    m_activeFlows++;
+
+    AddConvergenceEvent(flowId, true, now);
+}
+
+// A flow left
+void MetricsEngine::OnFlowStop(uint32_t flowId, SimTime now) {
+    FlowWindow& flow = GetFlow(flowId);
+    if (!flow.active) {
+        return;
+    }
+
+    flow.active = false;
+    m_activeFlows--;
+
+    AddConvergenceEvent(flowId, false, now);
+}
+
+// Account delivered bytes
+void MetricsEngine::OnDelivered(uint32_t flowId, uint32_t bytes) {
+    GetFlow(flowId).current += bytes;
+}
+
+// Account a bottleneck departure
+void MetricsEngine::OnLinkDeparture(uint32_t bytes, SimTime queueDelayUs) {
+    m_txBytes += bytes;
+
+    double delay = static_cast<double>(queueDelayUs);
+    m_delayP50.Add(delay);
+    m_delayP99.Add(delay);
+    m_delayP999.Add(delay);
+}
+
+// Close one step: rotate the rings, then update fairness and utilisation
+void MetricsEngine::CloseStep(SimTime now, uint64_t capacityBytes) {
+    for (auto& flow : m_flows) {
+        if (flow.ring.empty()) {
+            continue;
+        }
+        flow.window_sum -= flow.ring[m_ringPos];
+        flow.ring[m_ringPos] = flow.current;
+        flow.window_sum += flow.current;
+        flow.current = 0;
+    }
+    m_ringPos = (m_ringPos + 1) % m_config.window_steps;
+
+    // Fairness and convergence
+    double jain = ComputeJain(now);
+    if (jain >= 0.0) {
+        m_lastJain = jain;
+        m_jainSum += jain;
+        m_jainMin = std::min(m_jainMin, jain);
+        m_jainWindows++;
+
+        if (jain >= m_config.convergence_threshold) {
+            if (m_aboveCount == 0) {
+                m_aboveSince = now;
+            }
+            m_aboveCount++;
+
+            if (m_aboveCount >= m_config.convergence_hold) {
+                for (size_t i = m_firstPending; i < m_convergence.size(); i++) {
+                    m_convergence[i].converged_us = m_aboveSince;
+                }
+                m_firstPending = m_convergence.size();
+            }
+        } else {
+            m_aboveCount = 0;
+        }
+    }
+
+    // Utilisation of this step
+    if (capacityBytes > m_lastCapacity) {
+        uint64_t stepCapacity = capacityBytes - m_lastCapacity;
+        uint64_t stepTx = m_txBytes - m_lastTxBytes;
+        double util = std::min(1.0, static_cast<double>(stepTx) / static_cast<double>(stepCapacity));
+        m_utilMin = std::min(m_utilMin, util);
+        m_lastCapacity = capacityBytes;
+        m_capacityBytes = capacityBytes;
+    }
+    m_lastTxBytes = m_txBytes;
+}
+
+// Get step length
+SimTime MetricsEngine::GetStepUs() const {
+    return m_config.step_us;
+}
+
+// Get Jain index of the last closed window
+double MetricsEngine::GetLastJain() const {
+    return m_lastJain;
+}
+
+// Build the summary
+MetricsSummary MetricsEngine::GetSummary() const {
+    MetricsSummary summary;
+    summary.windows = m_jainWindows;
+    summary.jain_mean = m_jainWindows > 0 ? m_jainSum / m_jainWindows : 1.0;
+    summary.jain_min = m_jainMin;
+    summary.utilization = m_capacityBytes > 0
+        ? std::min(1.0, static_cast<double>(m_lastTxBytes) / static_cast<double>(m_capacityBytes))
+        : 0.0;
+    summary.utilization_min = m_capacityBytes > 0 ? m_utilMin : 0.0;
+    summary.queue_delay_p50_us = m_delayP50.Get();
+    summary.queue_delay_p99_us = m_delayP99.Get();
+    summary.queue_delay_p999_us = m_delayP999.Get();
+    summary.queue_delay_samples = m_delayP50.GetCount();
+    return summary;
+}
+
+// Get convergence records
+const std::vector<ConvergenceRecord>& MetricsEngine::GetConvergence() const {
+    return m_convergence;
+}
+
+// Get (creating if needed) the window state of a flow
+MetricsEngine::FlowWindow& MetricsEngine::GetFlow(uint32_t flowId) {
+    if (flowId >= m_flows.size()) {
+        m_flows.resize(flowId + 1, FlowWindow{false, 0, 0, 0, {}});
+    }
+    return m_flows[flowId];
+}
+
+// Record a join/leave and restart the convergence streak
+void MetricsEngine::AddConvergenceEvent(uint32_t flowId, bool join, SimTime now) {
+    m_convergence.push_back(ConvergenceRecord{flowId, join, now, 0});
+    m_aboveCount = 0;
+}
+
+// Jain's index over per-flow rates in the sliding window
+double MetricsEngine::ComputeJain(SimTime now) {
+    SimTime windowUs = m_config.step_us * m_config.window_steps;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    uint32_t n = 0;
+
+    for (const auto& flow : m_flows) {
+        if (!flow.active || now < flow.start_us + m_config.step_us) {
+            continue;
+        }
+
+        // Flows younger than the window are normalized by their own age
+        SimTime duration = std::min(windowUs, now - flow.start_us);
+        double rate = static_cast<double>(flow.window_sum) / static_cast<double>(duration);
+        sum += rate;
+        sumSq += rate * rate;
+        n++;
+    }
+
+    if (n < 2 || sumSq <= 0.0) {
+        return -1.0;
+    }
+    return (sum * sum) / (n * sumSq);
+}
@@ -0,0 +1,154 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 14:31:09
+@Description: Streaming fairness, convergence, utilisation and delay metrics
+@Language: C++17
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "sim_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * P-square streaming quantile estimator (Jain & Chlamtac, 1985).
+ * Five markers, constant memory, no stored samples.
+ */
+class P2Quantile {
+public:
+    explicit P2Quantile(double quantile);
+
+    void Add(double x);
+
+    // Current estimate (exact while fewer than five samples were seen)
+    double Get() const;
+
+    uint64_t GetCount() const;
+
+private:
+    double Parabolic(int i, double d) const;
+    double Linear(int i, double d) const;
+
+    double m_p;                 // Target quantile
+    uint64_t m_count;           // Samples seen
+    double m_q[5];              // Marker heights
+    double m_n[5];              // Marker positions
+    double m_np[5];             // Desired marker positions
+    double m_dn[5];             // Desired position increments
+};
+
+// Convergence measurement for one flow arrival or departure
+struct ConvergenceRecord {
+    uint32_t flow_id;
+    bool join;                  // true = flow joined, false = flow left
+    SimTime event_us;           // time of the arrival/departure
+    SimTime converged_us;       // first time fairness stayed above threshold, 0 if never
+};
+
+// Metrics configuration
+struct MetricsConfig {
+    SimTime step_us;                // window step
+    uint32_t window_steps;          // sliding window length in steps
+    double convergence_threshold;   // Jain index regarded as converged
+    uint32_t convergence_hold;      // consecutive steps above threshold
+
+    MetricsConfig()
+        : step_us(100000), window_steps(10), convergence_threshold(0.95), convergence_hold(3) {}
+};
+
+// Aggregated results
+struct MetricsSummary {
+    uint64_t windows;               // windows with at least two active flows
+    double jain_mean;
+    double jain_min;
+    double utilization;             // transmitted / offered capacity
+    double utilization_min;         // worst step
+    double queue_delay_p50_us;
+    double queue_delay_p99_us;
+    double queue_delay_p999_us;
+    uint64_t queue_delay_samples;
+};
+
+/*
+ * Online metrics engine.
+ *
+ * Per flow it keeps only a ring of `window_steps` byte counters, so memory
+ * is O(flows * window_steps) regardless of run length and no per-packet
+ * records are stored. Fed by the simulator (or a replay driver) through
+ * the On* callbacks and closed step by step with CloseStep().
+ */
+class MetricsEngine {
+public:
+    explicit MetricsEngine(const MetricsConfig& config = MetricsConfig());
+
+    void OnFlowStart(uint32_t flowId, SimTime now);
+    void OnFlowStop(uint32_t flowId, SimTime now);
+
+    // Bytes acknowledged for a flow
+    void OnDelivered(uint32_t flowId, uint32_t bytes);
+
+    // Packet left the bottleneck after waiting `queueDelayUs`
+    void OnLinkDeparture(uint32_t bytes, SimTime queueDelayUs);
+
+    /**
+     * @brief Close the current step.
+     *
+     * @param now end of the step
+     * @param capacityBytes cumulative bytes the link could have carried
+     *        since time 0 (0 if unknown, utilisation is then not reported)
+     */
+    void CloseStep(SimTime now, uint64_t capacityBytes);
+
+    SimTime GetStepUs() const;
+    double GetLastJain() const;
+    MetricsSummary GetSummary() const;
+    const std::vector<ConvergenceRecord>& GetConvergence() const;
+
+private:
+    struct FlowWindow {
+        bool active;
+        SimTime start_us;           // when the flow became active
+        uint64_t current;           // bytes in the open step
+        uint64_t window_sum;        // bytes in the last window_steps closed steps
+        std::vector<uint64_t> ring; // per-step bytes
+    };
+
+    FlowWindow& GetFlow(uint32_t flowId);
+    void AddConvergenceEvent(uint32_t flowId, bool join, SimTime now);
+    double ComputeJain(SimTime now);
+
+    MetricsConfig m_config;
+    std::vector<FlowWindow> m_flows;
+    uint32_t m_ringPos;                 // Ring slot of the open step
+    uint32_t m_activeFlows;
+
+    // Fairness
+    double m_lastJain;
+    double m_jainSum;
+    double m_jainMin;
+    uint64_t m_jainWindows;
+
+    // Convergence
+    std::vector<ConvergenceRecord> m_convergence;
+    size_t m_firstPending;              // Records before this index are resolved
+    uint32_t m_aboveCount;              // Consecutive steps above threshold
+    SimTime m_aboveSince;               // Start of the current streak
+
+    // Utilisation
+    uint64_t m_txBytes;                 // Cumulative bytes transmitted
+    uint64_t m_lastTxBytes;
+    uint64_t m_lastCapacity;
+    double m_utilMin;
+    uint64_t m_capacityBytes;
+
+    // Queueing delay sketches
+    P2Quantile m_delayP50;
+    P2Quantile m_delayP99;
+    P2Quantile m_delayP999;
+};
+
+#endif // METRICS_H
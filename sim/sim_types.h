@@ -0,0 +1,33 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 10:12:40
+@Description: Simulator common types
+@Language: C++17
+*/
+
+#ifndef SIM_TYPES_H
+#define SIM_TYPES_H
+
+#include "../utils/cong.h"
+
+#include <cstdint>
+
+// Simulated time in microseconds (same unit as the RTT passed to PktsAcked)
+using SimTime = uint64_t;
+
+// Data packet travelling through the simulated network
+struct SimPacket {
+    uint32_t flow_id;       // owning flow
+    uint64_t seq;           // per-flow packet sequence number
+    uint32_t size;          // payload bytes
+    SimTime sent_us;        // time the sender transmitted the packet
+    SimTime enqueue_us;     // time the packet entered the bottleneck queue
+    bool ecn_ce;            // congestion experienced mark
+    IntHop int_hop;         // bottleneck INT record, stamped on departure when INT is on
+    bool trimmed;           // payload cut at the bottleneck, only the header arrives
+
+    SimPacket()
+        : flow_id(0), seq(0), size(0), sent_us(0), enqueue_us(0), ecn_ce(false), trimmed(false) {}
+};
+
+#endif // SIM_TYPES_H
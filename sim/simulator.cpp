@@ -0,0 +1,912 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 11:20:33
+@Description: Discrete event dumbbell simulator implementation
+@Language: C++17
+*/
+
+#include "simulator.h"
+
+#include <algorithm>
+
+// Constructor
+Simulator::Simulator(std::unique_ptr<LinkModel> link, uint32_t bufferBytes)
+    : m_link(std::move(link)),
+      m_bufferBytes(bufferBytes),
+      m_ecnThreshold(0),            // ECN marking disabled
+      m_pacing(false),              // Window-limited sending
+      m_ackFrequency(false),        // Receivers use the AckPathConfig policy
+      m_int(false),                 // No in-band telemetry
+      m_txBytes(0),
+      m_queueBytes(0),
+      m_linkBusy(false),
+      m_queueDrops(0),
+      m_trimmedPackets(0),
+      m_metrics(nullptr),
+      m_trajectory(nullptr),
+      m_flowLog(nullptr),
+      m_eventOrder(0),
+      m_now(0)
+{
+}
+
+// Destructor
+Simulator::~Simulator() {
+}
+
+// Set link loss model
+void Simulator::SetLossModel(std::unique_ptr<LossModel> lossModel) {
+    m_lossModel = std::move(lossModel);
+}
+
+// Set ECN marking threshold
+void Simulator::SetEcnThreshold(uint32_t bytes) {
+    m_ecnThreshold = bytes;
+}
+
+// Configure the reverse path
+void Simulator::SetAckPath(AckPathConfig config) {
+    m_ackConfig = std::move(config);
+
+    m_reverseQueue.reset();
+    if (m_ackConfig.reverse_link != nullptr) {
+        m_reverseQueue = std::make_unique<ReverseAckQueue>(
+            std::move(m_ackConfig.reverse_link), m_ackConfig.reverse_buffer_bytes,
+            m_ackConfig.ack_size_bytes, m_ackConfig.thinning, m_ackConfig.thinning_max_merge);
+    }
+
+    m_aggregator.reset();
+    if (m_ackConfig.aggregation) {
+        m_aggregator = std::make_unique<AckAggregator>(
+            m_ackConfig.aggregation_interval_us, m_ackConfig.aggregation_max_burst);
+    }
+}
+
+// Enable sender pacing
+void Simulator::SetPacing(bool enable) {
+    m_pacing = enable;
+}
+
+// Enable receiver ACK frequency hints
+void Simulator::SetAckFrequency(bool enable) {
+    m_ackFrequency = enable;
+}
+
+// Enable INT stamping at the bottleneck
+void Simulator::SetInt(bool enable) {
+    m_int = enable;
+}
+
+// Enable the receiver-driven transport
+void Simulator::SetReceiverDriven(const ReceiverDrivenConfig& config) {
+    m_rdConfig = config;
+    m_grants = std::make_unique<GrantScheduler>(config.overcommit);
+}
+
+// Attach a metrics engine
+void Simulator::AttachMetrics(MetricsEngine* metrics) {
+    m_metrics = metrics;
+    if (m_metrics != nullptr) {
+        Schedule(m_now + m_metrics->GetStepUs(), EventType::METRICS_TICK, 0);
+    }
+}
+
+// Attach a trajectory encoder
+void Simulator::SetTrajectoryEncoder(TrajectoryEncoder* encoder) {
+    m_trajectory = encoder;
+}
+
+// Attach a columnar flow log
+bool Simulator::SetFlowLog(ColumnarWriter* writer) {
+    if (writer != nullptr) {
+        std::vector<ColumnSpec> schema = FlowLogSchema();
+        const std::vector<ColumnSpec>& actual = writer->GetSchema();
+        if (actual.size() != schema.size()) {
+            return false;
+        }
+        for (size_t c = 0; c < schema.size(); c++) {
+            if (actual[c].name != schema[c].name || actual[c].type != schema[c].type) {
+                return false;
+            }
+        }
+    }
+    m_flowLog = writer;
+    return true;
+}
+
+// Flow log columns, in the order RecordFlowState() fills them
+std::vector<ColumnSpec> Simulator::FlowLogSchema() {
+    return {
+        {"time_us", ColumnType::UINT64},
+        {"flow_id", ColumnType::UINT32},
+        {"cwnd", ColumnType::UINT32},
+        {"ssthresh", ColumnType::UINT32},
+        {"rtt_us", ColumnType::UINT32},
+        {"inflight_bytes", ColumnType::UINT64},
+        {"delivered_bytes", ColumnType::UINT64},
+        {"pacing_rate", ColumnType::UINT64},
+    };
+}
+
+// Add a flow
+uint32_t Simulator::AddFlow(SimFlowConfig config) {
+    uint32_t flowId = static_cast<uint32_t>(m_flows.size());
+
+    Flow flow;
+    flow.cc = std::move(config.cc);
+    flow.socket = std::make_unique<SocketState>();
+    flow.socket->histograms_ = config.histograms;
+    flow.start_us = config.start_us;
+    flow.size_bytes = config.size_bytes;
+    flow.base_rtt_us = config.base_rtt_us;
+    flow.mss = config.mss;
+    flow.init_cwnd_segments = config.init_cwnd_segments;
+    flow.active = false;
+    flow.unsent_bytes = config.size_bytes;
+    flow.retx_bytes = 0;
+    flow.inflight_bytes = 0;
+    flow.next_seq = 0;
+    flow.in_recovery = false;
+    flow.recovery_seq = 0;
+    flow.in_cwr = false;
+    flow.cwr_seq = 0;
+    flow.in_loss = false;
+    flow.loss_seq = 0;
+    flow.rto_armed = false;
+    flow.rto_deadline = 0;
+    flow.rto_backoff = 0;
+    flow.next_send_us = 0;
+    flow.pacing_armed = false;
+    flow.burst_bytes = 0;
+    flow.ack_quota = 0;
+    flow.ack_delay_us = 0;
+    flow.grant_registered = false;
+    flow.credit_offset = 0;
+    flow.credit_used = 0;
+    flow.stats.start_us = config.start_us;
+    m_flows.push_back(std::move(flow));
+
+    Schedule(std::max(config.start_us, m_now), EventType::FLOW_START, flowId);
+    return flowId;
+}
+
+// Main event loop
+void Simulator::Run(SimTime untilUs) {
+    while (!m_events.empty() && m_events.top().time <= untilUs) {
+        Event event = m_events.top();
+        m_events.pop();
+        m_now = event.time;
+
+        switch (event.type) {
+            case EventType::FLOW_START:
+                OnFlowStart(event.flow_id);
+                break;
+            case EventType::LINK_DEPARTURE:
+                OnLinkDeparture();
+                break;
+            case EventType::DATA_ARRIVAL:
+                OnDataArrival(event.packet);
+                break;
+            case EventType::ACK_ARRIVAL:
+                OnAckArrival(event.ack);
+                break;
+            case EventType::RTO:
+                OnRto(event.flow_id);
+                break;
+            case EventType::DELACK_TIMER:
+                OnDelackTimer(event.flow_id, event.aux);
+                break;
+            case EventType::REVERSE_DEPARTURE:
+                OnReverseDeparture();
+                break;
+            case EventType::ACK_RELEASE:
+                OnAckRelease();
+                break;
+            case EventType::METRICS_TICK:
+                OnMetricsTick();
+                break;
+            case EventType::PACING_TIMER:
+                OnPacingTimer(event.flow_id);
+                break;
+        }
+    }
+
+    m_now = std::max(m_now, untilUs);
+}
+
+// Get current simulated time
+SimTime Simulator::Now() const {
+    return m_now;
+}
+
+// Get number of flows
+size_t Simulator::GetFlowCount() const {
+    return m_flows.size();
+}
+
+// Get flow statistics
+const SimFlowStats& Simulator::GetFlowStats(uint32_t flowId) const {
+    return m_flows[flowId].stats;
+}
+
+// Get flow socket state
+const SocketState* Simulator::GetSocket(uint32_t flowId) const {
+    return m_flows[flowId].socket.get();
+}
+
+// Get bytes queued at the bottleneck
+uint32_t Simulator::GetQueueBytes() const {
+    return m_queueBytes;
+}
+
+// Get number of drop-tail drops
+uint64_t Simulator::GetQueueDrops() const {
+    return m_queueDrops;
+}
+
+// Get number of trimmed packets
+uint64_t Simulator::GetTrimmedPackets() const {
+    return m_trimmedPackets;
+}
+
+// Get reverse path counters
+const AckPathStats& Simulator::GetAckPathStats() const {
+    return m_ackStats;
+}
+
+// Push an event
+void Simulator::Schedule(SimTime time, EventType type, uint32_t flowId, const SimPacket& packet) {
+    Event event;
+    event.time = time;
+    event.order = m_eventOrder++;
+    event.type = type;
+    event.flow_id = flowId;
+    event.aux = 0;
+    event.packet = packet;
+    m_events.push(event);
+}
+
+// Push an ACK event
+void Simulator::ScheduleAck(SimTime time, EventType type, const SimAck& ack) {
+    Event event;
+    event.time = time;
+    event.order = m_eventOrder++;
+    event.type = type;
+    event.flow_id = ack.flow_id;
+    event.aux = 0;
+    event.ack = ack;
+    m_events.push(event);
+}
+
+// Flow start: initialize the socket and send the initial window
+void Simulator::OnFlowStart(uint32_t flowId) {
+    Flow& flow = m_flows[flowId];
+
+    flow.socket->mss_bytes_ = flow.mss;
+    flow.socket->cwnd_ = flow.init_cwnd_segments * flow.mss;
+    flow.socket->ssthresh_ = 0x7fffffff;
+    flow.active = true;
+
+    // Receiver-driven: the first RTT is sent blind
+    if (m_grants != nullptr) {
+        flow.credit_offset = m_rdConfig.unscheduled_bytes != 0 ? m_rdConfig.unscheduled_bytes : GetBdpBytes(flow);
+    }
+
+    if (m_metrics != nullptr) {
+        m_metrics->OnFlowStart(flowId, m_now);
+    }
+
+    TrySend(flowId);
+}
+
+// Head of the queue leaves the link
+void Simulator::OnLinkDeparture() {
+    if (m_queue.empty()) {
+        m_linkBusy = false;
+        return;
+    }
+
+    SimPacket packet = m_queue.front();
+    m_queue.pop_front();
+    m_queueBytes -= packet.size;
+    m_txBytes += packet.size;
+
+    // HPCC INT: egress state as the packet leaves the switch
+    if (m_int) {
+        packet.int_hop.timestamp_us = m_now;
+        packet.int_hop.tx_bytes = m_txBytes;
+        packet.int_hop.link_rate_bps = m_link->GetRateBps();
+        packet.int_hop.queue_bytes = m_queueBytes;
+    }
+
+    if (m_metrics != nullptr) {
+        m_metrics->OnLinkDeparture(packet.size, m_now - packet.enqueue_us);
+    }
+
+    Flow& flow = m_flows[packet.flow_id];
+    if (m_lossModel != nullptr && m_lossModel->ShouldDrop(packet)) {
+        flow.dropped.insert(packet.seq);
+    } else {
+        Schedule(m_now + flow.base_rtt_us / 2, EventType::DATA_ARRIVAL, packet.flow_id, packet);
+    }
+
+    if (!m_queue.empty()) {
+        StartTransmission();
+    } else {
+        m_linkBusy = false;
+    }
+}
+
+// Receiver: generate ACKs, optionally delayed
+void Simulator::OnDataArrival(const SimPacket& packet) {
+    Flow& flow = m_flows[packet.flow_id];
+    DelayedAckState& delack = flow.delack;
+
+    // Receiver-driven: every packet header carries the message length
+    if (m_grants != nullptr) {
+        if (!flow.grant_registered) {
+            flow.grant_registered = true;
+            uint64_t unscheduled = m_rdConfig.unscheduled_bytes != 0 ? m_rdConfig.unscheduled_bytes : GetBdpBytes(flow);
+            uint64_t window = m_rdConfig.window_bytes != 0 ? m_rdConfig.window_bytes : GetBdpBytes(flow);
+            m_grants->AddMessage(packet.flow_id, flow.size_bytes, unscheduled, window);
+        }
+
+        // Trimmed: NACK the header at once, the payload comes back when granted
+        if (packet.trimmed) {
+            m_grants->OnTrim(packet.flow_id, packet.size);
+            SimAck nack;
+            nack.flow_id = packet.flow_id;
+            nack.cum_seq = packet.seq;
+            nack.nack = true;
+            SendAck(nack);
+            IssueGrants();
+            return;
+        }
+        m_grants->OnData(packet.flow_id, packet.size);
+    }
+
+    // CE state change: acknowledge pending packets at once (RFC 8257 3.2)
+    if (delack.GetPending() > 0 && delack.GetPendingCe() != packet.ecn_ce) {
+        SendAck(delack.Flush(packet.flow_id));
+    }
+
+    delack.Add(packet);
+
+    bool delayed = m_ackConfig.delayed_ack;
+    uint32_t quota = m_ackConfig.ack_quota;
+    SimTime timeout = m_ackConfig.delack_timeout_us;
+    if (m_ackFrequency && flow.ack_quota > 0) {
+        delayed = true;
+        quota = flow.ack_quota;
+        timeout = flow.ack_delay_us;
+    }
+
+    if (!delayed || delack.GetPending() >= quota) {
+        SendAck(delack.Flush(packet.flow_id));
+    } else if (!delack.IsTimerArmed()) {
+        delack.ArmTimer();
+        Event event;
+        event.time = m_now + timeout;
+        event.order = m_eventOrder++;
+        event.type = EventType::DELACK_TIMER;
+        event.flow_id = packet.flow_id;
+        event.aux = delack.GetGeneration();
+        m_events.push(event);
+    }
+
+    if (m_grants != nullptr) {
+        IssueGrants();
+    }
+}
+
+// Delayed ACK timer expired
+void Simulator::OnDelackTimer(uint32_t flowId, uint64_t generation) {
+    DelayedAckState& delack = m_flows[flowId].delack;
+
+    // Stale timer: the pending packets were already acknowledged
+    if (generation != delack.GetGeneration() || delack.GetPending() == 0) {
+        return;
+    }
+
+    SendAck(delack.Flush(flowId));
+}
+
+// Receiver emits an ACK: aggregation point first, then the reverse link
+void Simulator::SendAck(const SimAck& ack) {
+    m_ackStats.acks_generated++;
+
+    if (m_aggregator != nullptr) {
+        SimTime release = m_aggregator->Add(ack, m_now);
+        if (release != 0) {
+            ScheduleAck(release, EventType::ACK_RELEASE, SimAck());
+        }
+        return;
+    }
+
+    ForwardAck(ack);
+}
+
+// Aggregation point releases a burst of ACKs
+void Simulator::OnAckRelease() {
+    std::deque<SimAck> burst;
+    SimTime next = m_aggregator->Release(m_now, burst);
+
+    m_ackStats.max_burst = std::max<uint64_t>(m_ackStats.max_burst, burst.size());
+    for (const auto& ack : burst) {
+        ForwardAck(ack);
+    }
+
+    if (next != 0) {
+        ScheduleAck(next, EventType::ACK_RELEASE, SimAck());
+    }
+}
+
+// Close a metrics step and schedule the next one
+void Simulator::OnMetricsTick() {
+    if (m_metrics == nullptr) {
+        return;
+    }
+
+    m_metrics->CloseStep(m_now, m_link->GetCapacityBytes(m_now));
+    Schedule(m_now + m_metrics->GetStepUs(), EventType::METRICS_TICK, 0);
+}
+
+// Put an ACK on the reverse bottleneck, or straight on the wire
+void Simulator::ForwardAck(const SimAck& ack) {
+    if (m_reverseQueue == nullptr) {
+        DeliverAck(ack);
+        return;
+    }
+
+    if (m_reverseQueue->Enqueue(ack, m_ackStats)) {
+        ScheduleAck(m_reverseQueue->StartTransmission(m_now), EventType::REVERSE_DEPARTURE, SimAck());
+    }
+}
+
+// ACK leaves the reverse bottleneck
+void Simulator::OnReverseDeparture() {
+    DeliverAck(m_reverseQueue->Pop());
+
+    if (!m_reverseQueue->Empty()) {
+        ScheduleAck(m_reverseQueue->StartTransmission(m_now), EventType::REVERSE_DEPARTURE, SimAck());
+    }
+}
+
+// Propagate the ACK back to the sender
+void Simulator::DeliverAck(const SimAck& ack) {
+    const Flow& flow = m_flows[ack.flow_id];
+    ScheduleAck(m_now + flow.base_rtt_us - flow.base_rtt_us / 2, EventType::ACK_ARRIVAL, ack);
+}
+
+// Receiver-driven: send GRANT packets for every raised credit
+void Simulator::IssueGrants() {
+    std::vector<Grant> grants;
+    m_grants->Schedule(grants);
+    for (const auto& grant : grants) {
+        SimAck ack;
+        ack.flow_id = grant.flow_id;
+        ack.grant_offset = grant.offset;
+        SendAck(ack);
+    }
+}
+
+// Receiver-driven: apply a GRANT or NACK at the sender
+void Simulator::OnGrantArrival(Flow& flow, const SimAck& ack) {
+    flow.credit_offset = std::max(flow.credit_offset, ack.grant_offset);
+
+    // The trimmed packet is retransmitted with credit granted for it
+    if (ack.nack) {
+        auto it = flow.outstanding.find(ack.cum_seq);
+        if (it != flow.outstanding.end()) {
+            flow.inflight_bytes -= it->second.size;
+            flow.retx_bytes += it->second.size;
+            flow.socket->lost_bytes_ += it->second.size;
+            flow.stats.lost_packets++;
+            flow.outstanding.erase(it);
+        }
+    }
+}
+
+// One bandwidth-delay product of the flow at the bottleneck rate
+uint64_t Simulator::GetBdpBytes(const Flow& flow) const {
+    uint64_t rate = m_link->GetRateBps();
+    if (rate == 0) {
+        return static_cast<uint64_t>(flow.init_cwnd_segments) * flow.mss;
+    }
+    return std::max<uint64_t>(rate / 8 * flow.base_rtt_us / 1000000, flow.mss);
+}
+
+// Sender: process a cumulative ACK
+void Simulator::OnAckArrival(const SimAck& ack) {
+    Flow& flow = m_flows[ack.flow_id];
+    auto& socket = flow.socket;
+    socket->now_us_ = m_now;
+    m_ackStats.acks_delivered++;
+
+    // GRANT and NACK acknowledge nothing
+    if (ack.segments == 0) {
+        OnGrantArrival(flow, ack);
+        TrySend(ack.flow_id);
+        return;
+    }
+
+    // In a FIFO network any later ACK proves that an earlier drop was a loss
+    DetectLosses(flow, ack.cum_seq);
+
+    // Data declared lost by an RTO that arrived after all
+    while (!flow.rto_lost.empty() && flow.rto_lost.begin()->first <= ack.cum_seq) {
+        auto lost = flow.rto_lost.begin();
+        if (flow.dropped.count(lost->first) == 0 && flow.retx_bytes >= lost->second) {
+            flow.retx_bytes -= lost->second;
+            AccountDelivered(flow, ack.flow_id, lost->second);
+        }
+        flow.rto_lost.erase(lost);
+    }
+
+    // Newly acknowledged packets
+    uint32_t segmentsAcked = 0;
+    SimTime latestSent = 0;
+    while (!flow.outstanding.empty() && flow.outstanding.begin()->first <= ack.cum_seq) {
+        auto it = flow.outstanding.begin();
+        flow.inflight_bytes -= it->second.size;
+        AccountDelivered(flow, ack.flow_id, it->second.size);
+        latestSent = std::max(latestSent, it->second.sent_us);
+        segmentsAcked++;
+        flow.outstanding.erase(it);
+    }
+
+    if (segmentsAcked == 0) {
+        CheckFinished(flow, ack.flow_id);
+        return;
+    }
+    flow.rto_backoff = 0;
+
+    // RTT sample from the most recently sent packet covered by the ACK
+    uint64_t rtt = m_now - latestSent;
+    flow.stats.rtt_samples++;
+    flow.stats.rtt_sum_us += rtt;
+    flow.stats.min_rtt_us = std::min(flow.stats.min_rtt_us, static_cast<uint32_t>(rtt));
+    flow.stats.max_rtt_us = std::max(flow.stats.max_rtt_us, static_cast<uint32_t>(rtt));
+
+    if (ack.int_hop.link_rate_bps != 0) {
+        AckMetadata metadata;
+        metadata.hops[0] = ack.int_hop;
+        metadata.hop_count = 1;
+        flow.cc->OnAckMetadata(socket, metadata);
+    }
+
+    socket->ecn_ce_segments_ = std::min(ack.ce_segments, segmentsAcked);
+    flow.cc->PktsAcked(socket, segmentsAcked, rtt);
+
+    // ECN echo: react at most once per window
+    if (ack.ecn_echo && !flow.in_recovery && !flow.in_cwr) {
+        flow.cc->CwndEvent(socket, CongestionEvent::ECN);
+        flow.in_cwr = true;
+        flow.cwr_seq = flow.next_seq;
+    }
+
+    // Leave loss / recovery / CWR once everything sent before the event is acked
+    if (flow.in_loss && ack.cum_seq >= flow.loss_seq) {
+        flow.in_loss = false;
+        if (!flow.in_recovery) {
+            flow.cc->CongestionStateSet(socket, TCPState::Open);
+        }
+    }
+    if (flow.in_recovery && ack.cum_seq >= flow.recovery_seq) {
+        flow.in_recovery = false;
+        socket->cwnd_ = std::min(socket->cwnd_, socket->ssthresh_);
+        flow.cc->CongestionStateSet(socket, TCPState::Open);
+    }
+    if (flow.in_cwr && ack.cum_seq >= flow.cwr_seq) {
+        flow.in_cwr = false;
+        flow.cc->CongestionStateSet(socket, TCPState::Open);
+    }
+
+    // Window growth only outside recovery (like tcp_may_raise_cwnd)
+    if (!flow.in_recovery) {
+        flow.cc->IncreaseWindow(socket, segmentsAcked);
+    }
+
+    ArmRto(flow, ack.flow_id);
+    // Latest ACK frequency request reaches the receiver with the next data
+    if (m_ackFrequency) {
+        CcDecision decision = flow.cc->GetDecision(socket);
+        flow.ack_quota = decision.ack_ratio;
+        flow.ack_delay_us = decision.max_ack_delay_us;
+    }
+
+    RecordFlowState(flow, ack.flow_id);
+    CheckFinished(flow, ack.flow_id);
+    TrySend(ack.flow_id);
+}
+
+// Retransmission timer
+void Simulator::OnRto(uint32_t flowId) {
+    Flow& flow = m_flows[flowId];
+
+    if (flow.outstanding.empty()) {
+        flow.rto_armed = false;
+        return;
+    }
+
+    // Deadline moved forward since this event was scheduled
+    if (m_now < flow.rto_deadline) {
+        Schedule(flow.rto_deadline, EventType::RTO, flowId);
+        return;
+    }
+
+    flow.rto_armed = false;
+    flow.stats.timeouts++;
+    flow.stats.lost_packets += flow.outstanding.size();
+
+    // Everything outstanding is considered lost; lost data does not consume receiver credit.
+    // Trimmed packets never arrive and already get fresh credit from the receiver's re-grant
+    for (const auto& entry : flow.outstanding) {
+        flow.retx_bytes += entry.second.size;
+        flow.socket->lost_bytes_ += entry.second.size;
+        if (entry.second.trimmed) {
+            continue;
+        }
+        flow.rto_lost[entry.first] = entry.second.size;
+        flow.credit_used -= std::min<uint64_t>(flow.credit_used, entry.second.size);
+    }
+    flow.outstanding.clear();
+    flow.inflight_bytes = 0;
+    flow.in_recovery = false;
+    flow.in_cwr = false;
+    flow.in_loss = true;
+    flow.loss_seq = flow.next_seq;
+    flow.rto_backoff = std::min<uint32_t>(flow.rto_backoff + 1, 8);
+
+    flow.socket->now_us_ = m_now;
+    flow.cc->CwndEvent(flow.socket, CongestionEvent::Timeout);
+    RecordFlowState(flow, flowId);
+    TrySend(flowId);
+}
+
+// Pacing slot reached
+void Simulator::OnPacingTimer(uint32_t flowId) {
+    m_flows[flowId].pacing_armed = false;
+    TrySend(flowId);
+}
+
+// Send as much as cwnd (and the pacing rate) allows
+void Simulator::TrySend(uint32_t flowId) {
+    Flow& flow = m_flows[flowId];
+    if (!flow.active) {
+        return;
+    }
+
+    bool infinite = flow.size_bytes == 0;
+    CcDecision decision;
+    if (m_pacing) {
+        decision = flow.cc->GetDecision(flow.socket);
+    }
+    uint64_t pacingRate = decision.pacing_rate;
+    uint32_t quantum = std::max(decision.send_quantum, flow.mss);
+    while (true) {
+        uint32_t cwnd = flow.socket->cwnd_;
+        if (m_grants != nullptr) {
+            // Receiver-driven: credit, not cwnd, limits sending
+            if (flow.credit_used >= flow.credit_offset) {
+                flow.socket->app_limited_ = false;
+                break;
+            }
+        } else if (flow.inflight_bytes > 0 && flow.inflight_bytes + flow.mss > cwnd) {
+            flow.socket->app_limited_ = false;
+            break;
+        }
+
+        // Paced: wait for the next departure slot
+        if (pacingRate > 0 && m_now < flow.next_send_us) {
+            flow.socket->app_limited_ = false;
+            if (!flow.pacing_armed) {
+                flow.pacing_armed = true;
+                Schedule(flow.next_send_us, EventType::PACING_TIMER, flowId);
+            }
+            break;
+        }
+
+        // Retransmissions first, then new data
+        uint32_t size = 0;
+        if (flow.retx_bytes > 0) {
+            size = static_cast<uint32_t>(std::min<uint64_t>(flow.mss, flow.retx_bytes));
+            flow.retx_bytes -= size;
+        } else if (infinite) {
+            size = flow.mss;
+        } else if (flow.unsent_bytes > 0) {
+            size = static_cast<uint32_t>(std::min<uint64_t>(flow.mss, flow.unsent_bytes));
+            flow.unsent_bytes -= size;
+        }
+        if (size == 0) {
+            // Out of data with cwnd to spare
+            flow.socket->app_limited_ = true;
+            break;
+        }
+
+        SimPacket packet;
+        packet.flow_id = flowId;
+        packet.seq = flow.next_seq++;
+        packet.size = size;
+        packet.sent_us = m_now;
+
+        flow.outstanding[packet.seq] = SentPacket{size, m_now, false};
+        flow.inflight_bytes += size;
+        flow.stats.sent_bytes += size;
+        flow.credit_used += size;
+
+        // A send quantum leaves back to back (one TSO/GSO burst), then waits for its pacing slot
+        if (pacingRate > 0) {
+            if (flow.burst_bytes == 0) {
+                flow.stats.send_bursts++;
+            }
+            flow.burst_bytes += size;
+            if (flow.burst_bytes >= quantum) {
+                flow.next_send_us = std::max(flow.next_send_us, m_now) + flow.burst_bytes * 1000000ULL / pacingRate;
+                flow.burst_bytes = 0;
+            }
+        }
+
+        Enqueue(packet);
+    }
+
+    if (!flow.rto_armed) {
+        ArmRto(flow, flowId);
+    }
+}
+
+// Declare every dropped packet older than the acked one as lost
+void Simulator::DetectLosses(Flow& flow, uint64_t ackedSeq) {
+    bool lost = false;
+    while (!flow.dropped.empty() && *flow.dropped.begin() < ackedSeq) {
+        uint64_t seq = *flow.dropped.begin();
+        flow.dropped.erase(flow.dropped.begin());
+
+        auto it = flow.outstanding.find(seq);
+        if (it == flow.outstanding.end()) {
+            // Already declared lost by an RTO
+            flow.rto_lost.erase(seq);
+            continue;
+        }
+        flow.inflight_bytes -= it->second.size;
+        flow.retx_bytes += it->second.size;
+        flow.socket->lost_bytes_ += it->second.size;
+        flow.credit_used -= std::min<uint64_t>(flow.credit_used, it->second.size);
+        flow.outstanding.erase(it);
+        flow.stats.lost_packets++;
+        lost = true;
+    }
+
+    if (lost && !flow.in_recovery) {
+        EnterRecovery(flow);
+    }
+}
+
+// One multiplicative decrease per window of data
+void Simulator::EnterRecovery(Flow& flow) {
+    flow.in_recovery = true;
+    flow.in_cwr = false;
+    flow.recovery_seq = flow.next_seq;
+
+    flow.cc->CwndEvent(flow.socket, CongestionEvent::PacketLoss);
+
+    // Reduce toward ssthresh like PRR would by the end of recovery
+    flow.socket->cwnd_ = std::max(std::min(flow.socket->cwnd_, flow.socket->ssthresh_), flow.mss);
+}
+
+// (Re)arm the retransmission timer from the latest progress
+void Simulator::ArmRto(Flow& flow, uint32_t flowId) {
+    if (flow.outstanding.empty()) {
+        return;
+    }
+
+    SimTime rto = std::max<SimTime>(flow.socket->rto_us_, MIN_RTO_US);
+    rto = std::min<SimTime>(rto << flow.rto_backoff, MAX_RTO_US);
+    flow.rto_deadline = m_now + rto;
+
+    if (!flow.rto_armed) {
+        flow.rto_armed = true;
+        Schedule(flow.rto_deadline, EventType::RTO, flowId);
+    }
+}
+
+// Count acknowledged bytes
+void Simulator::AccountDelivered(Flow& flow, uint32_t flowId, uint32_t bytes) {
+    flow.stats.delivered_bytes += bytes;
+    if (m_metrics != nullptr) {
+        m_metrics->OnDelivered(flowId, bytes);
+    }
+}
+
+// Mark a finite flow complete once all its bytes are acknowledged
+void Simulator::CheckFinished(Flow& flow, uint32_t flowId) {
+    if (flow.size_bytes == 0 || flow.stats.finished) {
+        return;
+    }
+
+    if (flow.stats.delivered_bytes >= flow.size_bytes) {
+        flow.stats.finished = true;
+        flow.stats.finish_us = m_now;
+        flow.active = false;
+
+        if (m_metrics != nullptr) {
+            m_metrics->OnFlowStop(flowId, m_now);
+        }
+        if (m_trajectory != nullptr) {
+            m_trajectory->CloseFlow(flowId);
+        }
+    }
+}
+
+// Append the flow's current state to the trajectory and the flow log
+void Simulator::RecordFlowState(const Flow& flow, uint32_t flowId) {
+    if (m_trajectory == nullptr && m_flowLog == nullptr) {
+        return;
+    }
+
+    TrajectorySample sample;
+    sample.time_us = m_now;
+    sample.cwnd = flow.socket->cwnd_;
+    sample.ssthresh = flow.socket->ssthresh_;
+    sample.rtt_us = flow.socket->rtt_us_;
+
+    // Pacing rate and mode as the algorithm reports them, through any wrapper
+    CcDecision decision = flow.cc->GetDecision(flow.socket);
+    sample.pacing_rate = decision.pacing_rate;
+    sample.mode = decision.mode;
+
+    if (m_trajectory != nullptr) {
+        m_trajectory->Append(flowId, sample);
+    }
+
+    if (m_flowLog != nullptr) {
+        m_flowLog->SetUInt64(0, m_now);
+        m_flowLog->SetUInt32(1, flowId);
+        m_flowLog->SetUInt32(2, sample.cwnd);
+        m_flowLog->SetUInt32(3, sample.ssthresh);
+        m_flowLog->SetUInt32(4, sample.rtt_us);
+        m_flowLog->SetUInt64(5, flow.inflight_bytes);
+        m_flowLog->SetUInt64(6, flow.stats.delivered_bytes);
+        m_flowLog->SetUInt64(7, sample.pacing_rate);
+        m_flowLog->EndRow();
+    }
+}
+
+// Drop-tail enqueue with optional CE marking
+void Simulator::Enqueue(SimPacket packet) {
+    if (m_queueBytes + packet.size > m_bufferBytes) {
+        // NDP trimming: the header goes on at high priority
+        if (m_grants != nullptr && m_rdConfig.trimming) {
+            m_trimmedPackets++;
+            packet.trimmed = true;
+            auto sent = m_flows[packet.flow_id].outstanding.find(packet.seq);
+            if (sent != m_flows[packet.flow_id].outstanding.end()) {
+                sent->second.trimmed = true;
+            }
+            Schedule(m_now + m_flows[packet.flow_id].base_rtt_us / 2, EventType::DATA_ARRIVAL, packet.flow_id, packet);
+            return;
+        }
+        m_queueDrops++;
+        m_flows[packet.flow_id].dropped.insert(packet.seq);
+        return;
+    }
+
+    if (m_ecnThreshold > 0 && m_queueBytes >= m_ecnThreshold) {
+        packet.ecn_ce = true;
+    }
+
+    packet.enqueue_us = m_now;
+    m_queue.push_back(packet);
+    m_queueBytes += packet.size;
+
+    if (!m_linkBusy) {
+        StartTransmission();
+    }
+}
+
+// Start serializing the head of the queue
+void Simulator::StartTransmission() {
+    m_linkBusy = true;
+    SimTime done = m_link->Transmit(m_now, m_queue.front().size);
+    Schedule(done, EventType::LINK_DEPARTURE, 0);
+}
@@ -0,0 +1,300 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 11:20:33
+@Description: Discrete event dumbbell simulator for congestion control algorithms
+@Language: C++17
+*/
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "../utils/cong.h"
+#include "sim_types.h"
+#include "link_model.h"
+#include "loss_model.h"
+#include "ack_path.h"
+#include "grant_scheduler.h"
+#include "metrics.h"
+#include "columnar.h"
+#include "../utils/trajectory.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <vector>
+
+// Flow parameters
+struct SimFlowConfig {
+    std::unique_ptr<CongestionControl> cc;  // algorithm driving the flow
+    SimTime start_us;                       // flow start time
+    uint64_t size_bytes;                    // bytes to transfer, 0 = infinite backlog
+    uint32_t base_rtt_us;                   // two-way propagation delay
+    uint32_t mss;                           // segment size
+    uint32_t init_cwnd_segments;            // initial window
+    FlowHistograms* histograms;             // optional RTT/cwnd histograms (not owned)
+
+    SimFlowConfig()
+        : start_us(0), size_bytes(0), base_rtt_us(20000), mss(1460), init_cwnd_segments(10),
+          histograms(nullptr) {}
+};
+
+// Per-flow counters collected by the simulator
+struct SimFlowStats {
+    uint64_t sent_bytes;            // bytes handed to the network (incl. retransmissions)
+    uint64_t delivered_bytes;       // bytes acknowledged (each byte counted once)
+    uint64_t lost_packets;          // packets declared lost
+    uint64_t timeouts;              // retransmission timeouts
+    uint64_t send_bursts;           // paced transmissions, one per send quantum (0 without pacing)
+    uint64_t rtt_samples;
+    uint64_t rtt_sum_us;
+    uint32_t min_rtt_us;
+    uint32_t max_rtt_us;
+    SimTime start_us;
+    SimTime finish_us;              // completion time of a finite flow
+    bool finished;
+
+    SimFlowStats()
+        : sent_bytes(0), delivered_bytes(0), lost_packets(0), timeouts(0), send_bursts(0),
+          rtt_samples(0), rtt_sum_us(0), min_rtt_us(0xFFFFFFFF), max_rtt_us(0),
+          start_us(0), finish_us(0), finished(false) {}
+};
+
+/*
+ * Single-bottleneck simulator.
+ *
+ * Senders -> drop-tail (optionally ECN-marking) queue -> LinkModel ->
+ * receiver -> ACK path -> sender. Each flow has its own propagation
+ * delay. ACKs are cumulative, so delayed, thinned or aggregated ACKs
+ * reach the algorithm as stretch ACKs (segmentsAcked > 1).
+ *
+ * The simulator plays the role of the TCP stack: it calls
+ * PktsAcked/IncreaseWindow on every ACK, CwndEvent on loss, ECN and RTO,
+ * and CongestionStateSet(Open) when recovery completes. The receiver
+ * echoes how many covered packets were CE marked, and the sender puts
+ * the count in SocketState::ecn_ce_segments_ before PktsAcked(). With
+ * SetInt() the bottleneck acts as one INT switch and each ACK's record
+ * reaches OnAckMetadata() before PktsAcked().
+ *
+ * With SetReceiverDriven() the receiver schedules senders instead: each
+ * flow sends its unscheduled bytes, then only what GRANT packets allow,
+ * and packets that overflow the buffer are trimmed to headers that the
+ * receiver NACKs. The algorithms still see every ACK, but cwnd no longer
+ * limits sending.
+ *
+ * Every ACK and loss event carries SimTime in SocketState::now_us_, and
+ * the algorithms run their timers (BBR gain cycling, the CUBIC epoch,
+ * Copa and Vegas RTT windows) on it, so a run is deterministic.
+ */
+class Simulator {
+public:
+    Simulator(std::unique_ptr<LinkModel> link, uint32_t bufferBytes);
+    ~Simulator();
+
+    // Random loss on the link (applied after serialization)
+    void SetLossModel(std::unique_ptr<LossModel> lossModel);
+
+    // Mark CE when the queue holds at least `bytes` (0 disables marking)
+    void SetEcnThreshold(uint32_t bytes);
+
+    // Reverse path impairments (default: one immediate ACK per packet)
+    void SetAckPath(AckPathConfig config);
+
+    // Pace every flow at its algorithm's CcDecision rate (window-based ones at cwnd/RTT x 1.2); off by default
+    void SetPacing(bool enable);
+
+    // Receivers follow each sender's CcDecision ACK ratio and max ACK delay,
+    // as if sent in an ACK_FREQUENCY frame; off by default
+    void SetAckFrequency(bool enable);
+
+    // Stamp an INT record (queue, tx bytes, time, rate) on every packet leaving the
+    // bottleneck and hand the echoed record to OnAckMetadata(); off by default.
+    // Links without a nominal rate (traces) stamp nothing
+    void SetInt(bool enable);
+
+    // Receiver-driven transport (Homa/NDP style) for every flow; call before Run()
+    void SetReceiverDriven(const ReceiverDrivenConfig& config);
+
+    // Feed an online metrics engine (not owned), closing a step every GetStepUs()
+    void AttachMetrics(MetricsEngine* metrics);
+
+    // Record every flow's cwnd/RTT/pacing after each ACK and RTO (not owned)
+    void SetTrajectoryEncoder(TrajectoryEncoder* encoder);
+
+    // Log one row per ACK and RTO to a writer opened with FlowLogSchema() (not owned)
+    bool SetFlowLog(ColumnarWriter* writer);
+
+    // Columns of the flow log
+    static std::vector<ColumnSpec> FlowLogSchema();
+
+    // Add a flow, returns its id
+    uint32_t AddFlow(SimFlowConfig config);
+
+    // Process events up to (and including) `untilUs`
+    void Run(SimTime untilUs);
+
+    SimTime Now() const;
+    size_t GetFlowCount() const;
+    const SimFlowStats& GetFlowStats(uint32_t flowId) const;
+    const SocketState* GetSocket(uint32_t flowId) const;
+    uint32_t GetQueueBytes() const;
+    uint64_t GetQueueDrops() const;
+    uint64_t GetTrimmedPackets() const;
+    const AckPathStats& GetAckPathStats() const;
+
+private:
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
+
+    enum class EventType {
+        FLOW_START,         // flow begins sending
+        LINK_DEPARTURE,     // head of queue finished serialization
+        DATA_ARRIVAL,       // data packet reached the receiver
+        ACK_ARRIVAL,        // ACK reached the sender
+        RTO,                // retransmission timer check
+        DELACK_TIMER,       // receiver delayed ACK timer
+        REVERSE_DEPARTURE,  // ACK finished serialization on the reverse link
+        ACK_RELEASE,        // aggregation point releases a burst
+        METRICS_TICK,       // close a metrics step
+        PACING_TIMER        // paced flow may send again
+    };
+
+    struct Event {
+        SimTime time;
+        uint64_t order;     // insertion order, keeps same-time events FIFO
+        EventType type;
+        uint32_t flow_id;
+        uint64_t aux;       // event specific (delayed ACK timer generation)
+        SimPacket packet;
+        SimAck ack;
+
+        bool operator>(const Event& other) const {
+            return time != other.time ? time > other.time : order > other.order;
+        }
+    };
+
+    struct SentPacket {
+        uint32_t size;
+        SimTime sent_us;
+        bool trimmed;               // cut to its header; the receiver re-grants its credit
+    };
+
+    struct Flow {
+        std::unique_ptr<CongestionControl> cc;
+        std::unique_ptr<SocketState> socket;
+        SimTime start_us;
+        uint64_t size_bytes;
+        uint32_t base_rtt_us;
+        uint32_t mss;
+        uint32_t init_cwnd_segments;
+
+        bool active;
+        uint64_t unsent_bytes;                      // new data not yet sent
+        uint64_t retx_bytes;                        // lost data waiting for retransmission
+        uint64_t inflight_bytes;
+        uint64_t next_seq;
+        std::map<uint64_t, SentPacket> outstanding; // unacknowledged packets by seq
+        std::map<uint64_t, uint32_t> rto_lost;      // declared lost by RTO, may still arrive
+        std::set<uint64_t> dropped;                 // dropped but not yet detected
+
+        bool in_recovery;
+        uint64_t recovery_seq;                      // recovery ends when this seq is acked
+        bool in_cwr;
+        uint64_t cwr_seq;
+        bool in_loss;
+        uint64_t loss_seq;                          // RTO loss state ends when this seq is acked (high_seq)
+
+        bool rto_armed;
+        SimTime rto_deadline;
+        uint32_t rto_backoff;
+
+        SimTime next_send_us;                       // pacing: earliest next transmission
+        bool pacing_armed;
+        uint32_t burst_bytes;                       // pacing: bytes sent in the current send quantum
+
+        DelayedAckState delack;                     // receiver side
+        uint32_t ack_quota;                         // ACK ratio requested by the sender, 0 = none
+        SimTime ack_delay_us;                       // max ACK delay requested by the sender
+        bool grant_registered;                      // receiver side: message known to the grant scheduler
+
+        uint64_t credit_offset;                     // receiver-driven: bytes the sender may have transmitted
+        uint64_t credit_used;                       // receiver-driven: bytes transmitted, minus detected losses
+
+        SimFlowStats stats;
+    };
+
+    void Schedule(SimTime time, EventType type, uint32_t flowId, const SimPacket& packet = SimPacket());
+    void ScheduleAck(SimTime time, EventType type, const SimAck& ack);
+
+    // Event handlers
+    void OnFlowStart(uint32_t flowId);
+    void OnLinkDeparture();
+    void OnDataArrival(const SimPacket& packet);
+    void OnAckArrival(const SimAck& ack);
+    void OnRto(uint32_t flowId);
+    void OnDelackTimer(uint32_t flowId, uint64_t generation);
+    void OnReverseDeparture();
+    void OnAckRelease();
+    void OnMetricsTick();
+    void OnPacingTimer(uint32_t flowId);
+
+    // ACK path helpers
+    void SendAck(const SimAck& ack);
+    void ForwardAck(const SimAck& ack);
+    void DeliverAck(const SimAck& ack);
+
+    // Receiver-driven helpers
+    void OnGrantArrival(Flow& flow, const SimAck& ack);
+    void IssueGrants();
+    uint64_t GetBdpBytes(const Flow& flow) const;
+
+    // Sender helpers
+    void TrySend(uint32_t flowId);
+    void DetectLosses(Flow& flow, uint64_t ackedSeq);
+    void EnterRecovery(Flow& flow);
+    void ArmRto(Flow& flow, uint32_t flowId);
+    void AccountDelivered(Flow& flow, uint32_t flowId, uint32_t bytes);
+    void CheckFinished(Flow& flow, uint32_t flowId);
+    void RecordFlowState(const Flow& flow, uint32_t flowId);
+
+    // Bottleneck helpers
+    void Enqueue(SimPacket packet);
+    void StartTransmission();
+
+    std::unique_ptr<LinkModel> m_link;      // Bottleneck capacity model
+    std::unique_ptr<LossModel> m_lossModel; // Optional random loss
+    uint32_t m_bufferBytes;                 // Drop-tail buffer size
+    uint32_t m_ecnThreshold;                // CE marking threshold (bytes)
+    bool m_pacing;                          // Honour algorithm pacing rates
+    bool m_ackFrequency;                    // Honour algorithm ACK frequency hints
+    bool m_int;                             // Stamp INT records at the bottleneck
+    uint64_t m_txBytes;                     // Bytes sent by the bottleneck so far
+    ReceiverDrivenConfig m_rdConfig;        // Receiver-driven mode parameters
+    std::unique_ptr<GrantScheduler> m_grants;  // Receiver-driven mode, nullptr = sender-driven
+
+    std::deque<SimPacket> m_queue;          // Bottleneck queue
+    uint32_t m_queueBytes;                  // Bytes in queue
+    bool m_linkBusy;                        // A packet is being serialized
+    uint64_t m_queueDrops;                  // Drop-tail drops
+    uint64_t m_trimmedPackets;              // Packets trimmed to their header
+
+    AckPathConfig m_ackConfig;              // Reverse path impairments
+    std::unique_ptr<ReverseAckQueue> m_reverseQueue;
+    std::unique_ptr<AckAggregator> m_aggregator;
+    AckPathStats m_ackStats;
+
+    MetricsEngine* m_metrics;               // Optional metrics sink
+    TrajectoryEncoder* m_trajectory;        // Optional trajectory sink
+    ColumnarWriter* m_flowLog;              // Optional per-ACK flow log
+
+    std::vector<Flow> m_flows;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+    uint64_t m_eventOrder;
+    SimTime m_now;
+
+    static constexpr SimTime MIN_RTO_US = 200000;       // 200ms (Linux TCP_RTO_MIN)
+    static constexpr SimTime MAX_RTO_US = 60000000;     // 60s
+};
+
+#endif // SIMULATOR_H
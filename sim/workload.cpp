@@ -0,0 +1,283 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 15:02:47
+@Description: Flow-level workload generation and flow completion time reporting implementation
+@Language: C++17
+*/
+
+#include "workload.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// Flow size CDF constructor
+FlowSizeCdf::FlowSizeCdf() {
+}
+
+// Parse "<size> <cdf>" lines
+bool FlowSizeCdf::Load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    m_points.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        double size = 0.0;
+        double cdf = 0.0;
+        if (!(fields >> size >> cdf) || size < 0.0 || !AddPoint(static_cast<uint64_t>(size), cdf)) {
+            m_points.clear();
+            return false;
+        }
+    }
+
+    return !m_points.empty() && m_points.back().cdf > 0.0;
+}
+
+// Append a point, keeping the CDF monotonic
+bool FlowSizeCdf::AddPoint(uint64_t sizeBytes, double cdf) {
+    if (cdf < 0.0) {
+        return false;
+    }
+    if (!m_points.empty() && (sizeBytes < m_points.back().size || cdf < m_points.back().cdf)) {
+        return false;
+    }
+
+    m_points.push_back(Point{sizeBytes, cdf});
+    return true;
+}
+
+// Check if the CDF has points
+bool FlowSizeCdf::Empty() const {
+    return m_points.empty();
+}
+
+// Inverse transform; the last point defines 100% (fraction or percent)
+uint64_t FlowSizeCdf::Sample(std::mt19937_64& rng) const {
+    if (m_points.empty()) {
+        return 0;
+    }
+
+    std::uniform_real_distribution<double> uniform(0.0, m_points.back().cdf);
+    double u = uniform(rng);
+
+    if (u <= m_points.front().cdf) {
+        return std::max<uint64_t>(m_points.front().size, 1);
+    }
+
+    for (size_t i = 1; i < m_points.size(); i++) {
+        const Point& lo = m_points[i - 1];
+        const Point& hi = m_points[i];
+        if (u > hi.cdf) {
+            continue;
+        }
+        if (hi.cdf <= lo.cdf) {
+            return std::max<uint64_t>(hi.size, 1);
+        }
+        double frac = (u - lo.cdf) / (hi.cdf - lo.cdf);
+        double size = lo.size + frac * static_cast<double>(hi.size - lo.size);
+        return std::max<uint64_t>(static_cast<uint64_t>(size + 0.5), 1);
+    }
+
+    return std::max<uint64_t>(m_points.back().size, 1);
+}
+
+// Mean of the piecewise linear distribution
+double FlowSizeCdf::GetMeanBytes() const {
+    if (m_points.empty() || m_points.back().cdf <= 0.0) {
+        return 0.0;
+    }
+
+    double mean = m_points.front().cdf * static_cast<double>(m_points.front().size);
+    for (size_t i = 1; i < m_points.size(); i++) {
+        double mass = m_points[i].cdf - m_points[i - 1].cdf;
+        mean += mass * (static_cast<double>(m_points[i].size) + static_cast<double>(m_points[i - 1].size)) / 2.0;
+    }
+    return mean / m_points.back().cdf;
+}
+
+// Workload generator constructor
+WorkloadGenerator::WorkloadGenerator(uint64_t seed)
+    : m_rng(seed)
+{
+}
+
+// Arrival rate = load * rate / mean size, exponential inter-arrival times
+size_t WorkloadGenerator::AddPoisson(const FlowSizeCdf& cdf, double load, uint64_t linkRateBps,
+                                     SimTime startUs, SimTime durationUs, uint32_t hosts) {
+    double meanBytes = cdf.GetMeanBytes();
+    if (meanBytes <= 0.0 || load <= 0.0 || linkRateBps == 0) {
+        return 0;
+    }
+
+    // Flows per microsecond
+    double lambda = load * static_cast<double>(linkRateBps) / 8.0 / meanBytes / 1000000.0;
+    std::exponential_distribution<double> interArrival(lambda);
+    std::uniform_int_distribution<uint32_t> pickHost(0, std::max<uint32_t>(hosts, 1) - 1);
+
+    size_t added = 0;
+    double t = static_cast<double>(startUs) + interArrival(m_rng);
+    SimTime endUs = startUs + durationUs;
+    while (t < static_cast<double>(endUs)) {
+        WorkloadFlow flow;
+        flow.src = pickHost(m_rng);
+        flow.dst = hosts;               // the receiver behind the bottleneck
+        flow.start_us = static_cast<SimTime>(t);
+        flow.size_bytes = cdf.Sample(m_rng);
+        m_flows.push_back(flow);
+        added++;
+
+        t += interArrival(m_rng);
+    }
+
+    return added;
+}
+
+// All senders target host `fanIn` at about the same time
+size_t WorkloadGenerator::AddIncast(uint32_t fanIn, uint64_t bytesPerSender, SimTime timeUs, SimTime jitterUs) {
+    for (uint32_t i = 0; i < fanIn; i++) {
+        m_flows.push_back(WorkloadFlow{i, fanIn, timeUs + Jitter(jitterUs), bytesPerSender});
+    }
+    return fanIn;
+}
+
+// hosts * (hosts - 1) flows
+size_t WorkloadGenerator::AddAllPairs(uint32_t hosts, uint64_t bytesPerPair, SimTime timeUs, SimTime jitterUs) {
+    size_t added = 0;
+    for (uint32_t src = 0; src < hosts; src++) {
+        for (uint32_t dst = 0; dst < hosts; dst++) {
+            if (src == dst) {
+                continue;
+            }
+            m_flows.push_back(WorkloadFlow{src, dst, timeUs + Jitter(jitterUs), bytesPerPair});
+            added++;
+        }
+    }
+    return added;
+}
+
+// Get generated flows
+const std::vector<WorkloadFlow>& WorkloadGenerator::GetFlows() const {
+    return m_flows;
+}
+
+// Remove all flows
+void WorkloadGenerator::Clear() {
+    m_flows.clear();
+}
+
+// Create one simulator flow per workload flow
+std::vector<uint32_t> WorkloadGenerator::Install(Simulator& sim,
+                                                 const std::function<std::unique_ptr<CongestionControl>()>& factory,
+                                                 uint32_t baseRttUs) const {
+    std::vector<uint32_t> ids;
+    ids.reserve(m_flows.size());
+
+    for (const auto& flow : m_flows) {
+        SimFlowConfig config;
+        config.cc = factory();
+        config.start_us = flow.start_us;
+        config.size_bytes = flow.size_bytes;
+        config.base_rtt_us = baseRttUs;
+        ids.push_back(sim.AddFlow(std::move(config)));
+    }
+
+    return ids;
+}
+
+// Uniform start offset in [0, jitterUs]
+SimTime WorkloadGenerator::Jitter(SimTime jitterUs) {
+    if (jitterUs == 0) {
+        return 0;
+    }
+    std::uniform_int_distribution<SimTime> offset(0, jitterUs);
+    return offset(m_rng);
+}
+
+// FCT report constructor
+FctReport::FctReport(uint64_t linkRateBps, const std::vector<uint64_t>& bucketEdges)
+    : m_linkRateBps(linkRateBps)
+{
+    std::vector<uint64_t> edges = bucketEdges;
+    std::sort(edges.begin(), edges.end());
+    edges.push_back(UINT64_MAX);        // open last bucket
+
+    for (uint64_t edge : edges) {
+        m_buckets.push_back(Bucket{edge, 0, 0, 0.0, 0.0, P2Quantile(0.5), P2Quantile(0.99)});
+    }
+}
+
+// Record a completed flow
+void FctReport::AddFlow(uint64_t sizeBytes, SimTime fctUs, uint32_t baseRttUs) {
+    double idealUs = static_cast<double>(baseRttUs);
+    if (m_linkRateBps > 0) {
+        idealUs += static_cast<double>(sizeBytes) * 8.0 * 1000000.0 / static_cast<double>(m_linkRateBps);
+    }
+    double slowdown = idealUs > 0.0 ? static_cast<double>(fctUs) / idealUs : 1.0;
+
+    Bucket& bucket = FindBucket(sizeBytes);
+    bucket.flows++;
+    bucket.fct_sum += static_cast<double>(fctUs);
+    bucket.slowdown_sum += slowdown;
+    bucket.p50.Add(slowdown);
+    bucket.p99.Add(slowdown);
+}
+
+// Record a flow that did not complete
+void FctReport::AddUnfinished(uint64_t sizeBytes) {
+    FindBucket(sizeBytes).unfinished++;
+}
+
+// Read completion times from the simulator
+void FctReport::Collect(const Simulator& sim, const std::vector<uint32_t>& flowIds,
+                        const std::vector<WorkloadFlow>& flows, uint32_t baseRttUs) {
+    size_t count = std::min(flowIds.size(), flows.size());
+    for (size_t i = 0; i < count; i++) {
+        const SimFlowStats& stats = sim.GetFlowStats(flowIds[i]);
+        if (stats.finished) {
+            AddFlow(flows[i].size_bytes, stats.finish_us - stats.start_us, baseRttUs);
+        } else {
+            AddUnfinished(flows[i].size_bytes);
+        }
+    }
+}
+
+// Summarize every bucket
+std::vector<FctBucket> FctReport::GetBuckets() const {
+    std::vector<FctBucket> result;
+    for (const auto& bucket : m_buckets) {
+        FctBucket out;
+        out.max_bytes = bucket.max_bytes;
+        out.flows = bucket.flows;
+        out.unfinished = bucket.unfinished;
+        out.mean_fct_us = bucket.flows > 0 ? bucket.fct_sum / bucket.flows : 0.0;
+        out.mean_slowdown = bucket.flows > 0 ? bucket.slowdown_sum / bucket.flows : 0.0;
+        out.slowdown_p50 = bucket.p50.Get();
+        out.slowdown_p99 = bucket.p99.Get();
+        result.push_back(out);
+    }
+    return result;
+}
+
+// Default size buckets
+std::vector<uint64_t> FctReport::DefaultBuckets() {
+    return {10000, 100000, 1000000, 10000000};
+}
+
+// First bucket whose bound covers the size
+FctReport::Bucket& FctReport::FindBucket(uint64_t sizeBytes) {
+    for (auto& bucket : m_buckets) {
+        if (sizeBytes <= bucket.max_bytes) {
+            return bucket;
+        }
+    }
+    return m_buckets.back();
+}
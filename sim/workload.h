@@ -0,0 +1,181 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 15:02:47
+@Description: Flow-level workload generation and flow completion time reporting
+@Language: C++17
+*/
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "simulator.h"
+#include "metrics.h"
+
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Empirical flow size distribution.
+ *
+ * File format: one "<size_bytes> <cdf>" pair per line, sizes increasing,
+ * cdf in [0, 1] or in percent [0, 100]. Lines starting with '#' are
+ * ignored. Sizes between two points are interpolated linearly, as in the
+ * pFabric/HPCC traffic generators.
+ */
+class FlowSizeCdf {
+public:
+    FlowSizeCdf();
+
+    // Load from file, false if the file is missing or malformed
+    bool Load(const std::string& path);
+
+    // Add a point directly (sizes and cdf must be non-decreasing)
+    bool AddPoint(uint64_t sizeBytes, double cdf);
+
+    bool Empty() const;
+
+    // Draw a flow size by inverse transform sampling
+    uint64_t Sample(std::mt19937_64& rng) const;
+
+    // Mean flow size implied by the piecewise linear CDF
+    double GetMeanBytes() const;
+
+private:
+    struct Point {
+        uint64_t size;
+        double cdf;
+    };
+
+    std::vector<Point> m_points;
+};
+
+// One flow of a workload
+struct WorkloadFlow {
+    uint32_t src;               // sending host
+    uint32_t dst;               // receiving host
+    SimTime start_us;
+    uint64_t size_bytes;
+};
+
+/*
+ * Workload generator.
+ *
+ * Patterns are appended to one flow list, so Poisson background traffic,
+ * incast bursts and all-pairs bursts can be mixed. Host ids only label the
+ * flows: the dumbbell simulator has a single bottleneck, so every flow
+ * shares it.
+ */
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(uint64_t seed = 1);
+
+    /**
+     * @brief Poisson flow arrivals with sizes drawn from a CDF.
+     *
+     * @param cdf flow size distribution
+     * @param load target offered load as a fraction of the link rate
+     * @param linkRateBps bottleneck rate used to derive the arrival rate
+     * @param startUs first possible arrival
+     * @param durationUs length of the arrival period
+     * @param hosts senders are picked uniformly among `hosts` hosts
+     * @return number of flows generated
+     */
+    size_t AddPoisson(const FlowSizeCdf& cdf, double load, uint64_t linkRateBps,
+                      SimTime startUs, SimTime durationUs, uint32_t hosts = 1);
+
+    // N-to-1 incast: `fanIn` senders start within `jitterUs` of `timeUs`
+    size_t AddIncast(uint32_t fanIn, uint64_t bytesPerSender, SimTime timeUs, SimTime jitterUs = 0);
+
+    /**
+     * @brief One flow between every ordered pair of `hosts` hosts, all starting together.
+     *
+     * The flows carry a shuffle's traffic matrix, but they all cross the
+     * single bottleneck, so this models the shuffle's aggregate load on one
+     * shared link (e.g. a ToR uplink), not contention at each receiver's
+     * downlink as in a real all-to-all.
+     *
+     * @return hosts * (hosts - 1)
+     */
+    size_t AddAllPairs(uint32_t hosts, uint64_t bytesPerPair, SimTime timeUs, SimTime jitterUs = 0);
+
+    const std::vector<WorkloadFlow>& GetFlows() const;
+    void Clear();
+
+    /**
+     * @brief Add every flow to the simulator.
+     *
+     * @param sim target simulator
+     * @param factory creates the congestion control of each flow
+     * @param baseRttUs propagation delay of each flow
+     * @return simulator flow ids, in the order of GetFlows()
+     */
+    std::vector<uint32_t> Install(Simulator& sim,
+                                  const std::function<std::unique_ptr<CongestionControl>()>& factory,
+                                  uint32_t baseRttUs) const;
+
+private:
+    SimTime Jitter(SimTime jitterUs);
+
+    std::vector<WorkloadFlow> m_flows;
+    std::mt19937_64 m_rng;
+};
+
+// FCT statistics of one flow size bucket
+struct FctBucket {
+    uint64_t max_bytes;             // bucket holds sizes <= max_bytes
+    uint64_t flows;                 // completed flows
+    uint64_t unfinished;            // flows still running at the end of the run
+    double mean_fct_us;
+    double mean_slowdown;
+    double slowdown_p50;
+    double slowdown_p99;
+};
+
+/*
+ * Flow completion time report.
+ *
+ * Slowdown = FCT / ideal FCT, where the ideal FCT is the base RTT plus the
+ * serialization time of the flow at the bottleneck rate. Percentiles use
+ * streaming P-square sketches, so reports over millions of flows stay small.
+ */
+class FctReport {
+public:
+    /**
+     * @param linkRateBps bottleneck rate used for the ideal FCT
+     * @param bucketEdges upper size bound of each bucket (the last bucket is open)
+     */
+    explicit FctReport(uint64_t linkRateBps,
+                       const std::vector<uint64_t>& bucketEdges = DefaultBuckets());
+
+    void AddFlow(uint64_t sizeBytes, SimTime fctUs, uint32_t baseRttUs);
+    void AddUnfinished(uint64_t sizeBytes);
+
+    // Collect every workload flow from a finished simulation
+    void Collect(const Simulator& sim, const std::vector<uint32_t>& flowIds,
+                 const std::vector<WorkloadFlow>& flows, uint32_t baseRttUs);
+
+    std::vector<FctBucket> GetBuckets() const;
+
+    // 10KB / 100KB / 1MB / 10MB / larger
+    static std::vector<uint64_t> DefaultBuckets();
+
+private:
+    struct Bucket {
+        uint64_t max_bytes;
+        uint64_t flows;
+        uint64_t unfinished;
+        double fct_sum;
+        double slowdown_sum;
+        P2Quantile p50;
+        P2Quantile p99;
+    };
+
+    Bucket& FindBucket(uint64_t sizeBytes);
+
+    uint64_t m_linkRateBps;
+    std::vector<Bucket> m_buckets;
+};
+
+#endif // WORKLOAD_H
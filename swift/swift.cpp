@@ -0,0 +1,364 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 22:20:15
+@Description: Swift (delay-based datacenter congestion control) Algorithm Implementation
+@Language: C++17
+*/
+
+#include "swift.h"
+#include "../utils/probes.h"
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+// Default constructor
+Swift::Swift()
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::SWIFT), "Swift"),
+      m_cwnd(0),                    // Will be set from the socket
+      m_maxCwnd(65535),             // Default max window
+      m_mss(0),
+      m_fabricCwnd(1.0),            // Seeded from the socket on the first ACK
+      m_endpointCwnd(1.0),
+      m_initialized(false),
+      m_minRTT(0xFFFFFFFF),         // Maximum initial value
+      m_minRTTTimestamp(0),
+      m_lastRtt(0),
+      m_fabricDelay(0),
+      m_endpointDelay(0),
+      m_pendingEndpointDelay(0),    // Endpoint delay not measured
+      m_hasSample(false),
+      m_baseTargetUs(DEFAULT_BASE_TARGET_US),
+      m_hopScalingUs(DEFAULT_HOP_SCALING_US),
+      m_endpointTargetUs(DEFAULT_ENDPOINT_TARGET_US),
+      m_hopCount(0),                // Single switch unless told otherwise
+      m_lastDecreaseUs(0),          // No decrease yet
+      m_retransmitCount(0)
+{
+}
+
+// Copy constructor
+Swift::Swift(const Swift& other)
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::SWIFT), "Swift"),
+      m_cwnd(other.m_cwnd),
+      m_maxCwnd(other.m_maxCwnd),
+      m_mss(other.m_mss),
+      m_fabricCwnd(other.m_fabricCwnd),
+      m_endpointCwnd(other.m_endpointCwnd),
+      m_initialized(other.m_initialized),
+      m_minRTT(other.m_minRTT),
+      m_minRTTTimestamp(other.m_minRTTTimestamp),
+      m_lastRtt(other.m_lastRtt),
+      m_fabricDelay(other.m_fabricDelay),
+      m_endpointDelay(other.m_endpointDelay),
+      m_pendingEndpointDelay(other.m_pendingEndpointDelay),
+      m_hasSample(other.m_hasSample),
+      m_baseTargetUs(other.m_baseTargetUs),
+      m_hopScalingUs(other.m_hopScalingUs),
+      m_endpointTargetUs(other.m_endpointTargetUs),
+      m_hopCount(other.m_hopCount),
+      m_lastDecreaseUs(other.m_lastDecreaseUs),
+      m_retransmitCount(other.m_retransmitCount)
+{
+}
+
+// Destructor
+Swift::~Swift() {
+    // No dynamic memory to clean up
+}
+
+// Get type ID
+TypeId Swift::GetTypeId() {
+    return static_cast<TypeId>(CongestionAlgorithm::SWIFT);
+}
+
+// Get algorithm name
+std::string Swift::GetAlgorithmName() {
+    return "Swift";
+}
+
+// Swift has no slow start threshold
+uint32_t Swift::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    return 0x7fffffff;
+}
+
+// AIMD of both windows against their delay targets
+void Swift::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+    if (socket == nullptr || segmentsAcked == 0 || !m_hasSample) {
+        return;
+    }
+
+    uint64_t now = socket->NowUs();
+    bool canDecrease = CanDecrease(now);
+    bool fabricDecreased = false;
+    bool endpointDecreased = false;
+
+    m_fabricCwnd = UpdateWindow(m_fabricCwnd, m_fabricDelay, FabricTarget(), segmentsAcked,
+                                canDecrease, fabricDecreased);
+    m_endpointCwnd = UpdateWindow(m_endpointCwnd, m_endpointDelay, m_endpointTargetUs, segmentsAcked,
+                                  canDecrease, endpointDecreased);
+    if (fabricDecreased || endpointDecreased) {
+        m_lastDecreaseUs = now;
+        CC_PROBE5(swift_decrease, static_cast<void*>(this), m_fabricDelay, m_endpointDelay, FabricTarget(),
+                  CC_PROBE_FIXED(std::min(m_fabricCwnd, m_endpointCwnd)));
+    }
+
+    ApplyCwnd(socket);
+}
+
+// Measure fabric and endpoint delay of the ACK
+void Swift::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+    if (socket == nullptr || segmentsAcked == 0) {
+        return;
+    }
+
+    // Update RTT information
+    socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
+
+    // Update RTT variance
+    if (socket->rtt_var_ == 0) {
+        socket->rtt_var_ = rtt / 2;
+    } else {
+        socket->rtt_var_ = (3 * socket->rtt_var_ + rtt) / 4;
+    }
+    socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
+
+    if (!m_initialized) {
+        m_mss = socket->mss_bytes_;
+        m_maxCwnd = socket->max_cwnd_;
+        m_fabricCwnd = static_cast<double>(socket->cwnd_) / std::max(socket->mss_bytes_, 1u);
+        m_endpointCwnd = m_fabricCwnd;
+        m_initialized = true;
+    }
+
+    // Progress ends a run of timeouts
+    m_retransmitCount = 0;
+
+    if (rtt == 0) {
+        return;
+    }
+
+    // Remote host delay comes from NIC timestamps; the rest is fabric
+    m_lastRtt = static_cast<uint32_t>(rtt);
+    m_endpointDelay = std::min(m_pendingEndpointDelay, m_lastRtt);
+    m_fabricDelay = m_lastRtt - m_endpointDelay;
+    m_pendingEndpointDelay = 0;
+    m_hasSample = true;
+
+    UpdateRTT(m_fabricDelay, socket->NowUs());
+}
+
+// Set congestion state
+void Swift::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    socket->tcp_state_ = congestionState;
+}
+
+// Handle congestion window events
+void Swift::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    CC_PROBE_CWND_EVENT(swift_cwnd_event, socket, congestionEvent);
+    socket->congestion_event_ = congestionEvent;
+
+    switch (congestionEvent) {
+        case CongestionEvent::PacketLoss:
+            // Fast recovery: decrease by MAX_MDF, once per RTT
+            DecreaseOnLoss(socket->NowUs());
+            ApplyCwnd(socket);
+            break;
+
+        case CongestionEvent::Timeout:
+            // Repeated timeouts collapse the window to its floor
+            m_retransmitCount++;
+            if (m_retransmitCount >= RETX_RESET_THRESHOLD) {
+                m_fabricCwnd = MIN_CWND;
+                m_endpointCwnd = MIN_CWND;
+                m_lastDecreaseUs = socket->NowUs();
+            } else {
+                DecreaseOnLoss(socket->NowUs());
+            }
+            ApplyCwnd(socket);
+            socket->tcp_state_ = TCPState::Loss;
+            break;
+
+        case CongestionEvent::ECN:
+            // Swift reacts to delay only
+            break;
+
+        case CongestionEvent::FastRecovery:
+            socket->tcp_state_ = TCPState::Recovery;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Check if congestion control is enabled
+bool Swift::HasCongControl() const {
+    return true;
+}
+
+// Main congestion control logic
+void Swift::CongControl(std::unique_ptr<SocketState>& socket,
+                        const CongestionEvent& congestionEvent,
+                        const RTTSample& rtt) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    // Handle the congestion event
+    CwndEvent(socket, congestionEvent);
+
+    // Update with RTT if valid
+    if (rtt.rtt.count() > 0) {
+        PktsAcked(socket, 1, rtt.rtt.count());
+        IncreaseWindow(socket, 1);
+    }
+}
+
+// Get decision
+CcDecision Swift::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    CcDecision decision = CongestionControl::GetDecision(socket);
+    if (socket == nullptr || m_lastRtt == 0) {
+        return decision;
+    }
+
+    double cwnd = std::min(m_fabricCwnd, m_endpointCwnd);
+    uint32_t mss = socket->mss_bytes_;
+    if (cwnd < 1.0) {
+        // One packet every RTT / cwnd
+        decision.pacing_rate = std::max<uint64_t>(static_cast<uint64_t>(cwnd * mss * 1000000.0 / m_lastRtt), 1);
+        decision.send_quantum = mss;
+    } else {
+        decision.pacing_rate = static_cast<uint64_t>(socket->cwnd_) * 1000000 * PACING_CA_RATIO / 100 / m_lastRtt;
+        decision.send_quantum = SendQuantumForRate(decision.pacing_rate, mss);
+    }
+
+    uint32_t minRtt = m_minRTT != 0xFFFFFFFF ? m_minRTT : socket->rtt_us_;
+    FillAckFrequency(decision, mss, minRtt, false);
+    return decision;
+}
+
+// Set queueing targets
+void Swift::SetTargets(uint32_t baseTargetUs, uint32_t hopScalingUs, uint32_t endpointTargetUs) {
+    m_baseTargetUs = baseTargetUs;
+    m_hopScalingUs = hopScalingUs;
+    m_endpointTargetUs = endpointTargetUs;
+}
+
+// Set hop count
+void Swift::SetHopCount(uint32_t hops) {
+    m_hopCount = hops;
+}
+
+// Set endpoint delay of the next ACK
+void Swift::SetEndpointDelay(uint32_t endpointDelayUs) {
+    m_pendingEndpointDelay = endpointDelayUs;
+}
+
+// Get fabric window
+double Swift::GetFabricCwnd() const {
+    return m_fabricCwnd;
+}
+
+// Get endpoint window
+double Swift::GetEndpointCwnd() const {
+    return m_endpointCwnd;
+}
+
+// Get fabric target delay
+uint32_t Swift::GetTargetDelay() const {
+    return FabricTarget();
+}
+
+// Fabric target: min fabric RTT + base + hops x h + flow scaling
+uint32_t Swift::FabricTarget() const {
+    uint32_t minRtt = m_minRTT != 0xFFFFFFFF ? m_minRTT : 0;
+    double target = static_cast<double>(minRtt) + m_baseTargetUs +
+                    static_cast<double>(m_hopCount) * m_hopScalingUs + FlowScaling(m_fabricCwnd);
+    return static_cast<uint32_t>(target);
+}
+
+// Flow scaling: alpha / sqrt(cwnd) + beta, within [0, fs_range]
+double Swift::FlowScaling(double cwnd) const {
+    double range = static_cast<double>(FS_RANGE_MULTIPLIER) * m_baseTargetUs;
+    double alpha = range / (1.0 / std::sqrt(FS_MIN_CWND) - 1.0 / std::sqrt(FS_MAX_CWND));
+    double beta = -alpha / std::sqrt(FS_MAX_CWND);
+
+    double scaling = alpha / std::sqrt(std::max(cwnd, MIN_CWND)) + beta;
+    return std::min(std::max(scaling, 0.0), range);
+}
+
+// One AIMD step
+double Swift::UpdateWindow(double cwnd, uint32_t delayUs, uint32_t targetUs, uint32_t segmentsAcked,
+                           bool canDecrease, bool& decreased) const {
+    decreased = false;
+
+    if (delayUs < targetUs) {
+        // Additive increase: ai packets per RTT, ai per ACK below one packet
+        if (cwnd >= 1.0) {
+            return cwnd + AI / cwnd * segmentsAcked;
+        }
+        return cwnd + AI * segmentsAcked;
+    }
+
+    if (!canDecrease || delayUs == 0) {
+        return cwnd;
+    }
+
+    // Multiplicative decrease in proportion to the excess delay
+    double factor = 1.0 - BETA * (static_cast<double>(delayUs - targetUs) / delayUs);
+    decreased = true;
+    return cwnd * std::max(factor, 1.0 - MAX_MDF);
+}
+
+// Track min fabric RTT
+void Swift::UpdateRTT(uint32_t fabricDelayUs, uint64_t nowUs) {
+    if (fabricDelayUs == 0) {
+        return;
+    }
+
+    // A stale minimum is replaced (path change)
+    if (fabricDelayUs <= m_minRTT || nowUs - m_minRTTTimestamp > MIN_RTT_WINDOW_US) {
+        m_minRTT = fabricDelayUs;
+        m_minRTTTimestamp = nowUs;
+    }
+}
+
+// Multiplicative decrease on loss
+void Swift::DecreaseOnLoss(uint64_t nowUs) {
+    if (!CanDecrease(nowUs)) {
+        return;
+    }
+
+    m_fabricCwnd *= 1.0 - MAX_MDF;
+    m_endpointCwnd *= 1.0 - MAX_MDF;
+    m_lastDecreaseUs = nowUs;
+}
+
+// Clamp and publish the window
+void Swift::ApplyCwnd(std::unique_ptr<SocketState>& socket) {
+    uint32_t mss = std::max(socket->mss_bytes_, 1u);
+    double maxCwnd = static_cast<double>(std::max(socket->max_cwnd_, mss)) / mss;
+
+    m_fabricCwnd = std::min(std::max(m_fabricCwnd, MIN_CWND), maxCwnd);
+    m_endpointCwnd = std::min(std::max(m_endpointCwnd, MIN_CWND), maxCwnd);
+
+    // Below one packet the window is enforced by pacing
+    double cwnd = std::min(m_fabricCwnd, m_endpointCwnd);
+    m_cwnd = static_cast<uint32_t>(std::max(cwnd, 1.0) * mss);
+    m_mss = mss;
+    socket->cwnd_ = m_cwnd;
+}
+
+// At most one decrease per RTT
+bool Swift::CanDecrease(uint64_t nowUs) const {
+    return m_lastDecreaseUs == 0 || nowUs - m_lastDecreaseUs >= m_lastRtt;
+}
@@ -0,0 +1,144 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 22:20:15
+@Description: Swift (delay-based datacenter congestion control) Algorithm
+@Language: C++17
+*/
+
+#ifndef SWIFT_H
+#define SWIFT_H
+
+#include "../utils/cong.h"
+
+#include <string>
+#include <chrono>
+
+/*
+ * Swift (Kumar et al., SIGCOMM 2020).
+ *
+ * Two windows, in packets and possibly below one: the fabric window
+ * reacts to fabric delay against a target scaled by hop count and by
+ * the flow's own window (a proxy for the number of competing flows),
+ * the endpoint window reacts to remote host delay against a fixed
+ * target. The flow sends with the smaller one. Below one packet the
+ * window becomes a pacing rate of cwnd packets per RTT.
+ *
+ * Each ACK adds ai / cwnd packets while delay is under target, or cuts
+ * the window in proportion to the excess delay at most once per RTT.
+ *
+ * Swift's targets include the unloaded fabric RTT, which the paper
+ * configures per topology; here it is learned as the min fabric RTT, so
+ * the targets below are queueing allowances on top of it.
+ */
+class Swift: public CongestionControl {
+public:
+    Swift();
+    Swift(const Swift& other);
+    ~Swift() override;
+
+    TypeId GetTypeId();
+
+    std::string GetAlgorithmName() override;
+
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
+    void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
+
+    void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
+
+    void CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) override;
+
+    void CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) override;
+
+    bool HasCongControl() const override;
+
+    void CongControl(std::unique_ptr<SocketState>& socket, const CongestionEvent& congestionEvent, const RTTSample& rtt) override;
+
+    // Paced below one packet of cwnd, cwnd / RTT otherwise
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    // Queueing targets (microseconds): fabric base, per hop, and remote endpoint
+    void SetTargets(uint32_t baseTargetUs, uint32_t hopScalingUs, uint32_t endpointTargetUs);
+
+    // Fabric hops of the path (e.g. from the TTL of received packets)
+    void SetHopCount(uint32_t hops);
+
+    // Remote host delay of the next ACK from NIC timestamps, 0 = not measured
+    void SetEndpointDelay(uint32_t endpointDelayUs);
+
+    // Windows in packets
+    double GetFabricCwnd() const;
+    double GetEndpointCwnd() const;
+
+    // Current fabric target delay, including the min fabric RTT (microseconds)
+    uint32_t GetTargetDelay() const;
+
+protected:
+    // Fabric delay target: base + hops x h + flow scaling
+    virtual uint32_t FabricTarget() const;
+
+    // Flow-based scaling term for a window of `cwnd` packets
+    virtual double FlowScaling(double cwnd) const;
+
+    // AIMD step of one window against its delay target
+    virtual double UpdateWindow(double cwnd, uint32_t delayUs, uint32_t targetUs, uint32_t segmentsAcked,
+                                bool canDecrease, bool& decreased) const;
+
+    // Track min fabric RTT
+    virtual void UpdateRTT(uint32_t fabricDelayUs, uint64_t nowUs);
+
+    // Multiplicative decrease on loss, once per RTT
+    virtual void DecreaseOnLoss(uint64_t nowUs);
+
+private:
+    // Clamp both windows and publish the smaller one to the socket
+    void ApplyCwnd(std::unique_ptr<SocketState>& socket);
+
+    // Whether the last decrease is at least one RTT old
+    bool CanDecrease(uint64_t nowUs) const;
+
+    // Standard TCP parameters
+    uint32_t m_cwnd;               // Published congestion window (bytes, at least 1 MSS)
+    uint32_t m_maxCwnd;            // Maximum congestion window
+    uint32_t m_mss;                // MSS of the last update
+
+    // Swift windows (packets)
+    double m_fabricCwnd;           // Window from fabric delay
+    double m_endpointCwnd;         // Window from endpoint delay
+    bool m_initialized;            // Windows seeded from the socket
+
+    // Delay measurements
+    uint32_t m_minRTT;             // Min fabric RTT (microseconds)
+    uint64_t m_minRTTTimestamp;    // When m_minRTT was last confirmed
+    uint32_t m_lastRtt;            // Latest RTT sample
+    uint32_t m_fabricDelay;        // Latest fabric delay
+    uint32_t m_endpointDelay;      // Latest endpoint delay
+    uint32_t m_pendingEndpointDelay;   // Endpoint delay for the next ACK
+    bool m_hasSample;              // A delay sample has been taken
+
+    // Targets
+    uint32_t m_baseTargetUs;       // Fabric base queueing target
+    uint32_t m_hopScalingUs;       // Added per hop
+    uint32_t m_endpointTargetUs;   // Endpoint delay target
+    uint32_t m_hopCount;           // Fabric hops
+
+    // Decrease pacing
+    uint64_t m_lastDecreaseUs;     // Time of the last multiplicative decrease
+    uint32_t m_retransmitCount;    // Consecutive retransmission timeouts
+
+    // Configuration constants
+    static constexpr double AI = 1.0;                       // Additive increase (packets per RTT)
+    static constexpr double BETA = 0.8;                     // Multiplicative decrease gain
+    static constexpr double MAX_MDF = 0.5;                  // Largest decrease per RTT
+    static constexpr double MIN_CWND = 0.001;               // Packets
+    static constexpr double FS_MIN_CWND = 0.1;              // Flow scaling window range (packets)
+    static constexpr double FS_MAX_CWND = 100.0;
+    static constexpr uint32_t FS_RANGE_MULTIPLIER = 5;      // fs_range = 5 x base target
+    static constexpr uint32_t RETX_RESET_THRESHOLD = 5;     // Timeouts before cwnd = MIN_CWND
+    static constexpr uint32_t DEFAULT_BASE_TARGET_US = 25;
+    static constexpr uint32_t DEFAULT_HOP_SCALING_US = 1;
+    static constexpr uint32_t DEFAULT_ENDPOINT_TARGET_US = 100;
+    static constexpr uint64_t MIN_RTT_WINDOW_US = 10000000; // Min RTT validity window (10s)
+};
+
+#endif // SWIFT_H
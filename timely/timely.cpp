@@ -0,0 +1,322 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 23:48:26
+@Description: TIMELY (RTT-gradient rate control) Algorithm Implementation
+@Language: C++17
+*/
+
+#include "timely.h"
+#include "../utils/probes.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// Default constructor
+Timely::Timely()
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::TIMELY), "Timely"),
+      m_cwnd(0),                    // Will be set from the rate
+      m_maxCwnd(65535),             // Default max window
+      m_rate(0.0),                  // Starts at IW / RTT on the first sample
+      m_minRate(DEFAULT_MIN_RATE),
+      m_maxRate(0),                 // Unbounded
+      m_delta(DEFAULT_DELTA),
+      m_mode(TimelyMode::LOW_RTT),
+      m_prevRtt(0),                 // No completion event yet
+      m_rttDiff(0.0),
+      m_minRTT(0xFFFFFFFF),         // Maximum initial value
+      m_minRTTTimestamp(0),
+      m_negativeCount(0),
+      m_tLow(DEFAULT_T_LOW_US),
+      m_tHigh(DEFAULT_T_HIGH_US),
+      m_segmentBytes(DEFAULT_SEGMENT_BYTES),
+      m_pendingBytes(0),
+      m_lastEventUs(0),
+      m_lastRtt(0)
+{
+}
+
+// Copy constructor
+Timely::Timely(const Timely& other)
+    : CongestionControl(static_cast<TypeId>(CongestionAlgorithm::TIMELY), "Timely"),
+      m_cwnd(other.m_cwnd),
+      m_maxCwnd(other.m_maxCwnd),
+      m_rate(other.m_rate),
+      m_minRate(other.m_minRate),
+      m_maxRate(other.m_maxRate),
+      m_delta(other.m_delta),
+      m_mode(other.m_mode),
+      m_prevRtt(other.m_prevRtt),
+      m_rttDiff(other.m_rttDiff),
+      m_minRTT(other.m_minRTT),
+      m_minRTTTimestamp(other.m_minRTTTimestamp),
+      m_negativeCount(other.m_negativeCount),
+      m_tLow(other.m_tLow),
+      m_tHigh(other.m_tHigh),
+      m_segmentBytes(other.m_segmentBytes),
+      m_pendingBytes(other.m_pendingBytes),
+      m_lastEventUs(other.m_lastEventUs),
+      m_lastRtt(other.m_lastRtt)
+{
+}
+
+// Destructor
+Timely::~Timely() {
+    // No dynamic memory to clean up
+}
+
+// Get type ID
+TypeId Timely::GetTypeId() {
+    return static_cast<TypeId>(CongestionAlgorithm::TIMELY);
+}
+
+// Get algorithm name
+std::string Timely::GetAlgorithmName() {
+    return "Timely";
+}
+
+// TIMELY has no slow start threshold
+uint32_t Timely::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    return 0x7fffffff;
+}
+
+// The rate, not ACK counting, sets the window
+void Timely::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+    if (socket == nullptr || m_rate == 0.0) {
+        return;
+    }
+
+    ApplyCwnd(socket);
+}
+
+// Collect RTT samples and run one rate update per completion event
+void Timely::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+    if (socket == nullptr || segmentsAcked == 0) {
+        return;
+    }
+
+    // Update RTT information
+    socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
+
+    // Update RTT variance
+    if (socket->rtt_var_ == 0) {
+        socket->rtt_var_ = rtt / 2;
+    } else {
+        socket->rtt_var_ = (3 * socket->rtt_var_ + rtt) / 4;
+    }
+    socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
+
+    if (rtt == 0) {
+        return;
+    }
+    uint64_t now = socket->NowUs();
+    m_lastRtt = static_cast<uint32_t>(rtt);
+    UpdateRTT(m_lastRtt, now);
+
+    // Start at the initial window per RTT
+    if (m_rate == 0.0) {
+        m_rate = std::max(static_cast<double>(socket->cwnd_) * 1000000.0 / m_lastRtt, static_cast<double>(m_minRate));
+    }
+
+    // A segment completes, or a min RTT passes at low rates
+    m_pendingBytes += static_cast<uint64_t>(segmentsAcked) * socket->mss_bytes_;
+    if (m_pendingBytes < m_segmentBytes && m_lastEventUs != 0 && now - m_lastEventUs < m_minRTT) {
+        return;
+    }
+    m_pendingBytes = 0;
+    m_lastEventUs = now;
+
+    UpdateRate(m_lastRtt);
+}
+
+// Set congestion state
+void Timely::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    socket->tcp_state_ = congestionState;
+}
+
+// Handle congestion window events
+void Timely::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    CC_PROBE_CWND_EVENT(timely_cwnd_event, socket, congestionEvent);
+    socket->congestion_event_ = congestionEvent;
+
+    switch (congestionEvent) {
+        case CongestionEvent::PacketLoss:
+            // TIMELY reacts to RTT only; the queue that caused a loss also raised the RTT
+            break;
+
+        case CongestionEvent::Timeout:
+            // Halve the rate and start a fresh gradient
+            m_rate = std::max(m_rate / 2.0, static_cast<double>(m_minRate));
+            m_prevRtt = 0;
+            m_rttDiff = 0.0;
+            m_negativeCount = 0;
+            ApplyCwnd(socket);
+            socket->tcp_state_ = TCPState::Loss;
+            break;
+
+        case CongestionEvent::ECN:
+            // TIMELY does not use ECN
+            break;
+
+        case CongestionEvent::FastRecovery:
+            socket->tcp_state_ = TCPState::Recovery;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Check if congestion control is enabled
+bool Timely::HasCongControl() const {
+    return true;
+}
+
+// Main congestion control logic
+void Timely::CongControl(std::unique_ptr<SocketState>& socket,
+                         const CongestionEvent& congestionEvent,
+                         const RTTSample& rtt) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    // Handle the congestion event
+    CwndEvent(socket, congestionEvent);
+
+    // Update with RTT if valid
+    if (rtt.rtt.count() > 0) {
+        PktsAcked(socket, 1, rtt.rtt.count());
+        IncreaseWindow(socket, 1);
+    }
+}
+
+// Get decision
+CcDecision Timely::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    CcDecision decision = CongestionControl::GetDecision(socket);
+    if (socket == nullptr) {
+        return decision;
+    }
+    // Per-packet pacing: at microsecond RTTs one segment burst alone exceeds the BDP
+    if (m_rate != 0.0) {
+        decision.pacing_rate = GetPacingRate();
+        decision.send_quantum = socket->mss_bytes_;
+    }
+
+    uint32_t minRtt = m_minRTT != 0xFFFFFFFF ? m_minRTT : socket->rtt_us_;
+    FillAckFrequency(decision, socket->mss_bytes_, minRtt, false);
+    return decision;
+}
+
+// Set thresholds
+void Timely::SetThresholds(uint32_t tLowUs, uint32_t tHighUs) {
+    m_tLow = tLowUs;
+    m_tHigh = std::max(tHighUs, tLowUs);
+}
+
+// Set additive increase step
+void Timely::SetAdditiveIncrease(uint64_t delta) {
+    m_delta = delta;
+}
+
+// Set rate bounds
+void Timely::SetRateLimits(uint64_t minRate, uint64_t maxRate) {
+    m_minRate = minRate;
+    m_maxRate = maxRate;
+}
+
+// Set completion event size
+void Timely::SetSegmentBytes(uint32_t bytes) {
+    m_segmentBytes = std::max(bytes, 1u);
+}
+
+// Get pacing rate
+uint64_t Timely::GetPacingRate() const {
+    return static_cast<uint64_t>(m_rate);
+}
+
+// Get mode
+TimelyMode Timely::GetMode() const {
+    return m_mode;
+}
+
+// Get normalized gradient
+double Timely::GetNormalizedGradient() const {
+    if (m_minRTT == 0xFFFFFFFF || m_minRTT == 0) {
+        return 0.0;
+    }
+    return m_rttDiff / m_minRTT;
+}
+
+// Rate update on a completion event (Algorithm 1)
+void Timely::UpdateRate(uint32_t newRtt) {
+    // The first event only seeds the gradient
+    if (m_prevRtt == 0) {
+        m_prevRtt = newRtt;
+        return;
+    }
+
+    double newRttDiff = static_cast<double>(newRtt) - static_cast<double>(m_prevRtt);
+    m_prevRtt = newRtt;
+    m_rttDiff = (1.0 - ALPHA) * m_rttDiff + ALPHA * newRttDiff;
+    double gradient = GetNormalizedGradient();
+
+    if (newRtt < m_tLow) {
+        m_mode = TimelyMode::LOW_RTT;
+        m_negativeCount = 0;
+        m_rate += m_delta;
+    } else if (newRtt > m_tHigh) {
+        m_mode = TimelyMode::HIGH_RTT;
+        m_negativeCount = 0;
+        m_rate *= 1.0 - BETA * (1.0 - static_cast<double>(m_tHigh) / newRtt);
+    } else if (gradient <= 0.0) {
+        m_negativeCount++;
+        uint32_t n = 1;
+        m_mode = TimelyMode::GRADIENT_INCREASE;
+        if (m_negativeCount >= HAI_THRESHOLD) {
+            n = HAI_MULTIPLIER;
+            m_mode = TimelyMode::HAI;
+        }
+        m_rate += static_cast<double>(n) * m_delta;
+    } else {
+        m_mode = TimelyMode::GRADIENT_DECREASE;
+        m_negativeCount = 0;
+        m_rate *= 1.0 - BETA * std::min(gradient, MAX_GRADIENT);
+    }
+
+    m_rate = std::max(m_rate, static_cast<double>(m_minRate));
+    if (m_maxRate != 0) {
+        m_rate = std::min(m_rate, static_cast<double>(m_maxRate));
+    }
+
+    CC_PROBE5(timely_update_rate, static_cast<void*>(this), static_cast<uint64_t>(m_rate), newRtt,
+              CC_PROBE_FIXED(gradient), static_cast<int>(m_mode));
+}
+
+// Track min RTT
+void Timely::UpdateRTT(uint32_t rtt, uint64_t nowUs) {
+    // A stale minimum is replaced (path change)
+    if (rtt <= m_minRTT || nowUs - m_minRTTTimestamp > MIN_RTT_WINDOW_US) {
+        m_minRTT = rtt;
+        m_minRTTTimestamp = nowUs;
+    }
+}
+
+// Cap inflight at CWND_GAIN x rate x min RTT
+void Timely::ApplyCwnd(std::unique_ptr<SocketState>& socket) {
+    // The min RTT keeps queueing delay from inflating the cap
+    uint32_t rtt = m_minRTT != 0xFFFFFFFF ? m_minRTT : socket->rtt_us_;
+    double bdp = m_rate * rtt / 1000000.0;
+
+    m_maxCwnd = socket->max_cwnd_;
+    double cwnd = std::min(std::max(CWND_GAIN * bdp, 2.0 * socket->mss_bytes_), static_cast<double>(m_maxCwnd));
+    m_cwnd = static_cast<uint32_t>(cwnd);
+    socket->cwnd_ = m_cwnd;
+}
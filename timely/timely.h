@@ -0,0 +1,145 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 23:48:26
+@Description: TIMELY (RTT-gradient rate control) Algorithm
+@Language: C++17
+*/
+
+#ifndef TIMELY_H
+#define TIMELY_H
+
+#include "../utils/cong.h"
+
+#include <string>
+
+// TIMELY rate update regions
+enum class TimelyMode {
+    LOW_RTT,            // RTT below Tlow: additive increase
+    HIGH_RTT,           // RTT above Thigh: decrease toward Thigh
+    GRADIENT_INCREASE,  // Non-positive gradient: additive increase
+    HAI,                // Hyperactive increase after HAI_THRESHOLD such events
+    GRADIENT_DECREASE,  // Positive gradient: decrease in proportion to it
+};
+
+/*
+ * TIMELY (Mittal et al., SIGCOMM 2015).
+ *
+ * A rate-based algorithm driven by the RTT gradient. Once per completion
+ * event the new RTT updates an EWMA of RTT differences; the gradient,
+ * normalized by the min RTT, sets the rate:
+ *
+ *     rtt < Tlow:      rate += delta
+ *     rtt > Thigh:     rate *= 1 - beta x (1 - Thigh / rtt)
+ *     gradient <= 0:   rate += N x delta   (N = 5 after 5 such events: HAI)
+ *     gradient > 0:    rate *= 1 - beta x gradient
+ *
+ * The paper's completion events are NIC segments of 16-64KB; here an
+ * event is SetSegmentBytes() acknowledged bytes, or one min RTT of ACKs
+ * at rates too low to fill a segment, with the latest RTT sample. The
+ * normalized gradient is capped at 1, so one event never cuts the rate
+ * by more than beta. The pacing rate drives the sender; cwnd only caps
+ * inflight at CWND_GAIN x rate x min RTT for senders that do not pace.
+ */
+class Timely: public CongestionControl {
+public:
+    Timely();
+    Timely(const Timely& other);
+    ~Timely() override;
+
+    TypeId GetTypeId();
+
+    std::string GetAlgorithmName() override;
+
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
+    void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
+
+    void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
+
+    void CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) override;
+
+    void CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) override;
+
+    bool HasCongControl() const override;
+
+    void CongControl(std::unique_ptr<SocketState>& socket, const CongestionEvent& congestionEvent, const RTTSample& rtt) override;
+
+    // The rate drives the sender
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    // RTT thresholds Tlow / Thigh (microseconds)
+    void SetThresholds(uint32_t tLowUs, uint32_t tHighUs);
+
+    // Additive increase step delta (bytes/sec)
+    void SetAdditiveIncrease(uint64_t delta);
+
+    // Rate bounds (bytes/sec), maxRate 0 = unbounded
+    void SetRateLimits(uint64_t minRate, uint64_t maxRate);
+
+    // Acknowledged bytes per completion event
+    void SetSegmentBytes(uint32_t bytes);
+
+    // Get pacing rate (bytes/sec)
+    uint64_t GetPacingRate() const;
+
+    // Get region of the last rate update
+    TimelyMode GetMode() const;
+
+    // EWMA RTT gradient normalized by the min RTT
+    double GetNormalizedGradient() const;
+
+protected:
+    // One rate update (Algorithm 1)
+    virtual void UpdateRate(uint32_t newRtt);
+
+    // Track min RTT
+    virtual void UpdateRTT(uint32_t rtt, uint64_t nowUs);
+
+private:
+    // Publish the inflight cap for the current rate
+    void ApplyCwnd(std::unique_ptr<SocketState>& socket);
+
+    // Standard TCP parameters
+    uint32_t m_cwnd;               // Inflight cap (bytes)
+    uint32_t m_maxCwnd;            // Maximum congestion window
+
+    // Rate state
+    double m_rate;                 // Sending rate (bytes/sec), 0 = not started
+    uint64_t m_minRate;
+    uint64_t m_maxRate;            // 0 = unbounded
+    uint64_t m_delta;              // Additive increase step
+    TimelyMode m_mode;
+
+    // Gradient state
+    uint32_t m_prevRtt;            // RTT of the previous completion event, 0 = none
+    double m_rttDiff;              // EWMA of RTT differences (microseconds)
+    uint32_t m_minRTT;             // Min RTT (microseconds)
+    uint64_t m_minRTTTimestamp;    // When m_minRTT was last confirmed
+    uint32_t m_negativeCount;      // Consecutive non-positive gradients, for HAI
+
+    // Thresholds
+    uint32_t m_tLow;
+    uint32_t m_tHigh;
+
+    // Completion events
+    uint32_t m_segmentBytes;       // Bytes per completion event
+    uint64_t m_pendingBytes;       // Bytes acknowledged since the last event
+    uint64_t m_lastEventUs;        // Time of the last event, 0 = none
+    uint32_t m_lastRtt;            // Latest RTT sample
+
+    // Configuration constants
+    static constexpr double ALPHA = 0.875;                  // EWMA weight of the new difference
+    static constexpr double BETA = 0.8;                     // Multiplicative decrease factor
+    static constexpr double MAX_GRADIENT = 1.0;             // Caps one gradient decrease at beta
+    static constexpr uint32_t HAI_THRESHOLD = 5;            // Events before hyperactive increase
+    static constexpr uint32_t HAI_MULTIPLIER = 5;           // N in HAI
+    static constexpr uint32_t DEFAULT_T_LOW_US = 50;
+    static constexpr uint32_t DEFAULT_T_HIGH_US = 500;
+    static constexpr uint64_t DEFAULT_DELTA = 1250000;      // 10 Mbps
+    static constexpr uint64_t DEFAULT_MIN_RATE = 1250000;   // 10 Mbps
+    static constexpr uint32_t DEFAULT_SEGMENT_BYTES = 16384;
+    static constexpr uint32_t CWND_GAIN = 2;                // Inflight cap in rate x min RTT
+    static constexpr uint64_t MIN_RTT_WINDOW_US = 10000000; // Min RTT validity window (10s)
+};
+
+#endif // TIMELY_H
@@ -0,0 +1,146 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 11:05:12
+@Description: Compact summaries of idle flows with rehydration into full algorithms
+@Language: C++17
+*/
+
+#include "cold_flow_table.h"
+
+#include <algorithm>
+
+// Constructor
+ColdFlowTable::ColdFlowTable(uint64_t idleTimeoutUs)
+    : m_idleTimeoutUs(idleTimeoutUs)
+{
+}
+
+// Register a factory
+void ColdFlowTable::SetFactory(CongestionAlgorithm algorithm, CongestionControlFactory factory) {
+    m_factories[static_cast<uint8_t>(algorithm)] = std::move(factory);
+}
+
+// Check the idle timeout
+bool ColdFlowTable::ShouldFreeze(uint64_t lastActivityUs, uint64_t nowUs) const {
+    return nowUs >= lastActivityUs && nowUs - lastActivityUs >= m_idleTimeoutUs;
+}
+
+// Summarize and release a flow
+uint32_t ColdFlowTable::Freeze(std::unique_ptr<CongestionControl>& cc, std::unique_ptr<SocketState>& socket,
+                               uint64_t lastActivityUs) {
+    if (cc == nullptr || socket == nullptr) {
+        return INVALID_HANDLE;
+    }
+
+    TypeId algorithm = cc->GetTypeId();
+    if (algorithm > UINT8_MAX || m_factories.count(static_cast<uint8_t>(algorithm)) == 0) {
+        return INVALID_HANDLE;
+    }
+
+    CcModelSnapshot model = cc->GetModelSnapshot(socket);
+
+    ColdFlowSummary summary;
+    summary.idle_since_us = lastActivityUs;
+    summary.cwnd = socket->cwnd_;
+    summary.ssthresh = socket->ssthresh_;
+    summary.min_rtt_us = model.min_rtt_us;
+    summary.rto_us = socket->rto_us_;
+    summary.bandwidth_kBps = static_cast<uint32_t>(std::min<uint64_t>(model.bandwidth / 1000, UINT32_MAX));
+    summary.mss = static_cast<uint16_t>(std::min<uint32_t>(socket->mss_bytes_, UINT16_MAX));
+    summary.algorithm = static_cast<uint8_t>(algorithm);
+    summary.in_use = 1;
+
+    uint32_t handle;
+    if (!m_freeSlots.empty()) {
+        handle = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slots[handle] = summary;
+    } else {
+        handle = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back(summary);
+    }
+
+    cc.reset();
+    socket.reset();
+    return handle;
+}
+
+// Rebuild a frozen flow
+bool ColdFlowTable::Thaw(uint32_t handle, uint64_t nowUs, std::unique_ptr<CongestionControl>& cc,
+                         std::unique_ptr<SocketState>& socket) {
+    if (handle >= m_slots.size() || m_slots[handle].in_use == 0) {
+        return false;
+    }
+
+    ColdFlowSummary summary = m_slots[handle];
+    auto factory = m_factories.find(summary.algorithm);
+    if (factory == m_factories.end()) {
+        return false;
+    }
+    std::unique_ptr<CongestionControl> rebuilt = factory->second();
+    if (rebuilt == nullptr) {
+        return false;
+    }
+
+    uint64_t idle = nowUs > summary.idle_since_us ? nowUs - summary.idle_since_us : 0;
+    RestartAfterIdle(summary, idle);
+
+    std::unique_ptr<SocketState> restored = std::make_unique<SocketState>();
+    restored->mss_bytes_ = summary.mss;
+    restored->cwnd_ = summary.cwnd;
+    restored->ssthresh_ = summary.ssthresh;
+    restored->rtt_us_ = summary.min_rtt_us;
+    restored->rto_us_ = summary.rto_us;
+    restored->now_us_ = nowUs;
+
+    // Stale models would mislead the algorithm more than starting fresh
+    if (idle < MODEL_LIFETIME_US) {
+        CcModelSnapshot model;
+        model.bandwidth = static_cast<uint64_t>(summary.bandwidth_kBps) * 1000;
+        model.min_rtt_us = summary.min_rtt_us;
+        rebuilt->RestoreModel(restored, model);
+    }
+
+    m_slots[handle].in_use = 0;
+    m_freeSlots.push_back(handle);
+
+    cc = std::move(rebuilt);
+    socket = std::move(restored);
+    return true;
+}
+
+// Get a summary
+const ColdFlowSummary* ColdFlowTable::Get(uint32_t handle) const {
+    if (handle >= m_slots.size() || m_slots[handle].in_use == 0) {
+        return nullptr;
+    }
+    return &m_slots[handle];
+}
+
+// Frozen flows
+size_t ColdFlowTable::Size() const {
+    return m_slots.size() - m_freeSlots.size();
+}
+
+// Resident bytes
+size_t ColdFlowTable::GetMemoryBytes() const {
+    return sizeof(*this) + m_slots.capacity() * sizeof(ColdFlowSummary) + m_freeSlots.capacity() * sizeof(uint32_t);
+}
+
+// RFC 5681 section 4.1 / Linux tcp_cwnd_restart
+void ColdFlowTable::RestartAfterIdle(ColdFlowSummary& summary, uint64_t idleUs) const {
+    if (summary.rto_us == 0 || idleUs < summary.rto_us) {
+        return;
+    }
+
+    uint32_t restartCwnd = std::min(RESTART_WINDOW_SEGMENTS * summary.mss, summary.cwnd);
+
+    // tcp_current_ssthresh: remember 3/4 of the window in use
+    summary.ssthresh = std::max(summary.ssthresh, summary.cwnd / 4 * 3);
+
+    // Halve once per RTO of idle time
+    for (uint64_t elapsed = summary.rto_us; elapsed <= idleUs && summary.cwnd > restartCwnd; elapsed += summary.rto_us) {
+        summary.cwnd >>= 1;
+    }
+    summary.cwnd = std::max(summary.cwnd, restartCwnd);
+}
@@ -0,0 +1,115 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 11:05:12
+@Description: Compact summaries of idle flows with rehydration into full algorithms
+@Language: C++17
+*/
+
+#ifndef COLD_FLOW_TABLE_H
+#define COLD_FLOW_TABLE_H
+
+#include "cong.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Everything kept of an idle flow (32 bytes)
+struct ColdFlowSummary {
+    uint64_t idle_since_us;     // last activity of the flow, idle time counts from here
+    uint32_t cwnd;              // bytes
+    uint32_t ssthresh;          // bytes
+    uint32_t min_rtt_us;        // 0 = unknown
+    uint32_t rto_us;
+    uint32_t bandwidth_kBps;    // KB/s (1000 bytes), 0 = unknown
+    uint16_t mss;
+    uint8_t algorithm;          // CongestionAlgorithm
+    uint8_t in_use;             // 0 = free slot
+};
+
+static_assert(sizeof(ColdFlowSummary) == 32, "ColdFlowSummary must stay 32 bytes");
+
+/*
+ * Dense table of idle flows.
+ *
+ * Freeze() reduces a flow's CongestionControl and SocketState to a
+ * ColdFlowSummary and releases both; Thaw() builds a fresh algorithm
+ * from the factory registered for its CongestionAlgorithm, restores
+ * cwnd, ssthresh, RTT and the model, and applies the restart-after-idle
+ * rule of RFC 5681 section 4.1 as Linux tcp_cwnd_restart does: ssthresh
+ * keeps 3/4 of the old window, and cwnd halves for every RTO of idle
+ * time, down to the restart window min(IW, cwnd). Models whose flow has
+ * been idle for MODEL_LIFETIME_US or more are not restored. Idle time
+ * counts from the flow's last activity, not from the freeze.
+ *
+ * Slots live in one vector and are reused through a free list, so the
+ * resident cost of an idle flow is its 32-byte summary plus the vector's
+ * growth slack: about 42 bytes in all at 100k flows, and close to twice
+ * the summary just after the vector grows.
+ */
+class ColdFlowTable {
+public:
+    /**
+     * @param idleTimeoutUs idle time after which ShouldFreeze() reports true
+     */
+    explicit ColdFlowTable(uint64_t idleTimeoutUs = DEFAULT_IDLE_TIMEOUT_US);
+
+    // Factory used by Thaw() for flows of `algorithm`
+    void SetFactory(CongestionAlgorithm algorithm, CongestionControlFactory factory);
+
+    // Whether a flow last active at `lastActivityUs` has been idle long enough
+    bool ShouldFreeze(uint64_t lastActivityUs, uint64_t nowUs) const;
+
+    /**
+     * @brief Summarize an idle flow and release its state.
+     *
+     * @param cc flow's algorithm, reset on success
+     * @param socket flow's socket state, reset on success
+     * @param lastActivityUs last send or ACK of the flow, start of its idle time
+     * @return handle for Thaw(), INVALID_HANDLE (state kept) when the
+     *         algorithm has no registered factory
+     */
+    uint32_t Freeze(std::unique_ptr<CongestionControl>& cc, std::unique_ptr<SocketState>& socket,
+                    uint64_t lastActivityUs);
+
+    /**
+     * @brief Rebuild a frozen flow when traffic resumes.
+     *
+     * @param handle handle from Freeze(), released on success
+     * @param nowUs restart time
+     * @param cc receives the new algorithm
+     * @param socket receives the new socket state
+     * @return false if the handle is not frozen or the factory failed
+     */
+    bool Thaw(uint32_t handle, uint64_t nowUs, std::unique_ptr<CongestionControl>& cc,
+              std::unique_ptr<SocketState>& socket);
+
+    // Summary of a frozen flow, nullptr for a free or invalid handle
+    const ColdFlowSummary* Get(uint32_t handle) const;
+
+    // Frozen flows
+    size_t Size() const;
+
+    // Resident bytes of the table
+    size_t GetMemoryBytes() const;
+
+    static constexpr uint32_t INVALID_HANDLE = 0xFFFFFFFF;
+    static constexpr uint64_t DEFAULT_IDLE_TIMEOUT_US = 5000000;    // 5s
+    static constexpr uint64_t MODEL_LIFETIME_US = 10000000;         // 10s, as BBR's min-RTT filter
+    static constexpr uint32_t RESTART_WINDOW_SEGMENTS = 10;         // IW (RFC 6928)
+
+private:
+    ColdFlowTable(const ColdFlowTable&) = delete;
+    ColdFlowTable& operator=(const ColdFlowTable&) = delete;
+
+    // Linux tcp_cwnd_restart on the summary
+    void RestartAfterIdle(ColdFlowSummary& summary, uint64_t idleUs) const;
+
+    uint64_t m_idleTimeoutUs;
+    std::vector<ColdFlowSummary> m_slots;
+    std::vector<uint32_t> m_freeSlots;      // Released handles, reused first
+    std::map<uint8_t, CongestionControlFactory> m_factories;   // by CongestionAlgorithm
+};
+
+#endif // COLD_FLOW_TABLE_H
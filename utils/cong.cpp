@@ -0,0 +1,207 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 10:05:12
+@Description: Congestion Control Framework - Base class implementation
+@Language: C++17
+*/
+
+#include "cong.h"
+#include "probes.h"
+
+#include <algorithm>
+
+// Default socket state: one MSS window, no RTT measurements yet
+SocketState::SocketState()
+    : tcp_state_(TCPState::Open),
+      congestion_event_(CongestionEvent::SlowStart),
+      cwnd_(1460),
+      ssthresh_(0x7fffffff),
+      max_cwnd_(65535),
+      mss_bytes_(1460),
+      rtt_us_(0),
+      rto_us_(1000000),             // 1s initial RTO (RFC 6298)
+      rtt_var_(0),
+      now_us_(0),                   // callers without a clock leave it unset
+      lost_bytes_(0),
+      ecn_ce_segments_(0),          // no ECN feedback unless the caller counts it
+      app_limited_(false),
+      histograms_(nullptr)          // histograms disabled
+{
+}
+
+// Event time from the caller, or the local clock when none is provided
+uint64_t SocketState::NowUs() const {
+    if (now_us_ != 0) {
+        return now_us_;
+    }
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Constructor
+CongestionControl::CongestionControl(TypeId type_id, std::string algorithm_name)
+    : m_typeId(type_id),
+      m_algorithmName(std::move(algorithm_name)),
+      m_tcpState(TCPState::Open),
+      m_congestionEvent(CongestionEvent::SlowStart),
+      m_cwnd(0),
+      m_ssthresh(0x7fffffff),
+      m_maxCwnd(65535),
+      m_segmentSize(1460),
+      m_initialCwnd(0),
+      m_rttUs(0),
+      m_rtoUs(0),
+      m_rttVar(0),
+      m_minRtt(0xFFFFFFFF),
+      m_bytesInFlight(0),
+      m_segmentsAcked(0),
+      m_congControlEnabled(true)
+{
+}
+
+// Get type ID
+TypeId CongestionControl::GetTypeId() {
+    return m_typeId;
+}
+
+// Set type ID
+void CongestionControl::SetTypeId(TypeId type_id) {
+    m_typeId = type_id;
+}
+
+// Default: no window growth
+void CongestionControl::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+}
+
+// Default: ignore ACK information
+void CongestionControl::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+}
+
+// Default: only record the new state
+void CongestionControl::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    socket->tcp_state_ = congestionState;
+}
+
+// Default: only record the event
+void CongestionControl::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    CC_PROBE_CWND_EVENT(cwnd_event, socket, congestionEvent);
+    socket->congestion_event_ = congestionEvent;
+}
+
+// Default: the algorithm does not implement CongControl
+bool CongestionControl::HasCongControl() const {
+    return false;
+}
+
+// Default: nothing to do
+void CongestionControl::CongControl(std::unique_ptr<SocketState>& socket,
+                                    const CongestionEvent& congestionEvent,
+                                    const RTTSample& rtt) {
+}
+
+// Default: derive a rate from cwnd and RTT
+uint32_t CongestionControl::GetSendQuantum(const std::unique_ptr<SocketState>& socket) const {
+    if (socket == nullptr) {
+        return 0;
+    }
+    if (socket->rtt_us_ == 0) {
+        return socket->mss_bytes_;
+    }
+    return SendQuantumForRate(WindowPacingRate(*socket), socket->mss_bytes_);
+}
+
+// Default: window-derived pacing
+CcDecision CongestionControl::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    CcDecision decision;
+    if (socket == nullptr) {
+        return decision;
+    }
+
+    decision.cwnd = socket->cwnd_;
+    decision.pacing_rate = WindowPacingRate(*socket);
+    decision.send_quantum = GetSendQuantum(socket);
+    decision.app_limited = socket->app_limited_;
+
+    // A window pinned at max_cwnd_ no longer needs the slow start ACK clock
+    bool slowStart = socket->cwnd_ < socket->ssthresh_ && socket->cwnd_ + socket->mss_bytes_ <= socket->max_cwnd_;
+    FillAckFrequency(decision, socket->mss_bytes_, socket->rtt_us_, slowStart);
+    return decision;
+}
+
+// Default: window-derived bandwidth and the latest RTT
+CcModelSnapshot CongestionControl::GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const {
+    CcModelSnapshot snapshot;
+    if (socket == nullptr || socket->rtt_us_ == 0) {
+        return snapshot;
+    }
+
+    snapshot.bandwidth = static_cast<uint64_t>(socket->cwnd_) * 1000000 / socket->rtt_us_;
+    snapshot.min_rtt_us = socket->rtt_us_;
+    return snapshot;
+}
+
+// Default: window-based algorithms keep everything in SocketState
+void CongestionControl::RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) {
+}
+
+// Default: only INT-driven algorithms use ACK metadata
+void CongestionControl::OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) {
+}
+
+// Linux tcp_tso_autosize / BBR send_quantum
+uint32_t CongestionControl::SendQuantumForRate(uint64_t pacingRate, uint32_t mss) {
+    if (mss == 0) {
+        return 0;
+    }
+    if (pacingRate < SEND_QUANTUM_LOW_RATE) {
+        return mss;
+    }
+    if (pacingRate < SEND_QUANTUM_MID_RATE) {
+        return 2 * mss;
+    }
+
+    // About 1ms worth of data (rate >> 10, as sk_pacing_shift does)
+    uint64_t bytes = std::min<uint64_t>(pacingRate >> 10, MAX_SEND_QUANTUM);
+    uint64_t segments = std::max<uint64_t>(bytes / mss, 2);
+    return static_cast<uint32_t>(segments * mss);
+}
+
+// Linux tcp_update_pacing_rate
+uint64_t CongestionControl::WindowPacingRate(const SocketState& socket) {
+    if (socket.rtt_us_ == 0) {
+        return 0;
+    }
+
+    uint64_t ratio = socket.cwnd_ < socket.ssthresh_ ? PACING_SS_RATIO : PACING_CA_RATIO;
+    return static_cast<uint64_t>(socket.cwnd_) * 1000000 * ratio / 100 / socket.rtt_us_;
+}
+
+// draft-ietf-quic-ack-frequency: Ack-Eliciting Threshold and Requested Max Ack Delay
+void CongestionControl::FillAckFrequency(CcDecision& decision, uint32_t mss, uint32_t minRttUs, bool slowStart) {
+    decision.ack_ratio = MIN_ACK_RATIO;
+    decision.max_ack_delay_us = MAX_ACK_DELAY_US;
+    if (minRttUs > 0) {
+        decision.max_ack_delay_us = std::min(std::max<uint64_t>(minRttUs / 4, MIN_ACK_DELAY_US), MAX_ACK_DELAY_US);
+    }
+
+    // Slow start needs a dense ACK clock to double the window
+    if (slowStart || mss == 0) {
+        return;
+    }
+
+    uint64_t ratio = decision.cwnd / mss / ACKS_PER_WINDOW;
+
+    // Fill the ratio before the ACK timer would fire
+    if (decision.pacing_rate > 0) {
+        ratio = std::min<uint64_t>(ratio, decision.pacing_rate * decision.max_ack_delay_us / 1000000 / mss);
+    }
+    decision.ack_ratio = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(ratio, MIN_ACK_RATIO), MAX_ACK_RATIO));
+}
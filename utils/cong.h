@@ -8,13 +8,21 @@
 #ifndef CONG_H
 #define CONG_H
 
+#include "histogram.h"
+
 #include <cstdint>
 #include <chrono>
+#include <functional>
 #include <string>
 #include <memory>
 
 using TypeId = uint64_t;
 
+class CongestionControl;
+
+// Builds a congestion control instance
+using CongestionControlFactory = std::function<std::unique_ptr<CongestionControl>()>;
+
 // TCP connection states
 enum class TCPState {
     Open,     // normal state
@@ -32,6 +40,11 @@ enum class CongestionAlgorithm {
     DCTCP,
     RENO,
     VEGAS,
+    COPA,
+    SWIFT,
+    HPCC,
+    TIMELY,
+    LEDBAT,
 };
 
 // Congestion event types
@@ -53,6 +66,26 @@ struct RTTSample {
     RTTSample(std::chrono::microseconds r = std::chrono::microseconds(0)) : rtt(r) {}
 };
 
+// In-band network telemetry of one switch egress port (HPCC INT record)
+struct IntHop {
+    uint64_t timestamp_us;      // time the packet left the port
+    uint64_t tx_bytes;          // bytes the port has sent so far
+    uint64_t link_rate_bps;     // port capacity (bits/sec), 0 = no record
+    uint32_t queue_bytes;       // port queue length after the packet left
+
+    IntHop() : timestamp_us(0), tx_bytes(0), link_rate_bps(0), queue_bytes(0) {}
+};
+
+// Per-ACK information beyond the RTT sample, echoed from the acknowledged data packet
+struct AckMetadata {
+    static constexpr uint32_t MAX_INT_HOPS = 5;
+
+    IntHop hops[MAX_INT_HOPS];  // INT records in path order
+    uint32_t hop_count;         // 0 = no INT on the path
+
+    AckMetadata() : hop_count(0) {}
+};
+
 // Basic congestion control parameters
 struct BasicCongestionParams {
     uint32_t mss;               // maximum segment size
@@ -61,6 +94,29 @@ struct BasicCongestionParams {
     BasicCongestionParams() : mss(1460), max_cwnd(65535) {}
 };
 
+// Everything a sender needs from the algorithm after an update (cong_control style)
+struct CcDecision {
+    uint32_t cwnd;              // congestion window (bytes)
+    uint64_t pacing_rate;       // bytes per second, 0 = no RTT yet
+    uint32_t send_quantum;      // bytes handed to the NIC per burst
+    uint32_t ack_ratio;         // packets per ACK the receiver should aim for
+    uint64_t max_ack_delay_us;  // longest the receiver should hold an ACK
+    bool app_limited;           // the flow is limited by the application, not cwnd
+    uint8_t mode;               // algorithm state machine mode + 1 (BBRMode / CopaMode), 0 = none
+
+    CcDecision()
+        : cwnd(0), pacing_rate(0), send_quantum(0), ack_ratio(2), max_ack_delay_us(25000),
+          app_limited(false), mode(0) {}
+};
+
+// Path model an algorithm can carry across a rebuild (e.g. a cold-flow summary)
+struct CcModelSnapshot {
+    uint64_t bandwidth;         // bytes per second, 0 = unknown
+    uint32_t min_rtt_us;        // 0 = unknown
+
+    CcModelSnapshot() : bandwidth(0), min_rtt_us(0) {}
+};
+
 
 class SocketState {
 public: 
@@ -76,6 +132,23 @@ public:
     uint32_t rtt_us_;
     uint32_t rto_us_;
     uint32_t rtt_var_;
+    uint64_t now_us_;               // event time set by the caller (microseconds), 0 = not provided
+    uint64_t lost_bytes_;           // cumulative bytes declared lost by the caller, 0 = not tracked
+    uint32_t ecn_ce_segments_;      // CE-marked segments covered by the current ACK, set before PktsAcked()
+    bool app_limited_;              // set by the caller when it ran out of data before cwnd
+
+    FlowHistograms* histograms_;    // optional per-flow RTT/cwnd histograms (not owned)
+
+    // Event time in microseconds: now_us_ when the caller sets it, the local steady clock otherwise
+    uint64_t NowUs() const;
+
+    // Record an RTT sample and the current cwnd when histograms are attached
+    inline void RecordHistograms(uint32_t rttUs) {
+        if (histograms_ != nullptr) {
+            histograms_->rtt_us.Record(rttUs);
+            histograms_->cwnd_bytes.Record(cwnd_);
+        }
+    }
 };
 
 // Congestion control base class (pure virtual) - contains only core interfaces
@@ -153,6 +226,82 @@ public:
                              const CongestionEvent& congestionEvent,
                              const RTTSample& rtt);
 
+    /**
+     * @brief Get the send quantum, the most the sender should hand to the
+     *        NIC in one burst (one TSO/GSO super-packet).
+     *
+     * The default paces window-based algorithms at cwnd / RTT x 1.2
+     * (x 2 in slow start), like Linux does for flows without a pacing rate.
+     *
+     * @param socket internal congestion state
+     * @return send quantum in bytes, a multiple of the MSS
+     */
+    virtual uint32_t GetSendQuantum(const std::unique_ptr<SocketState>& socket) const;
+
+    /**
+     * @brief Get the algorithm's current output: cwnd, pacing rate, send
+     *        quantum, ACK ratio and app-limited state.
+     *
+     * Window-based algorithms are paced at cwnd / RTT x 1.2 (x 2 in slow
+     * start); rate-based ones report their own pacing rate.
+     *
+     * @param socket internal congestion state
+     * @return decision for the next transmissions
+     */
+    virtual CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const;
+
+    /**
+     * @brief Get the path model to keep when the algorithm object is dropped.
+     *
+     * The default reports cwnd / RTT and the latest RTT; model-based
+     * algorithms report their filtered estimates.
+     *
+     * @param socket internal congestion state
+     * @return bandwidth and min RTT estimates
+     */
+    virtual CcModelSnapshot GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const;
+
+    /**
+     * @brief Seed a freshly built algorithm with a model saved by
+     *        GetModelSnapshot(). cwnd and ssthresh come from the socket.
+     *
+     * @param socket internal congestion state
+     * @param snapshot saved model, fields may be 0 (unknown)
+     */
+    virtual void RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot);
+
+    /**
+     * @brief Handle metadata carried by an ACK, such as INT records.
+     *        Called before PktsAcked() for ACKs that carry any; the
+     *        default ignores it.
+     *
+     * @param socket internal congestion state
+     * @param metadata per-ACK metadata
+     */
+    virtual void OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata);
+
+    // Send quantum for a pacing rate (bytes/sec): ~1ms of data, 1-2 MSS at low rates, at most 64KB
+    static uint32_t SendQuantumForRate(uint64_t pacingRate, uint32_t mss);
+
+    // Pacing rate (bytes/sec) of a window-based flow: cwnd / RTT x 1.2, x 2 in slow start
+    static uint64_t WindowPacingRate(const SocketState& socket);
+
+    // ACK_FREQUENCY style hint from the decision's cwnd and pacing rate:
+    // ~4 ACKs per window, no ACK held past min RTT / 4, every 2nd packet in slow start
+    static void FillAckFrequency(CcDecision& decision, uint32_t mss, uint32_t minRttUs, bool slowStart);
+
+    static constexpr uint32_t ABC_LIMIT = 2;                        // RFC 3465 L: slow start MSS per ACK
+    static constexpr uint32_t PACING_SS_RATIO = 200;                // tcp_pacing_ss_ratio
+    static constexpr uint32_t PACING_CA_RATIO = 120;                // tcp_pacing_ca_ratio
+    static constexpr uint32_t ACKS_PER_WINDOW = 4;
+    static constexpr uint32_t MIN_ACK_RATIO = 2;                    // Classic delayed ACK
+    static constexpr uint32_t MAX_ACK_RATIO = 64;
+    static constexpr uint64_t MIN_ACK_DELAY_US = 1000;
+    static constexpr uint64_t MAX_ACK_DELAY_US = 25000;             // QUIC default max_ack_delay
+    static constexpr uint32_t MAX_SEND_QUANTUM = 65536;             // GSO/TSO limit
+    static constexpr uint64_t SEND_QUANTUM_LOW_RATE = 1200000 / 8;  // Below 1.2 Mbps: 1 MSS
+    static constexpr uint64_t SEND_QUANTUM_MID_RATE = 24000000 / 8; // Below 24 Mbps: 2 MSS
+
 protected:
     // Constructor - can only be called by subclasses
     CongestionControl() = default;
@@ -0,0 +1,193 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 17:02:14
+@Description: Constant-memory log-linear histogram implementation
+@Language: C++17
+*/
+
+#include "histogram.h"
+
+#include <algorithm>
+
+namespace {
+
+// Append an unsigned LEB128 varint
+void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Read an unsigned LEB128 varint, false on truncation
+bool GetVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (pos >= size) {
+            return false;
+        }
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// Histogram constructor
+LogLinearHistogram::LogLinearHistogram() {
+    Reset();
+}
+
+// Bucket-wise sum
+void LogLinearHistogram::Merge(const LogLinearHistogram& other) {
+    if (other.m_total == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_total += other.m_total;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+// Clear all buckets
+void LogLinearHistogram::Reset() {
+    std::fill(m_counts, m_counts + BUCKET_COUNT, 0);
+    m_total = 0;
+    m_sum = 0;
+    m_min = UINT32_MAX;
+    m_max = 0;
+}
+
+// Get number of recorded values
+uint64_t LogLinearHistogram::GetCount() const {
+    return m_total;
+}
+
+// Get smallest recorded value
+uint32_t LogLinearHistogram::GetMin() const {
+    return m_total > 0 ? m_min : 0;
+}
+
+// Get largest recorded value
+uint32_t LogLinearHistogram::GetMax() const {
+    return m_max;
+}
+
+// Get exact mean
+double LogLinearHistogram::GetMean() const {
+    return m_total > 0 ? static_cast<double>(m_sum) / m_total : 0.0;
+}
+
+// Walk the buckets until the rank is reached
+uint32_t LogLinearHistogram::GetPercentile(double p) const {
+    if (m_total == 0) {
+        return 0;
+    }
+
+    p = std::min(std::max(p, 0.0), 100.0);
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(m_total) + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            return std::min(std::max(BucketHigh(i), m_min), m_max);
+        }
+    }
+    return m_max;
+}
+
+// Sparse varint encoding
+void LogLinearHistogram::Serialize(std::vector<uint8_t>& out) const {
+    out.push_back(SERIAL_VERSION);
+    PutVarint(out, m_total);
+    PutVarint(out, m_min);
+    PutVarint(out, m_max);
+    PutVarint(out, m_sum);
+
+    uint32_t last = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        if (m_counts[i] == 0) {
+            continue;
+        }
+        PutVarint(out, i - last);
+        PutVarint(out, m_counts[i]);
+        last = i;
+    }
+}
+
+// Decode, rejecting anything that does not add up
+bool LogLinearHistogram::Deserialize(const uint8_t* data, size_t size) {
+    if (data == nullptr || size == 0 || data[0] != SERIAL_VERSION) {
+        return false;
+    }
+
+    LogLinearHistogram decoded;
+    size_t pos = 1;
+    uint64_t total = 0;
+    uint64_t minValue = 0;
+    uint64_t maxValue = 0;
+    uint64_t sum = 0;
+    if (!GetVarint(data, size, pos, total) || !GetVarint(data, size, pos, minValue) ||
+        !GetVarint(data, size, pos, maxValue) || !GetVarint(data, size, pos, sum) ||
+        minValue > UINT32_MAX || maxValue > UINT32_MAX) {
+        return false;
+    }
+
+    uint64_t index = 0;
+    uint64_t counted = 0;
+    while (pos < size) {
+        uint64_t delta = 0;
+        uint64_t count = 0;
+        if (!GetVarint(data, size, pos, delta) || !GetVarint(data, size, pos, count)) {
+            return false;
+        }
+        index += delta;
+        if (index >= BUCKET_COUNT) {
+            return false;
+        }
+        decoded.m_counts[index] += count;
+        counted += count;
+    }
+
+    if (counted != total) {
+        return false;
+    }
+
+    decoded.m_total = total;
+    decoded.m_sum = sum;
+    decoded.m_min = static_cast<uint32_t>(minValue);
+    decoded.m_max = static_cast<uint32_t>(maxValue);
+    *this = decoded;
+    return true;
+}
+
+// Lower bound of a bucket
+uint32_t LogLinearHistogram::BucketLow(uint32_t index) {
+    if (index < LINEAR_LIMIT) {
+        return index;
+    }
+    uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+    uint32_t sub = index - shift * SUB_BUCKET_COUNT;
+    return sub << shift;
+}
+
+// Upper bound of a bucket
+uint32_t LogLinearHistogram::BucketHigh(uint32_t index) {
+    if (index < LINEAR_LIMIT) {
+        return index;
+    }
+    uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t sub = index - shift * SUB_BUCKET_COUNT;
+    return static_cast<uint32_t>(((sub + 1) << shift) - 1);
+}
@@ -0,0 +1,124 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 17:02:14
+@Description: Constant-memory log-linear (HDR-style) histogram for per-flow RTT and cwnd
+@Language: C++17
+*/
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Log-linear histogram over 32-bit values.
+ *
+ * Values below 64 get one bucket each; above that every power of two is
+ * split into 32 linear sub-buckets, so any value is reported within ~3%.
+ * 896 fixed buckets cover [0, 2^32), memory never grows, and Record() is
+ * a count-leading-zeros, a shift and an increment.
+ *
+ * Histograms with the same layout merge by adding buckets, so per-flow or
+ * per-core histograms can be combined into fleet-wide distributions.
+ */
+class LogLinearHistogram {
+public:
+    LogLinearHistogram();
+
+    // Record one value
+    inline void Record(uint32_t value) {
+        m_counts[BucketIndex(value)]++;
+        m_total++;
+        m_sum += value;
+        if (value < m_min) {
+            m_min = value;
+        }
+        if (value > m_max) {
+            m_max = value;
+        }
+    }
+
+    // Add every bucket of another histogram
+    void Merge(const LogLinearHistogram& other);
+
+    void Reset();
+
+    uint64_t GetCount() const;
+    uint32_t GetMin() const;
+    uint32_t GetMax() const;
+    double GetMean() const;
+
+    // Value at percentile p (0..100), reported as the bucket's upper bound
+    uint32_t GetPercentile(double p) const;
+
+    /**
+     * @brief Serialize the non-empty buckets.
+     *
+     * Layout: version, count, min, max, sum, then (index delta, count) pairs,
+     * all as LEB128 varints.
+     *
+     * @param out buffer the encoding is appended to
+     */
+    void Serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Replace the content with a serialized histogram.
+     *
+     * @return false if the buffer is truncated or malformed
+     */
+    bool Deserialize(const uint8_t* data, size_t size);
+
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;                          // 32 sub-buckets per power of two
+    static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t LINEAR_LIMIT = 2 * SUB_BUCKET_COUNT;          // values below are exact
+    static constexpr uint32_t BUCKET_COUNT = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    // Bucket of a value
+    static inline uint32_t BucketIndex(uint32_t value) {
+        if (value < LINEAR_LIMIT) {
+            return value;
+        }
+        uint32_t shift = MostSignificantBit(value) - SUB_BUCKET_BITS;
+        return shift * SUB_BUCKET_COUNT + (value >> shift);
+    }
+
+    // Smallest and largest value of a bucket
+    static uint32_t BucketLow(uint32_t index);
+    static uint32_t BucketHigh(uint32_t index);
+
+private:
+    static inline uint32_t MostSignificantBit(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 31 - static_cast<uint32_t>(__builtin_clz(value));
+#else
+        uint32_t msb = 0;
+        while (value >>= 1) {
+            msb++;
+        }
+        return msb;
+#endif
+    }
+
+    uint64_t m_counts[BUCKET_COUNT];   // Per-bucket counts
+    uint64_t m_total;                  // Recorded values
+    uint64_t m_sum;                    // Sum of recorded values
+    uint32_t m_min;
+    uint32_t m_max;
+
+    static constexpr uint8_t SERIAL_VERSION = 1;
+};
+
+// Per-flow distributions, attached to SocketState::histograms_
+struct FlowHistograms {
+    LogLinearHistogram rtt_us;          // RTT samples (microseconds)
+    LogLinearHistogram cwnd_bytes;      // cwnd at each ACK
+
+    void Merge(const FlowHistograms& other) {
+        rtt_us.Merge(other.rtt_us);
+        cwnd_bytes.Merge(other.cwnd_bytes);
+    }
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,331 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 19:12:26
+@Description: Sampled per-method CPU cycle accounting implementation
+@Language: C++17
+*/
+
+#include "instrumented_cc.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// Process-wide registry
+CycleCostRegistry& CycleCostRegistry::Instance() {
+    static CycleCostRegistry registry;
+    return registry;
+}
+
+// One counter block per hardware thread
+CycleCostRegistry::CycleCostRegistry()
+    : m_timerOverhead(0)
+{
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < cores; i++) {
+        auto block = std::make_unique<CoreCounters>();
+        for (int a = 0; a < MAX_ALGORITHMS; a++) {
+            for (int m = 0; m < METHOD_COUNT; m++) {
+                block->samples[a][m].store(0, std::memory_order_relaxed);
+                block->calls[a][m].store(0, std::memory_order_relaxed);
+                block->cycles[a][m].store(0, std::memory_order_relaxed);
+            }
+        }
+        m_cores.push_back(std::move(block));
+    }
+
+    for (int a = 0; a < MAX_ALGORITHMS; a++) {
+        for (int m = 0; m < METHOD_COUNT; m++) {
+            m_lastSamples[a][m] = 0;
+            m_lastCalls[a][m] = 0;
+            m_lastCycles[a][m] = 0;
+        }
+    }
+
+    // Calibrate: minimum of many empty measurements
+    uint64_t overhead = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t start = ReadCycles();
+        overhead = std::min(overhead, ReadCycles() - start);
+    }
+    m_timerOverhead = overhead;
+}
+
+// Find or assign the slot of an algorithm
+int CycleCostRegistry::Register(const std::string& algorithm) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (size_t i = 0; i < m_algorithms.size(); i++) {
+        if (m_algorithms[i] == algorithm) {
+            return static_cast<int>(i);
+        }
+    }
+
+    if (m_algorithms.size() >= MAX_ALGORITHMS) {
+        return -1;
+    }
+    m_algorithms.push_back(algorithm);
+    return static_cast<int>(m_algorithms.size()) - 1;
+}
+
+// Account one timed call on the current core
+void CycleCostRegistry::Add(int slot, CcMethod method, uint64_t cycles, uint32_t period) {
+    if (slot < 0 || slot >= MAX_ALGORITHMS) {
+        return;
+    }
+
+    int m = static_cast<int>(method);
+    cycles = cycles > m_timerOverhead ? cycles - m_timerOverhead : 0;
+    CoreCounters& core = CurrentCore();
+    core.samples[slot][m].fetch_add(1, std::memory_order_relaxed);
+    core.calls[slot][m].fetch_add(period, std::memory_order_relaxed);
+    core.cycles[slot][m].fetch_add(cycles, std::memory_order_relaxed);
+}
+
+// Sum all cores and report the change since the previous collection
+std::vector<CycleCostEntry> CycleCostRegistry::Collect() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<CycleCostEntry> entries;
+
+    for (size_t a = 0; a < m_algorithms.size(); a++) {
+        for (int m = 0; m < METHOD_COUNT; m++) {
+            uint64_t samples = 0;
+            uint64_t calls = 0;
+            uint64_t cycles = 0;
+            for (const auto& core : m_cores) {
+                samples += core->samples[a][m].load(std::memory_order_relaxed);
+                calls += core->calls[a][m].load(std::memory_order_relaxed);
+                cycles += core->cycles[a][m].load(std::memory_order_relaxed);
+            }
+
+            uint64_t deltaSamples = samples - m_lastSamples[a][m];
+            uint64_t deltaCalls = calls - m_lastCalls[a][m];
+            uint64_t deltaCycles = cycles - m_lastCycles[a][m];
+            m_lastSamples[a][m] = samples;
+            m_lastCalls[a][m] = calls;
+            m_lastCycles[a][m] = cycles;
+
+            if (deltaSamples == 0) {
+                continue;
+            }
+
+            CycleCostEntry entry;
+            entry.algorithm = m_algorithms[a];
+            entry.method = static_cast<CcMethod>(m);
+            entry.calls = deltaCalls;
+            entry.samples = deltaSamples;
+            entry.cycles_per_call = static_cast<double>(deltaCycles) / static_cast<double>(deltaSamples);
+            entries.push_back(entry);
+        }
+    }
+
+    return entries;
+}
+
+// Get calibrated timer overhead
+uint64_t CycleCostRegistry::GetTimerOverhead() const {
+    return m_timerOverhead;
+}
+
+// PktsAcked + IncreaseWindow, the per-ACK path
+double CycleCostRegistry::CyclesPerAck(const std::vector<CycleCostEntry>& entries, const std::string& algorithm) {
+    double cycles = 0.0;
+    for (const auto& entry : entries) {
+        if (entry.algorithm == algorithm &&
+            (entry.method == CcMethod::PktsAcked || entry.method == CcMethod::IncreaseWindow)) {
+            cycles += entry.cycles_per_call;
+        }
+    }
+    return cycles;
+}
+
+// Counter block of the CPU we are running on
+CycleCostRegistry::CoreCounters& CycleCostRegistry::CurrentCore() {
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return *m_cores[static_cast<size_t>(cpu) % m_cores.size()];
+    }
+#endif
+    size_t index = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return *m_cores[index % m_cores.size()];
+}
+
+// Instrumented wrapper constructor
+InstrumentedCongestionControl::InstrumentedCongestionControl(std::unique_ptr<CongestionControl> inner,
+                                                             uint32_t samplePeriod)
+    : CongestionControl(inner != nullptr ? inner->GetTypeId() : 0,
+                        inner != nullptr ? inner->GetAlgorithmName() : std::string()),
+      m_inner(std::move(inner)),
+      m_slot(-1),
+      m_samplePeriod(1),
+      m_sampleMask(0)
+{
+    // Round the period up to a power of two so sampling is a mask test
+    while (m_samplePeriod < samplePeriod && m_samplePeriod < (1u << 31)) {
+        m_samplePeriod <<= 1;
+    }
+    m_sampleMask = m_samplePeriod - 1;
+
+    for (int m = 0; m < CycleCostRegistry::METHOD_COUNT; m++) {
+        m_calls[m] = 0;
+    }
+
+    if (m_inner != nullptr) {
+        m_slot = CycleCostRegistry::Instance().Register(m_inner->GetAlgorithmName());
+    }
+}
+
+// Destructor
+InstrumentedCongestionControl::~InstrumentedCongestionControl() {
+    // m_inner is released by unique_ptr
+}
+
+// Forward GetSendQuantum (not timed, it is called per send rather than per ACK)
+uint32_t InstrumentedCongestionControl::GetSendQuantum(const std::unique_ptr<SocketState>& socket) const {
+    if (m_inner == nullptr) {
+        return CongestionControl::GetSendQuantum(socket);
+    }
+    return m_inner->GetSendQuantum(socket);
+}
+
+// Forward GetDecision (not timed)
+CcDecision InstrumentedCongestionControl::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    if (m_inner == nullptr) {
+        return CongestionControl::GetDecision(socket);
+    }
+    return m_inner->GetDecision(socket);
+}
+
+// Forward GetModelSnapshot (not timed)
+CcModelSnapshot InstrumentedCongestionControl::GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const {
+    if (m_inner == nullptr) {
+        return CongestionControl::GetModelSnapshot(socket);
+    }
+    return m_inner->GetModelSnapshot(socket);
+}
+
+// Forward RestoreModel (not timed)
+void InstrumentedCongestionControl::RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) {
+    if (m_inner != nullptr) {
+        m_inner->RestoreModel(socket, snapshot);
+    }
+}
+
+// Forward OnAckMetadata (not timed)
+void InstrumentedCongestionControl::OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) {
+    if (m_inner != nullptr) {
+        m_inner->OnAckMetadata(socket, metadata);
+    }
+}
+
+// Get wrapped algorithm name
+std::string InstrumentedCongestionControl::GetAlgorithmName() {
+    return m_inner != nullptr ? m_inner->GetAlgorithmName() : std::string();
+}
+
+// Forward GetSsThresh
+uint32_t InstrumentedCongestionControl::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    if (m_inner == nullptr) {
+        return 0;
+    }
+    if (!ShouldSample(CcMethod::GetSsThresh)) {
+        return m_inner->GetSsThresh(socket, bytesInFlight);
+    }
+
+    uint64_t start = CycleCostRegistry::ReadCycles();
+    uint32_t ssthresh = m_inner->GetSsThresh(socket, bytesInFlight);
+    CycleCostRegistry::Instance().Add(m_slot, CcMethod::GetSsThresh, CycleCostRegistry::ReadCycles() - start, m_samplePeriod);
+    return ssthresh;
+}
+
+// Forward IncreaseWindow
+void InstrumentedCongestionControl::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+    if (m_inner == nullptr) {
+        return;
+    }
+    if (!ShouldSample(CcMethod::IncreaseWindow)) {
+        m_inner->IncreaseWindow(socket, segmentsAcked);
+        return;
+    }
+
+    uint64_t start = CycleCostRegistry::ReadCycles();
+    m_inner->IncreaseWindow(socket, segmentsAcked);
+    CycleCostRegistry::Instance().Add(m_slot, CcMethod::IncreaseWindow, CycleCostRegistry::ReadCycles() - start, m_samplePeriod);
+}
+
+// Forward PktsAcked
+void InstrumentedCongestionControl::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+    if (m_inner == nullptr) {
+        return;
+    }
+    if (!ShouldSample(CcMethod::PktsAcked)) {
+        m_inner->PktsAcked(socket, segmentsAcked, rtt);
+        return;
+    }
+
+    uint64_t start = CycleCostRegistry::ReadCycles();
+    m_inner->PktsAcked(socket, segmentsAcked, rtt);
+    CycleCostRegistry::Instance().Add(m_slot, CcMethod::PktsAcked, CycleCostRegistry::ReadCycles() - start, m_samplePeriod);
+}
+
+// Forward CongestionStateSet
+void InstrumentedCongestionControl::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (m_inner == nullptr) {
+        return;
+    }
+    if (!ShouldSample(CcMethod::CongestionStateSet)) {
+        m_inner->CongestionStateSet(socket, congestionState);
+        return;
+    }
+
+    uint64_t start = CycleCostRegistry::ReadCycles();
+    m_inner->CongestionStateSet(socket, congestionState);
+    CycleCostRegistry::Instance().Add(m_slot, CcMethod::CongestionStateSet, CycleCostRegistry::ReadCycles() - start, m_samplePeriod);
+}
+
+// Forward CwndEvent
+void InstrumentedCongestionControl::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (m_inner == nullptr) {
+        return;
+    }
+    if (!ShouldSample(CcMethod::CwndEvent)) {
+        m_inner->CwndEvent(socket, congestionEvent);
+        return;
+    }
+
+    uint64_t start = CycleCostRegistry::ReadCycles();
+    m_inner->CwndEvent(socket, congestionEvent);
+    CycleCostRegistry::Instance().Add(m_slot, CcMethod::CwndEvent, CycleCostRegistry::ReadCycles() - start, m_samplePeriod);
+}
+
+// Forward HasCongControl
+bool InstrumentedCongestionControl::HasCongControl() const {
+    return m_inner != nullptr && m_inner->HasCongControl();
+}
+
+// Forward CongControl
+void InstrumentedCongestionControl::CongControl(std::unique_ptr<SocketState>& socket,
+                                                const CongestionEvent& congestionEvent,
+                                                const RTTSample& rtt) {
+    if (m_inner == nullptr) {
+        return;
+    }
+    if (!ShouldSample(CcMethod::CongControl)) {
+        m_inner->CongControl(socket, congestionEvent, rtt);
+        return;
+    }
+
+    uint64_t start = CycleCostRegistry::ReadCycles();
+    m_inner->CongControl(socket, congestionEvent, rtt);
+    CycleCostRegistry::Instance().Add(m_slot, CcMethod::CongControl, CycleCostRegistry::ReadCycles() - start, m_samplePeriod);
+}
+
+// Get wrapped algorithm
+CongestionControl* InstrumentedCongestionControl::GetInner() const {
+    return m_inner.get();
+}
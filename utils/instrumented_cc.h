@@ -0,0 +1,183 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 19:12:26
+@Description: Sampled per-method CPU cycle accounting for congestion control algorithms
+@Language: C++17
+*/
+
+#ifndef INSTRUMENTED_CC_H
+#define INSTRUMENTED_CC_H
+
+#include "cong.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Instrumented CongestionControl methods
+enum class CcMethod {
+    GetSsThresh,
+    IncreaseWindow,
+    PktsAcked,
+    CongestionStateSet,
+    CwndEvent,
+    CongControl,
+    Count
+};
+
+// Aggregated cost of one method of one algorithm
+struct CycleCostEntry {
+    std::string algorithm;
+    CcMethod method;
+    uint64_t calls;             // estimated calls (samples x sampling period)
+    uint64_t samples;           // timed calls
+    double cycles_per_call;     // mean over the timed calls
+};
+
+/*
+ * Process-wide cycle counters.
+ *
+ * Counters are kept per core (one cache-line aligned block per CPU) so
+ * sampled updates from different cores never share a line. Collect()
+ * sums all cores and returns the cost accumulated since the previous
+ * Collect(), so calling it periodically yields per-interval figures that
+ * can be compared against an alert threshold.
+ */
+class CycleCostRegistry {
+public:
+    static CycleCostRegistry& Instance();
+
+    // Slot of an algorithm, registering it on first use (-1 if full)
+    int Register(const std::string& algorithm);
+
+    // Add one timed call, standing for `period` calls
+    void Add(int slot, CcMethod method, uint64_t cycles, uint32_t period);
+
+    // Per-method cost since the previous call to Collect()
+    std::vector<CycleCostEntry> Collect();
+
+    /**
+     * @brief Cycles one ACK costs an algorithm.
+     *
+     * @param entries result of Collect()
+     * @param algorithm algorithm name
+     * @return mean PktsAcked + IncreaseWindow cycles, 0 if not sampled
+     */
+    static double CyclesPerAck(const std::vector<CycleCostEntry>& entries, const std::string& algorithm);
+
+    // Read the cycle counter (rdtsc on x86, cntvct on aarch64, ns elsewhere)
+    static inline uint64_t ReadCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_lfence();
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Cost of two back-to-back ReadCycles(), subtracted from every sample
+    uint64_t GetTimerOverhead() const;
+
+    static constexpr int MAX_ALGORITHMS = 16;
+    static constexpr int METHOD_COUNT = static_cast<int>(CcMethod::Count);
+
+private:
+    CycleCostRegistry();
+    CycleCostRegistry(const CycleCostRegistry&) = delete;
+    CycleCostRegistry& operator=(const CycleCostRegistry&) = delete;
+
+    struct alignas(64) CoreCounters {
+        std::atomic<uint64_t> samples[MAX_ALGORITHMS][METHOD_COUNT];
+        std::atomic<uint64_t> calls[MAX_ALGORITHMS][METHOD_COUNT];
+        std::atomic<uint64_t> cycles[MAX_ALGORITHMS][METHOD_COUNT];
+    };
+
+    CoreCounters& CurrentCore();
+
+    std::vector<std::unique_ptr<CoreCounters>> m_cores;
+    uint64_t m_timerOverhead;                   // Calibrated at start-up
+    std::mutex m_mutex;                         // Guards registration and collection
+    std::vector<std::string> m_algorithms;      // Registered names by slot
+
+    // Totals at the previous Collect()
+    uint64_t m_lastSamples[MAX_ALGORITHMS][METHOD_COUNT];
+    uint64_t m_lastCalls[MAX_ALGORITHMS][METHOD_COUNT];
+    uint64_t m_lastCycles[MAX_ALGORITHMS][METHOD_COUNT];
+};
+
+/*
+ * CongestionControl decorator that times one call in every N with the
+ * CPU cycle counter and forwards everything to the wrapped algorithm.
+ * Untimed calls cost one counter increment and a branch.
+ */
+class InstrumentedCongestionControl: public CongestionControl {
+public:
+    /**
+     * @param inner algorithm to wrap (owned)
+     * @param samplePeriod time one call in every `samplePeriod` (rounded up to a power of two)
+     */
+    explicit InstrumentedCongestionControl(std::unique_ptr<CongestionControl> inner,
+                                           uint32_t samplePeriod = DEFAULT_SAMPLE_PERIOD);
+    ~InstrumentedCongestionControl() override;
+
+    std::string GetAlgorithmName() override;
+
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
+    void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
+
+    void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
+
+    void CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) override;
+
+    void CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) override;
+
+    bool HasCongControl() const override;
+
+    void CongControl(std::unique_ptr<SocketState>& socket,
+                     const CongestionEvent& congestionEvent,
+                     const RTTSample& rtt) override;
+
+    uint32_t GetSendQuantum(const std::unique_ptr<SocketState>& socket) const override;
+
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    CcModelSnapshot GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const override;
+
+    void RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) override;
+
+    void OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) override;
+
+    // Wrapped algorithm
+    CongestionControl* GetInner() const;
+
+    static constexpr uint32_t DEFAULT_SAMPLE_PERIOD = 64;
+
+private:
+    InstrumentedCongestionControl(const InstrumentedCongestionControl&) = delete;
+    InstrumentedCongestionControl& operator=(const InstrumentedCongestionControl&) = delete;
+
+    // True for the one call in every period that is timed
+    inline bool ShouldSample(CcMethod method) {
+        return (++m_calls[static_cast<int>(method)] & m_sampleMask) == 0;
+    }
+
+    std::unique_ptr<CongestionControl> m_inner;    // Wrapped algorithm
+    int m_slot;                                    // Registry slot of the algorithm
+    uint32_t m_samplePeriod;                       // Power of two
+    uint32_t m_sampleMask;                         // m_samplePeriod - 1
+    uint32_t m_calls[CycleCostRegistry::METHOD_COUNT];  // Per-method call counters
+};
+
+#endif // INSTRUMENTED_CC_H
@@ -0,0 +1,228 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 21:10:44
+@Description: Young-flow wrapper that builds the full congestion control state lazily
+@Language: C++17
+*/
+
+#include "lazy_cc.h"
+
+#include <algorithm>
+
+// Constructor
+LazyCongestionControl::LazyCongestionControl(TypeId typeId, std::string algorithmName, CongestionControlFactory factory,
+                                             uint32_t materializeRounds, uint64_t materializeBytes)
+    : CongestionControl(typeId, algorithmName),
+      m_factory(std::move(factory)),
+      m_algorithmName(std::move(algorithmName)),
+      m_materializeRounds(materializeRounds),
+      m_materializeBytes(materializeBytes),
+      m_bytesAcked(0),              // Nothing acknowledged yet
+      m_roundEndBytes(0),           // First ACK starts round 1
+      m_rounds(0),
+      m_lastRoundMinRtt(0),
+      m_roundMinRtt(0)
+{
+}
+
+// Destructor
+LazyCongestionControl::~LazyCongestionControl() {
+    // m_inner is released by unique_ptr
+}
+
+// Name of the wrapped algorithm, known before it is built
+std::string LazyCongestionControl::GetAlgorithmName() {
+    return m_algorithmName;
+}
+
+// Young flows halve the window like Reno
+uint32_t LazyCongestionControl::GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) {
+    if (m_inner != nullptr) {
+        return m_inner->GetSsThresh(socket, bytesInFlight);
+    }
+    if (socket == nullptr) {
+        return 0;
+    }
+    return std::max(socket->cwnd_ / 2, 2 * socket->mss_bytes_);
+}
+
+// Shared slow start while young
+void LazyCongestionControl::IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) {
+    if (m_inner != nullptr) {
+        m_inner->IncreaseWindow(socket, segmentsAcked);
+        return;
+    }
+    if (socket == nullptr || segmentsAcked == 0) {
+        return;
+    }
+
+    // RFC 3465 slow start, stopping at ssthresh; the next ACK hands the flow over
+    uint32_t limit = std::min(socket->ssthresh_, socket->max_cwnd_);
+    uint32_t increase = std::min(segmentsAcked, ABC_LIMIT) * socket->mss_bytes_;
+    if (socket->cwnd_ < limit) {
+        socket->cwnd_ = std::min(socket->cwnd_ + increase, limit);
+    }
+}
+
+// Count rounds and bytes; build the algorithm once the flow is no longer young
+void LazyCongestionControl::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) {
+    if (socket == nullptr) {
+        return;
+    }
+
+    if (m_inner == nullptr) {
+        // A round ends once a window's worth of data sent after it began is acknowledged
+        if (m_bytesAcked >= m_roundEndBytes) {
+            m_rounds++;
+            m_roundEndBytes = m_bytesAcked + socket->cwnd_;
+            if (m_roundMinRtt > 0) {
+                m_lastRoundMinRtt = m_roundMinRtt;
+            }
+            m_roundMinRtt = 0;
+        }
+        m_bytesAcked += static_cast<uint64_t>(segmentsAcked) * socket->mss_bytes_;
+        if (rtt > 0 && (m_roundMinRtt == 0 || rtt < m_roundMinRtt)) {
+            m_roundMinRtt = static_cast<uint32_t>(rtt);
+        }
+
+        // HyStart++: the round's RTT rose by clamp(lastRoundMinRTT / 8, 4ms, 16ms)
+        bool delayIncrease = false;
+        if (m_lastRoundMinRtt > 0 && m_roundMinRtt > 0) {
+            uint32_t thresh = std::min(std::max(m_lastRoundMinRtt / 8, MIN_RTT_THRESH_US), MAX_RTT_THRESH_US);
+            delayIncrease = m_roundMinRtt >= m_lastRoundMinRtt + thresh;
+        }
+
+        if (m_rounds > m_materializeRounds || m_bytesAcked >= m_materializeBytes || delayIncrease ||
+            socket->cwnd_ >= std::min(socket->ssthresh_, socket->max_cwnd_)) {
+            Materialize();
+        }
+    }
+    if (m_inner != nullptr) {
+        m_inner->PktsAcked(socket, segmentsAcked, rtt);
+        return;
+    }
+
+    // Young flows only keep the RTT estimate
+    socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
+    if (socket->rtt_var_ == 0) {
+        socket->rtt_var_ = rtt / 2;
+    } else {
+        socket->rtt_var_ = (3 * socket->rtt_var_ + rtt) / 4;
+    }
+    socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
+}
+
+// Forward CongestionStateSet, or only record the state
+void LazyCongestionControl::CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) {
+    if (m_inner != nullptr) {
+        m_inner->CongestionStateSet(socket, congestionState);
+        return;
+    }
+    CongestionControl::CongestionStateSet(socket, congestionState);
+}
+
+// The first congestion signal hands the flow to the full algorithm
+void LazyCongestionControl::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) {
+    if (m_inner == nullptr) {
+        switch (congestionEvent) {
+            case CongestionEvent::PacketLoss:
+            case CongestionEvent::Timeout:
+            case CongestionEvent::ECN:
+            case CongestionEvent::FastRecovery:
+                Materialize();
+                break;
+
+            default:
+                break;
+        }
+    }
+    if (m_inner != nullptr) {
+        m_inner->CwndEvent(socket, congestionEvent);
+        return;
+    }
+    CongestionControl::CwndEvent(socket, congestionEvent);
+}
+
+// Forward HasCongControl
+bool LazyCongestionControl::HasCongControl() const {
+    return m_inner != nullptr && m_inner->HasCongControl();
+}
+
+// Forward CongControl
+void LazyCongestionControl::CongControl(std::unique_ptr<SocketState>& socket,
+                                        const CongestionEvent& congestionEvent,
+                                        const RTTSample& rtt) {
+    if (m_inner != nullptr) {
+        m_inner->CongControl(socket, congestionEvent, rtt);
+    }
+}
+
+// Forward GetSendQuantum, window-derived while young
+uint32_t LazyCongestionControl::GetSendQuantum(const std::unique_ptr<SocketState>& socket) const {
+    if (m_inner != nullptr) {
+        return m_inner->GetSendQuantum(socket);
+    }
+    return CongestionControl::GetSendQuantum(socket);
+}
+
+// Forward GetDecision, window-derived while young
+CcDecision LazyCongestionControl::GetDecision(const std::unique_ptr<SocketState>& socket) const {
+    if (m_inner != nullptr) {
+        return m_inner->GetDecision(socket);
+    }
+    return CongestionControl::GetDecision(socket);
+}
+
+// Forward GetModelSnapshot, window-derived while young
+CcModelSnapshot LazyCongestionControl::GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const {
+    if (m_inner != nullptr) {
+        return m_inner->GetModelSnapshot(socket);
+    }
+    return CongestionControl::GetModelSnapshot(socket);
+}
+
+// Build the algorithm and forward RestoreModel
+void LazyCongestionControl::RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) {
+    Materialize();
+    if (m_inner != nullptr) {
+        m_inner->RestoreModel(socket, snapshot);
+    }
+}
+
+// Forward OnAckMetadata
+void LazyCongestionControl::OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) {
+    if (m_inner != nullptr) {
+        m_inner->OnAckMetadata(socket, metadata);
+    }
+}
+
+// Check whether the algorithm is built
+bool LazyCongestionControl::IsMaterialized() const {
+    return m_inner != nullptr;
+}
+
+// Get the full algorithm
+CongestionControl* LazyCongestionControl::GetInner() const {
+    return m_inner.get();
+}
+
+// Factory of lazy wrappers
+CongestionControlFactory LazyCongestionControl::MakeFactory(TypeId typeId, std::string algorithmName,
+                                                            CongestionControlFactory factory,
+                                                            uint32_t materializeRounds, uint64_t materializeBytes) {
+    return [=]() -> std::unique_ptr<CongestionControl> {
+        return std::make_unique<LazyCongestionControl>(typeId, algorithmName, factory, materializeRounds,
+                                                       materializeBytes);
+    };
+}
+
+// Build the full algorithm
+void LazyCongestionControl::Materialize() {
+    if (m_inner != nullptr || !m_factory) {
+        return;
+    }
+
+    m_inner = m_factory();
+    m_factory = nullptr;
+}
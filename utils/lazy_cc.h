@@ -0,0 +1,118 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 11:31:08
+@Description: Young-flow wrapper that builds the full congestion control state lazily
+@Language: C++17
+*/
+
+#ifndef LAZY_CC_H
+#define LAZY_CC_H
+
+#include "cong.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/*
+ * Runs a young flow on a small built-in slow start and creates the real
+ * algorithm only when the flow turns out to need it. The wrapper itself
+ * still holds the algorithm name and a copy of the factory.
+ *
+ * While young, the flow does RFC 3465 slow start (at most ABC_LIMIT MSS
+ * per ACK) and keeps only the RTT estimate in SocketState. The full
+ * algorithm is built from the factory after `materializeRounds` rounds,
+ * `materializeBytes` bytes acknowledged, once slow start reaches
+ * ssthresh or max_cwnd_, when the RTT grows by the HyStart++ (RFC 9406)
+ * threshold, or on the first congestion signal, so its own loss response
+ * applies. The young path has no model to stop it short of the queue,
+ * so it hands over as soon as the queue starts to build.
+ *
+ * The new algorithm takes over the flow's SocketState unchanged: every
+ * algorithm picks up cwnd, ssthresh and RTT from there.
+ *
+ * Most short RPC flows finish before that and never pay for the model
+ * state (deques, histories, clock reads) of BBR, Copa or Vegas.
+ */
+class LazyCongestionControl: public CongestionControl {
+public:
+    /**
+     * @param typeId type of the algorithm the factory creates
+     * @param algorithmName name of the algorithm the factory creates
+     * @param factory builds the full algorithm
+     * @param materializeRounds young rounds before the algorithm is built
+     * @param materializeBytes acknowledged bytes before the algorithm is built
+     */
+    LazyCongestionControl(TypeId typeId, std::string algorithmName, CongestionControlFactory factory,
+                          uint32_t materializeRounds = DEFAULT_MATERIALIZE_ROUNDS,
+                          uint64_t materializeBytes = DEFAULT_MATERIALIZE_BYTES);
+    ~LazyCongestionControl() override;
+
+    std::string GetAlgorithmName() override;
+
+    uint32_t GetSsThresh(std::unique_ptr<SocketState>& socket, uint32_t bytesInFlight) override;
+
+    void IncreaseWindow(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked) override;
+
+    void PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAcked, const uint64_t rtt) override;
+
+    void CongestionStateSet(std::unique_ptr<SocketState>& socket, const TCPState congestionState) override;
+
+    void CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEvent congestionEvent) override;
+
+    bool HasCongControl() const override;
+
+    void CongControl(std::unique_ptr<SocketState>& socket,
+                     const CongestionEvent& congestionEvent,
+                     const RTTSample& rtt) override;
+
+    uint32_t GetSendQuantum(const std::unique_ptr<SocketState>& socket) const override;
+
+    CcDecision GetDecision(const std::unique_ptr<SocketState>& socket) const override;
+
+    CcModelSnapshot GetModelSnapshot(const std::unique_ptr<SocketState>& socket) const override;
+
+    // A restored flow is not young: builds the algorithm and forwards
+    void RestoreModel(std::unique_ptr<SocketState>& socket, const CcModelSnapshot& snapshot) override;
+
+    // Forwarded once built; young flows have no use for it
+    void OnAckMetadata(std::unique_ptr<SocketState>& socket, const AckMetadata& metadata) override;
+
+    // Whether the full algorithm has been built
+    bool IsMaterialized() const;
+
+    // Full algorithm, nullptr while the flow is young
+    CongestionControl* GetInner() const;
+
+    // Factory of lazy wrappers around `factory`, e.g. for Workload::Install
+    static CongestionControlFactory MakeFactory(TypeId typeId, std::string algorithmName, CongestionControlFactory factory,
+                                                uint32_t materializeRounds = DEFAULT_MATERIALIZE_ROUNDS,
+                                                uint64_t materializeBytes = DEFAULT_MATERIALIZE_BYTES);
+
+    static constexpr uint32_t DEFAULT_MATERIALIZE_ROUNDS = 4;
+    static constexpr uint64_t DEFAULT_MATERIALIZE_BYTES = 65536;
+    static constexpr uint32_t MIN_RTT_THRESH_US = 4000;    // RFC 9406 MIN_RTT_THRESH
+    static constexpr uint32_t MAX_RTT_THRESH_US = 16000;   // RFC 9406 MAX_RTT_THRESH
+
+private:
+    LazyCongestionControl(const LazyCongestionControl&) = delete;
+    LazyCongestionControl& operator=(const LazyCongestionControl&) = delete;
+
+    // Build the full algorithm; the young state is dropped
+    void Materialize();
+
+    std::unique_ptr<CongestionControl> m_inner;    // Full algorithm, built on demand
+    CongestionControlFactory m_factory;            // Released once used
+    std::string m_algorithmName;
+    uint32_t m_materializeRounds;
+    uint64_t m_materializeBytes;
+
+    // Young flow state
+    uint64_t m_bytesAcked;                         // Total bytes acknowledged
+    uint64_t m_roundEndBytes;                      // m_bytesAcked that ends the current round
+    uint32_t m_rounds;                             // Rounds started
+    uint32_t m_lastRoundMinRtt;                    // HyStart++ lastRoundMinRTT, 0 = none
+    uint32_t m_roundMinRtt;                        // HyStart++ currentRoundMinRTT, 0 = none
+};
+
+#endif // LAZY_CC_H
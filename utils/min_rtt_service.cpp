@@ -0,0 +1,105 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 19:12:40
+@Description: Shared per-destination min-RTT service that coordinates PROBE_RTT across flows
+@Language: C++17
+*/
+
+#include "min_rtt_service.h"
+
+// Constructor
+MinRttService::MinRttService(uint64_t windowUs, uint64_t probeDurationUs)
+    : m_windowUs(windowUs),
+      m_probeDurationUs(probeDurationUs)
+{
+}
+
+// Add a member flow
+void MinRttService::Join(uint64_t destination) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_groups[destination].members++;
+}
+
+// Remove a member flow
+void MinRttService::Leave(uint64_t destination) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_groups.find(destination);
+    if (it == m_groups.end()) {
+        return;
+    }
+    if (--it->second.members == 0) {
+        m_groups.erase(it);
+    }
+}
+
+// Feed an RTT sample
+void MinRttService::OnRttSample(uint64_t destination, uint32_t rttUs, uint64_t nowUs) {
+    if (rttUs == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_groups.find(destination);
+    if (it == m_groups.end()) {
+        return;
+    }
+
+    Group& group = it->second;
+    if (group.min_rtt_us == 0 || rttUs <= group.min_rtt_us) {
+        group.min_rtt_us = rttUs;
+        group.min_rtt_stamp_us = nowUs;
+    }
+    if (group.probe_end_us != 0 && nowUs < group.probe_end_us &&
+        (group.probe_min_rtt_us == 0 || rttUs < group.probe_min_rtt_us)) {
+        group.probe_min_rtt_us = rttUs;
+    }
+}
+
+// Check whether the group is probing
+bool MinRttService::ShouldProbeRtt(uint64_t destination, uint64_t nowUs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_groups.find(destination);
+    if (it == m_groups.end()) {
+        return false;
+    }
+
+    Group& group = it->second;
+    if (group.probe_end_us != 0) {
+        if (nowUs < group.probe_end_us) {
+            return true;
+        }
+
+        // Window over: queues were drained, so its samples are the new minimum
+        if (group.probe_min_rtt_us != 0) {
+            group.min_rtt_us = group.probe_min_rtt_us;
+        }
+        group.min_rtt_stamp_us = group.probe_end_us;
+        group.probe_end_us = 0;
+        group.probe_min_rtt_us = 0;
+        return false;
+    }
+
+    // No member has confirmed the minimum for a whole window
+    if (group.min_rtt_us == 0 || nowUs - group.min_rtt_stamp_us < m_windowUs) {
+        return false;
+    }
+
+    group.probe_end_us = nowUs + m_probeDurationUs;
+    group.probe_min_rtt_us = 0;
+    group.probes++;
+    return true;
+}
+
+// Get shared min RTT
+uint32_t MinRttService::GetMinRtt(uint64_t destination) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_groups.find(destination);
+    return it != m_groups.end() ? it->second.min_rtt_us : 0;
+}
+
+// Get number of probe windows
+uint64_t MinRttService::GetProbeCount(uint64_t destination) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_groups.find(destination);
+    return it != m_groups.end() ? it->second.probes : 0;
+}
@@ -0,0 +1,89 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 19:12:40
+@Description: Shared per-destination min-RTT service that coordinates PROBE_RTT across flows
+@Language: C++17
+*/
+
+#ifndef MIN_RTT_SERVICE_H
+#define MIN_RTT_SERVICE_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+/*
+ * Per-destination min-RTT shared by every flow to the same peer.
+ *
+ * Flows feed their RTT samples in; a sample at or below the group minimum
+ * refreshes it for all members. Only when no member has seen a fresh
+ * minimum for a whole window does the group need PROBE_RTT, and then the
+ * first flow to notice opens one probe window that every other member
+ * joins, so the drops line up instead of recurring once per flow.
+ *
+ * Times are the callers' event clock in microseconds; all members of a
+ * group must use the same clock.
+ */
+class MinRttService {
+public:
+    /**
+     * @param windowUs min-RTT lifetime before a probe is due
+     * @param probeDurationUs length of the shared PROBE_RTT window
+     */
+    explicit MinRttService(uint64_t windowUs = DEFAULT_WINDOW_US,
+                           uint64_t probeDurationUs = DEFAULT_PROBE_DURATION_US);
+
+    // Add or remove a member flow; the group is dropped with its last member
+    void Join(uint64_t destination);
+    void Leave(uint64_t destination);
+
+    // Feed an RTT sample; one at or below the group minimum refreshes it for every member
+    void OnRttSample(uint64_t destination, uint32_t rttUs, uint64_t nowUs);
+
+    /**
+     * @brief Check whether a member should be in PROBE_RTT now.
+     *
+     * Opens the group's probe window when the shared minimum has expired,
+     * and reports true to every member for the rest of that window. The
+     * lowest sample seen in the window becomes the new minimum.
+     *
+     * @param destination group key
+     * @param nowUs event time (microseconds)
+     * @return true while the group's probe window is open
+     */
+    bool ShouldProbeRtt(uint64_t destination, uint64_t nowUs);
+
+    // Shared min RTT (microseconds), 0 when the group has no sample yet
+    uint32_t GetMinRtt(uint64_t destination) const;
+
+    // Number of probe windows opened for the group
+    uint64_t GetProbeCount(uint64_t destination) const;
+
+    static constexpr uint64_t DEFAULT_WINDOW_US = 10000000;         // 10s, as BBR's min-RTT filter
+    static constexpr uint64_t DEFAULT_PROBE_DURATION_US = 200000;   // 200ms
+
+private:
+    MinRttService(const MinRttService&) = delete;
+    MinRttService& operator=(const MinRttService&) = delete;
+
+    // Shared state of one destination
+    struct Group {
+        uint32_t members;
+        uint32_t min_rtt_us;        // 0 = no sample yet
+        uint64_t min_rtt_stamp_us;  // when min_rtt_us was last confirmed
+        uint64_t probe_end_us;      // end of the open probe window, 0 = none
+        uint32_t probe_min_rtt_us;  // lowest sample inside the probe window, 0 = none
+        uint64_t probes;
+
+        Group()
+            : members(0), min_rtt_us(0), min_rtt_stamp_us(0), probe_end_us(0), probe_min_rtt_us(0),
+              probes(0) {}
+    };
+
+    uint64_t m_windowUs;
+    uint64_t m_probeDurationUs;
+    std::map<uint64_t, Group> m_groups;     // by destination
+    mutable std::mutex m_mutex;             // Flows may share the service across threads
+};
+
+#endif // MIN_RTT_SERVICE_H
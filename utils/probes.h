@@ -0,0 +1,58 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 18:05:40
+@Description: Optional USDT static probes for bpftrace/perf
+@Language: C++17
+*/
+
+#ifndef PROBES_H
+#define PROBES_H
+
+/*
+ * Static tracing probes, provider "cc".
+ *
+ * Built only with -DCC_ENABLE_USDT and when <sys/sdt.h> (systemtap-sdt-dev)
+ * is available; otherwise every CC_PROBE* expands to nothing. When built
+ * in, a probe site is a single nop plus an ELF note until a tracer
+ * attaches, e.g.
+ *
+ *   bpftrace -e 'usdt:./app:cc:bbr_enter_probe_rtt { printf("%d\n", arg3); }'
+ *
+ * USDT arguments must be integers or pointers, so floating point model
+ * fields are passed scaled (x1024 for gains and fractions). The first
+ * argument of every probe is the algorithm instance, which identifies the
+ * flow.
+ */
+
+#if defined(CC_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define CC_USDT_ENABLED 1
+#endif
+#endif
+
+#ifdef CC_USDT_ENABLED
+#define CC_PROBE1(name, a1)                     DTRACE_PROBE1(cc, name, a1)
+#define CC_PROBE2(name, a1, a2)                 DTRACE_PROBE2(cc, name, a1, a2)
+#define CC_PROBE3(name, a1, a2, a3)             DTRACE_PROBE3(cc, name, a1, a2, a3)
+#define CC_PROBE4(name, a1, a2, a3, a4)         DTRACE_PROBE4(cc, name, a1, a2, a3, a4)
+#define CC_PROBE5(name, a1, a2, a3, a4, a5)     DTRACE_PROBE5(cc, name, a1, a2, a3, a4, a5)
+#define CC_PROBE6(name, a1, a2, a3, a4, a5, a6) DTRACE_PROBE6(cc, name, a1, a2, a3, a4, a5, a6)
+#else
+#define CC_PROBE1(name, a1)                     do { } while (0)
+#define CC_PROBE2(name, a1, a2)                 do { } while (0)
+#define CC_PROBE3(name, a1, a2, a3)             do { } while (0)
+#define CC_PROBE4(name, a1, a2, a3, a4)         do { } while (0)
+#define CC_PROBE5(name, a1, a2, a3, a4, a5)     do { } while (0)
+#define CC_PROBE6(name, a1, a2, a3, a4, a5, a6) do { } while (0)
+#endif
+
+// Scale a double for a probe argument
+#define CC_PROBE_FIXED(x) static_cast<int64_t>((x) * 1024.0)
+
+// Common CwndEvent probe: instance, event, cwnd, ssthresh, rtt
+#define CC_PROBE_CWND_EVENT(name, socket, event)                              \
+    CC_PROBE5(name, static_cast<void*>(this), static_cast<int>(event),         \
+              (socket)->cwnd_, (socket)->ssthresh_, (socket)->rtt_us_)
+
+#endif // PROBES_H
@@ -0,0 +1,336 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 12:14:50
+@Description: QUIC (RFC 9002) packet-number adapter over the CongestionControl interface
+@Language: C++17
+*/
+
+#include "quic_adapter.h"
+
+#include <algorithm>
+
+// Constructor
+QuicCongestionAdapter::QuicCongestionAdapter(std::unique_ptr<CongestionControl> cc,
+                                             uint32_t maxDatagramSize,
+                                             uint64_t maxAckDelayUs)
+    : m_cc(std::move(cc)),
+      m_socket(std::make_unique<SocketState>()),
+      m_minWindow(2 * maxDatagramSize),
+      m_maxAckDelayUs(maxAckDelayUs),
+      m_firstPacket(0),
+      m_nextPacket(0),
+      m_bytesInFlight(0),
+      m_ackedCarry(0),
+      m_hasRttSample(false),
+      m_latestRtt(0),
+      m_smoothedRtt(INITIAL_RTT_US),
+      m_rttVar(INITIAL_RTT_US / 2),
+      m_minRtt(0),
+      m_firstRttSampleUs(0),
+      m_inRecovery(false),
+      m_recoveryStartUs(0),
+      m_ecnCe(0),
+      m_largestAcked(0),
+      m_largestAckedSentUs(0)
+{
+    // kInitialWindow = min(10 * max_datagram_size, max(14720, 2 * max_datagram_size))
+    m_socket->mss_bytes_ = maxDatagramSize;
+    m_socket->cwnd_ = std::min(10 * maxDatagramSize, std::max<uint32_t>(14720, 2 * maxDatagramSize));
+    m_socket->ssthresh_ = 0x7fffffff;
+    m_socket->rto_us_ = static_cast<uint32_t>(GetPtoUs());
+}
+
+// Record a sent packet
+bool QuicCongestionAdapter::OnPacketSent(uint64_t packetNumber, uint32_t bytes, uint64_t timeUs) {
+    if (packetNumber < m_nextPacket) {
+        return false;
+    }
+
+    if (m_sent.empty()) {
+        m_firstPacket = packetNumber;
+    }
+    // Skipped packet numbers keep the index dense
+    while (m_firstPacket + m_sent.size() < packetNumber) {
+        m_sent.push_back(SentPacket{0, 0, PacketState::NOT_SENT});
+    }
+    m_sent.push_back(SentPacket{timeUs, bytes, PacketState::IN_FLIGHT});
+    m_nextPacket = packetNumber + 1;
+    m_bytesInFlight += bytes;
+    return true;
+}
+
+// Process an ACK frame
+uint64_t QuicCongestionAdapter::OnAckFrame(const std::vector<QuicAckRange>& ranges, uint64_t ackDelayUs,
+                                           const QuicEcnCounts* ecn, uint64_t nowUs) {
+    m_socket->now_us_ = nowUs;
+
+    uint64_t largestAcked = 0;
+    for (const QuicAckRange& range : ranges) {
+        largestAcked = std::max(largestAcked, range.largest);
+    }
+
+    // Send time of the frame's largest acknowledged packet, even if an earlier frame acked it
+    uint64_t largestSentUs = 0;
+    const SentPacket* largest = Find(largestAcked);
+    if (largest != nullptr) {
+        largestSentUs = largest->sent_us;
+    } else if (m_largestAckedSentUs != 0 && largestAcked == m_largestAcked) {
+        largestSentUs = m_largestAckedSentUs;
+    }
+    if (largestSentUs != 0 && (m_largestAckedSentUs == 0 || largestAcked >= m_largestAcked)) {
+        m_largestAcked = largestAcked;
+        m_largestAckedSentUs = largestSentUs;
+    }
+
+    uint64_t ackedBytes = 0;
+    bool largestNewlyAcked = false;
+    uint64_t newestAckedSentUs = 0;     // Latest send time among newly acked packets
+    for (const QuicAckRange& range : ranges) {
+        if (m_sent.empty()) {
+            break;
+        }
+
+        // Only the part of the range that is still tracked
+        uint64_t first = std::max(range.smallest, m_firstPacket);
+        uint64_t last = std::min(range.largest, m_firstPacket + m_sent.size() - 1);
+        for (uint64_t pn = first; pn <= last; pn++) {
+            SentPacket& packet = m_sent[pn - m_firstPacket];
+            if (packet.state != PacketState::IN_FLIGHT) {
+                continue;
+            }
+            packet.state = PacketState::ACKED;
+            m_bytesInFlight -= packet.bytes;
+            ackedBytes += packet.bytes;
+            newestAckedSentUs = std::max(newestAckedSentUs, packet.sent_us);
+            if (pn == largestAcked) {
+                largestNewlyAcked = true;
+            }
+        }
+    }
+
+    // RTT sample only when the largest acknowledged packet is newly acked
+    if (largestNewlyAcked && nowUs >= largestSentUs) {
+        UpdateRtt(nowUs - largestSentUs, ackDelayUs);
+        if (m_firstRttSampleUs == 0) {
+            m_firstRttSampleUs = nowUs;
+        }
+    }
+    TrimSent();
+
+    // Byte-exact segment count for the segment-based algorithm interface
+    uint32_t segmentsAcked = 0;
+    if (ackedBytes > 0) {
+        uint64_t bytes = ackedBytes + m_ackedCarry;
+        segmentsAcked = static_cast<uint32_t>(bytes / m_socket->mss_bytes_);
+        m_ackedCarry = static_cast<uint32_t>(bytes % m_socket->mss_bytes_);
+    }
+
+    if (segmentsAcked > 0) {
+        m_cc->PktsAcked(m_socket, segmentsAcked, m_latestRtt);
+    }
+
+    // New CE marks, also on a frame that acknowledges nothing new (RFC 9002 B.7):
+    // one congestion event per recovery period, dated by the largest acknowledged packet
+    if (ecn != nullptr && ecn->ce > m_ecnCe) {
+        m_ecnCe = ecn->ce;
+        OnCongestionEvent(CongestionEvent::ECN, largestSentUs);
+    }
+
+    if (ackedBytes == 0) {
+        return 0;
+    }
+
+    // A packet sent after recovery started ends the recovery period
+    if (m_inRecovery && newestAckedSentUs > m_recoveryStartUs) {
+        m_inRecovery = false;
+        m_socket->cwnd_ = std::max(std::min(m_socket->cwnd_, m_socket->ssthresh_), m_minWindow);
+        m_cc->CongestionStateSet(m_socket, TCPState::Open);
+    }
+
+    // No window growth during recovery (RFC 9002 section 7.3.2)
+    if (!m_inRecovery && segmentsAcked > 0) {
+        m_cc->IncreaseWindow(m_socket, segmentsAcked);
+    }
+    return ackedBytes;
+}
+
+// Process lost packets
+uint64_t QuicCongestionAdapter::OnPacketsLost(const std::vector<uint64_t>& packetNumbers, uint64_t nowUs) {
+    m_socket->now_us_ = nowUs;
+
+    uint64_t lostBytes = 0;
+    uint64_t newestLostSentUs = 0;
+    uint64_t firstLost = UINT64_MAX;
+    uint64_t lastLost = 0;
+    for (uint64_t pn : packetNumbers) {
+        SentPacket* packet = Find(pn);
+        if (packet == nullptr || packet->state != PacketState::IN_FLIGHT) {
+            continue;
+        }
+        packet->state = PacketState::LOST;
+        m_bytesInFlight -= packet->bytes;
+        lostBytes += packet->bytes;
+        newestLostSentUs = std::max(newestLostSentUs, packet->sent_us);
+        firstLost = std::min(firstLost, pn);
+        lastLost = std::max(lastLost, pn);
+    }
+    if (lostBytes == 0) {
+        return 0;
+    }
+    m_socket->lost_bytes_ += lostBytes;
+
+    OnCongestionEvent(CongestionEvent::PacketLoss, newestLostSentUs);
+
+    // Persistent congestion: collapse to the minimum window, like an RTO
+    if (IsPersistentCongestion(firstLost, lastLost)) {
+        m_inRecovery = false;
+        m_cc->CwndEvent(m_socket, CongestionEvent::Timeout);
+        m_socket->cwnd_ = m_minWindow;
+    }
+
+    TrimSent();
+    return lostBytes;
+}
+
+// Check whether a packet fits
+bool QuicCongestionAdapter::CanSend(uint32_t bytes) const {
+    return m_bytesInFlight + bytes <= m_socket->cwnd_;
+}
+
+// Set app-limited state
+void QuicCongestionAdapter::SetAppLimited(bool appLimited) {
+    m_socket->app_limited_ = appLimited;
+}
+
+// Get congestion window
+uint32_t QuicCongestionAdapter::GetCongestionWindow() const {
+    return m_socket->cwnd_;
+}
+
+// Get bytes in flight
+uint64_t QuicCongestionAdapter::GetBytesInFlight() const {
+    return m_bytesInFlight;
+}
+
+// Get the algorithm's decision
+CcDecision QuicCongestionAdapter::GetDecision() const {
+    return m_cc->GetDecision(m_socket);
+}
+
+// Get latest RTT
+uint64_t QuicCongestionAdapter::GetLatestRtt() const {
+    return m_latestRtt;
+}
+
+// Get smoothed RTT
+uint64_t QuicCongestionAdapter::GetSmoothedRtt() const {
+    return m_smoothedRtt;
+}
+
+// Get RTT variation
+uint64_t QuicCongestionAdapter::GetRttVar() const {
+    return m_rttVar;
+}
+
+// Get min RTT
+uint64_t QuicCongestionAdapter::GetMinRtt() const {
+    return m_minRtt;
+}
+
+// PTO = smoothed_rtt + max(4 * rttvar, kGranularity) + max_ack_delay
+uint64_t QuicCongestionAdapter::GetPtoUs() const {
+    return m_smoothedRtt + std::max(4 * m_rttVar, GRANULARITY_US) + m_maxAckDelayUs;
+}
+
+// Check recovery state
+bool QuicCongestionAdapter::InRecovery() const {
+    return m_inRecovery;
+}
+
+// Get driven algorithm
+CongestionControl* QuicCongestionAdapter::GetAlgorithm() const {
+    return m_cc.get();
+}
+
+// Find a tracked packet
+QuicCongestionAdapter::SentPacket* QuicCongestionAdapter::Find(uint64_t packetNumber) {
+    if (packetNumber < m_firstPacket || packetNumber - m_firstPacket >= m_sent.size()) {
+        return nullptr;
+    }
+    SentPacket* packet = &m_sent[packetNumber - m_firstPacket];
+    return packet->state != PacketState::NOT_SENT ? packet : nullptr;
+}
+
+// RFC 9002 section 5.3
+void QuicCongestionAdapter::UpdateRtt(uint64_t latestRttUs, uint64_t ackDelayUs) {
+    m_latestRtt = latestRttUs;
+    if (!m_hasRttSample) {
+        m_hasRttSample = true;
+        m_minRtt = latestRttUs;
+        m_smoothedRtt = latestRttUs;
+        m_rttVar = latestRttUs / 2;
+    } else {
+        m_minRtt = std::min(m_minRtt, latestRttUs);
+
+        // Subtract the peer's ACK delay unless that would go below min_rtt
+        uint64_t ackDelay = std::min(ackDelayUs, m_maxAckDelayUs);
+        uint64_t adjustedRtt = latestRttUs;
+        if (latestRttUs >= m_minRtt + ackDelay) {
+            adjustedRtt -= ackDelay;
+        }
+
+        uint64_t diff = m_smoothedRtt > adjustedRtt ? m_smoothedRtt - adjustedRtt : adjustedRtt - m_smoothedRtt;
+        m_rttVar = (3 * m_rttVar + diff) / 4;
+        m_smoothedRtt = (7 * m_smoothedRtt + adjustedRtt) / 8;
+    }
+
+    m_socket->rtt_var_ = static_cast<uint32_t>(m_rttVar);
+    m_socket->rto_us_ = static_cast<uint32_t>(GetPtoUs());
+}
+
+// RFC 9002 OnCongestionEvent: at most one reduction per recovery period
+void QuicCongestionAdapter::OnCongestionEvent(CongestionEvent event, uint64_t sentUs) {
+    if (m_inRecovery && sentUs <= m_recoveryStartUs) {
+        return;
+    }
+
+    m_inRecovery = true;
+    m_recoveryStartUs = m_socket->now_us_;
+    m_cc->CwndEvent(m_socket, event);
+    m_socket->cwnd_ = std::max(std::min(m_socket->cwnd_, m_socket->ssthresh_), m_minWindow);
+}
+
+// RFC 9002 section 7.6: every packet over a long enough span was lost
+bool QuicCongestionAdapter::IsPersistentCongestion(uint64_t firstLost, uint64_t lastLost) {
+    if (!m_hasRttSample || firstLost >= lastLost) {
+        return false;
+    }
+
+    SentPacket* first = Find(firstLost);
+    SentPacket* last = Find(lastLost);
+    if (first == nullptr || last == nullptr || first->sent_us < m_firstRttSampleUs) {
+        return false;
+    }
+
+    uint64_t duration = (m_smoothedRtt + std::max(4 * m_rttVar, GRANULARITY_US) + m_maxAckDelayUs) *
+                        PERSISTENT_CONGESTION_THRESHOLD;
+    if (last->sent_us - first->sent_us < duration) {
+        return false;
+    }
+
+    // Nothing in between may have been acknowledged
+    for (uint64_t pn = firstLost; pn <= lastLost; pn++) {
+        if (m_sent[pn - m_firstPacket].state == PacketState::ACKED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Release settled packets
+void QuicCongestionAdapter::TrimSent() {
+    while (!m_sent.empty() && m_sent.front().state != PacketState::IN_FLIGHT) {
+        m_sent.pop_front();
+        m_firstPacket++;
+    }
+}
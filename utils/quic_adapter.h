@@ -0,0 +1,172 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-18 12:14:50
+@Description: QUIC (RFC 9002) packet-number adapter over the CongestionControl interface
+@Language: C++17
+*/
+
+#ifndef QUIC_ADAPTER_H
+#define QUIC_ADAPTER_H
+
+#include "cong.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Inclusive range of acknowledged packet numbers from an ACK frame
+struct QuicAckRange {
+    uint64_t smallest;
+    uint64_t largest;
+};
+
+// Cumulative ECN counts carried by an ACK frame
+struct QuicEcnCounts {
+    uint64_t ect0;
+    uint64_t ect1;
+    uint64_t ce;
+
+    QuicEcnCounts() : ect0(0), ect1(0), ce(0) {}
+};
+
+/*
+ * Drives any CongestionControl from a QUIC stack, following RFC 9002.
+ *
+ * The stack reports in-flight packets by number and size, whole ACK
+ * frames and the packets its loss detection declared lost. The adapter
+ * keeps bytes in flight, the RFC 9002 RTT estimator and the congestion
+ * recovery period, and turns each frame into one PktsAcked /
+ * IncreaseWindow call. Acked bytes are converted to segments with the
+ * remainder carried to the next frame, so accounting stays byte-exact.
+ *
+ * Sent packets live in a deque indexed by packet number, so lookups from
+ * ACK ranges are O(1) and memory is bounded by the packets in flight.
+ */
+class QuicCongestionAdapter {
+public:
+    /**
+     * @param cc algorithm to drive (owned)
+     * @param maxDatagramSize max_datagram_size, used as the MSS
+     * @param maxAckDelayUs peer's max_ack_delay transport parameter
+     */
+    explicit QuicCongestionAdapter(std::unique_ptr<CongestionControl> cc,
+                                   uint32_t maxDatagramSize = DEFAULT_MAX_DATAGRAM_SIZE,
+                                   uint64_t maxAckDelayUs = DEFAULT_MAX_ACK_DELAY_US);
+
+    /**
+     * @brief Record an ack-eliciting, congestion-controlled packet.
+     *
+     * Packet numbers must increase; skipped numbers are allowed.
+     *
+     * @return false if the packet number is not above the last one sent
+     */
+    bool OnPacketSent(uint64_t packetNumber, uint32_t bytes, uint64_t timeUs);
+
+    /**
+     * @brief Process one ACK frame.
+     *
+     * @param ranges acknowledged ranges, in any order
+     * @param ackDelayUs decoded ACK Delay field
+     * @param ecn ECN counts, nullptr when the frame has none
+     * @param nowUs receive time of the frame
+     * @return bytes newly acknowledged
+     */
+    uint64_t OnAckFrame(const std::vector<QuicAckRange>& ranges, uint64_t ackDelayUs,
+                        const QuicEcnCounts* ecn, uint64_t nowUs);
+
+    /**
+     * @brief Process packets declared lost by the stack's loss detection.
+     *
+     * Starts a congestion recovery period unless the packets were sent
+     * during the current one, and collapses the window on persistent
+     * congestion (RFC 9002 section 7.6).
+     *
+     * @return bytes newly declared lost
+     */
+    uint64_t OnPacketsLost(const std::vector<uint64_t>& packetNumbers, uint64_t nowUs);
+
+    // Whether a packet of `bytes` fits in the congestion window
+    bool CanSend(uint32_t bytes) const;
+
+    // Tell the algorithm whether the application, not cwnd, is limiting sending
+    void SetAppLimited(bool appLimited);
+
+    uint32_t GetCongestionWindow() const;
+    uint64_t GetBytesInFlight() const;
+    CcDecision GetDecision() const;
+
+    // RTT estimator (RFC 9002 section 5), microseconds
+    uint64_t GetLatestRtt() const;
+    uint64_t GetSmoothedRtt() const;
+    uint64_t GetRttVar() const;
+    uint64_t GetMinRtt() const;
+
+    // Probe timeout without backoff (RFC 9002 section 6.2.1)
+    uint64_t GetPtoUs() const;
+
+    bool InRecovery() const;
+    CongestionControl* GetAlgorithm() const;
+
+    static constexpr uint32_t DEFAULT_MAX_DATAGRAM_SIZE = 1200;
+    static constexpr uint64_t DEFAULT_MAX_ACK_DELAY_US = 25000;    // 25ms
+    static constexpr uint64_t INITIAL_RTT_US = 333000;             // kInitialRtt
+    static constexpr uint64_t GRANULARITY_US = 1000;               // kGranularity
+    static constexpr uint32_t PERSISTENT_CONGESTION_THRESHOLD = 3; // kPersistentCongestionThreshold
+
+private:
+    QuicCongestionAdapter(const QuicCongestionAdapter&) = delete;
+    QuicCongestionAdapter& operator=(const QuicCongestionAdapter&) = delete;
+
+    // Per packet state
+    enum class PacketState : uint8_t {
+        NOT_SENT,       // skipped packet number
+        IN_FLIGHT,
+        ACKED,
+        LOST,
+    };
+
+    struct SentPacket {
+        uint64_t sent_us;
+        uint32_t bytes;
+        PacketState state;
+    };
+
+    // Entry of a packet number, nullptr if it was never tracked or already released
+    SentPacket* Find(uint64_t packetNumber);
+
+    void UpdateRtt(uint64_t latestRttUs, uint64_t ackDelayUs);
+    void OnCongestionEvent(CongestionEvent event, uint64_t sentUs);
+    bool IsPersistentCongestion(uint64_t firstLost, uint64_t lastLost);
+
+    // Release settled packets from the front of the deque
+    void TrimSent();
+
+    std::unique_ptr<CongestionControl> m_cc;
+    std::unique_ptr<SocketState> m_socket;
+    uint32_t m_minWindow;               // kMinimumWindow, 2 datagrams
+    uint64_t m_maxAckDelayUs;
+
+    std::deque<SentPacket> m_sent;      // m_sent[i] is packet m_firstPacket + i
+    uint64_t m_firstPacket;
+    uint64_t m_nextPacket;              // Lowest packet number not yet sent
+    uint64_t m_bytesInFlight;
+    uint32_t m_ackedCarry;              // Acked bytes not yet reported as a whole segment
+
+    // RTT estimator
+    bool m_hasRttSample;
+    uint64_t m_latestRtt;
+    uint64_t m_smoothedRtt;
+    uint64_t m_rttVar;
+    uint64_t m_minRtt;
+    uint64_t m_firstRttSampleUs;        // Time of the first RTT sample
+
+    // Congestion recovery period
+    bool m_inRecovery;
+    uint64_t m_recoveryStartUs;         // congestion_recovery_start_time
+    uint64_t m_ecnCe;                   // Highest ECN-CE count seen
+    uint64_t m_largestAcked;            // Largest packet number acknowledged so far
+    uint64_t m_largestAckedSentUs;      // Its send time, 0 = nothing acknowledged yet
+};
+
+#endif // QUIC_ADAPTER_H
@@ -0,0 +1,410 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 20:14:52
+@Description: Gorilla-style compressed trajectory encoder and decoder implementation
+@Language: C++17
+*/
+
+#include "trajectory.h"
+
+#include <algorithm>
+
+namespace {
+
+const char MAGIC[4] = {'C', 'C', 'T', 'J'};
+const uint8_t VERSION = 1;
+const uint8_t NO_WINDOW = 0xFF;         // XOR window not set yet
+
+// Map signed to unsigned so small magnitudes stay small
+inline uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline uint32_t LeadingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_clzll(x));
+#else
+    uint32_t n = 0;
+    while ((x & (1ULL << 63)) == 0) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+inline uint32_t TrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_ctzll(x));
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Write an unsigned LEB128 varint, returns bytes written
+size_t PutVarint(std::ostream& out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out.put(static_cast<char>(value | 0x80));
+        value >>= 7;
+        n++;
+    }
+    out.put(static_cast<char>(value));
+    return n + 1;
+}
+
+// Field values of a sample in encoding order
+inline uint64_t Field(const TrajectorySample& s, int field) {
+    switch (field) {
+        case 0: return s.cwnd;
+        case 1: return s.ssthresh;
+        case 2: return s.rtt_us;
+        case 3: return s.pacing_rate;
+        default: return s.mode;
+    }
+}
+
+inline void SetField(TrajectorySample& s, int field, uint64_t value) {
+    switch (field) {
+        case 0: s.cwnd = static_cast<uint32_t>(value); break;
+        case 1: s.ssthresh = static_cast<uint32_t>(value); break;
+        case 2: s.rtt_us = static_cast<uint32_t>(value); break;
+        case 3: s.pacing_rate = value; break;
+        default: s.mode = static_cast<uint8_t>(value); break;
+    }
+}
+
+// Raw width of each field in the first sample of a block
+const uint32_t FIELD_BITS[5] = {32, 32, 32, 64, 8};
+
+}  // namespace
+
+// Encoder constructor
+TrajectoryEncoder::TrajectoryEncoder(std::ostream& out, size_t blockBytes)
+    : m_out(out),
+      m_blockBytes(std::max<size_t>(blockBytes, 16)),
+      m_headerWritten(false),
+      m_samples(0),
+      m_bytesWritten(0)
+{
+}
+
+// Destructor writes what is still buffered
+TrajectoryEncoder::~TrajectoryEncoder() {
+    Flush();
+}
+
+// Compress one sample into the flow's block
+bool TrajectoryEncoder::Append(uint32_t flowId, const TrajectorySample& sample) {
+    FlowState& flow = m_flows[flowId];
+    if (flow.has_last && flow.last.SameState(sample)) {
+        return false;
+    }
+
+    if (flow.samples == 0) {
+        // First sample of a block is stored raw
+        flow.bits.clear();
+        flow.bit_count = 0;
+        WriteBits(flow, sample.time_us, 64);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            WriteBits(flow, Field(sample, f), FIELD_BITS[f]);
+            flow.leading[f] = NO_WINDOW;
+            flow.trailing[f] = 0;
+        }
+        flow.last_delta = 0;
+    } else {
+        EncodeTimestamp(flow, sample.time_us);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            EncodeValue(flow, f, Field(flow.last, f), Field(sample, f));
+        }
+    }
+
+    flow.last = sample;
+    flow.has_last = true;
+    flow.samples++;
+    m_samples++;
+
+    if (flow.bits.size() >= m_blockBytes) {
+        WriteBlock(flowId, flow);
+    }
+    return true;
+}
+
+// Write every partial block
+void TrajectoryEncoder::Flush() {
+    for (auto& entry : m_flows) {
+        WriteBlock(entry.first, entry.second);
+    }
+    m_out.flush();
+}
+
+// Write a flow's partial block and forget it
+void TrajectoryEncoder::CloseFlow(uint32_t flowId) {
+    auto it = m_flows.find(flowId);
+    if (it == m_flows.end()) {
+        return;
+    }
+    WriteBlock(flowId, it->second);
+    m_flows.erase(it);
+}
+
+// Get number of stored samples
+uint64_t TrajectoryEncoder::GetSampleCount() const {
+    return m_samples;
+}
+
+// Get bytes written to the stream
+uint64_t TrajectoryEncoder::GetBytesWritten() const {
+    return m_bytesWritten;
+}
+
+// Append `count` low bits of value, most significant first
+void TrajectoryEncoder::WriteBits(FlowState& flow, uint64_t value, uint32_t count) {
+    while (count > 0) {
+        uint32_t offset = flow.bit_count % 8;
+        if (offset == 0) {
+            flow.bits.push_back(0);
+        }
+        uint32_t space = 8 - offset;
+        uint32_t take = std::min(space, count);
+        uint8_t chunk = static_cast<uint8_t>((value >> (count - take)) & ((1u << take) - 1));
+        flow.bits.back() |= static_cast<uint8_t>(chunk << (space - take));
+        flow.bit_count += take;
+        count -= take;
+    }
+}
+
+// Delta-of-delta: '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+64 bits (zigzag)
+void TrajectoryEncoder::EncodeTimestamp(FlowState& flow, uint64_t time) {
+    int64_t delta = static_cast<int64_t>(time - flow.last.time_us);
+    uint64_t dod = ZigZag(delta - flow.last_delta);
+    flow.last_delta = delta;
+
+    if (dod == 0) {
+        WriteBits(flow, 0, 1);
+    } else if (dod < (1u << 7)) {
+        WriteBits(flow, 0x2, 2);
+        WriteBits(flow, dod, 7);
+    } else if (dod < (1u << 9)) {
+        WriteBits(flow, 0x6, 3);
+        WriteBits(flow, dod, 9);
+    } else if (dod < (1u << 12)) {
+        WriteBits(flow, 0xE, 4);
+        WriteBits(flow, dod, 12);
+    } else {
+        WriteBits(flow, 0xF, 4);
+        WriteBits(flow, dod, 64);
+    }
+}
+
+// XOR: '0' same | '10' + bits in previous window | '11' + 6b leading + 6b length + bits
+void TrajectoryEncoder::EncodeValue(FlowState& flow, int field, uint64_t prev, uint64_t value) {
+    uint64_t x = prev ^ value;
+    if (x == 0) {
+        WriteBits(flow, 0, 1);
+        return;
+    }
+
+    uint32_t leading = LeadingZeros(x);
+    uint32_t trailing = TrailingZeros(x);
+
+    if (flow.leading[field] != NO_WINDOW && leading >= flow.leading[field] && trailing >= flow.trailing[field]) {
+        uint32_t length = 64 - flow.leading[field] - flow.trailing[field];
+        WriteBits(flow, 0x2, 2);
+        WriteBits(flow, x >> flow.trailing[field], length);
+        return;
+    }
+
+    uint32_t length = 64 - leading - trailing;
+    WriteBits(flow, 0x3, 2);
+    WriteBits(flow, leading, 6);
+    WriteBits(flow, length - 1, 6);
+    WriteBits(flow, x >> trailing, length);
+    flow.leading[field] = static_cast<uint8_t>(leading);
+    flow.trailing[field] = static_cast<uint8_t>(trailing);
+}
+
+// Emit the flow's block and start a new one
+void TrajectoryEncoder::WriteBlock(uint32_t flowId, FlowState& flow) {
+    if (flow.samples == 0) {
+        return;
+    }
+    WriteHeader();
+
+    m_bytesWritten += PutVarint(m_out, flowId);
+    m_bytesWritten += PutVarint(m_out, flow.samples);
+    m_bytesWritten += PutVarint(m_out, flow.bits.size());
+    m_out.write(reinterpret_cast<const char*>(flow.bits.data()), static_cast<std::streamsize>(flow.bits.size()));
+    m_bytesWritten += flow.bits.size();
+
+    flow.bits.clear();
+    flow.bits.shrink_to_fit();
+    flow.bit_count = 0;
+    flow.samples = 0;
+}
+
+// Stream header, written once
+void TrajectoryEncoder::WriteHeader() {
+    if (m_headerWritten) {
+        return;
+    }
+    m_out.write(MAGIC, sizeof(MAGIC));
+    m_out.put(static_cast<char>(VERSION));
+    m_bytesWritten += sizeof(MAGIC) + 1;
+    m_headerWritten = true;
+}
+
+// Decoder constructor
+TrajectoryDecoder::TrajectoryDecoder(std::istream& in)
+    : m_in(in),
+      m_headerRead(false)
+{
+}
+
+// Decode one block
+bool TrajectoryDecoder::NextBlock(uint32_t& flowId, std::vector<TrajectorySample>& samples) {
+    samples.clear();
+    if (!ReadHeader()) {
+        return false;
+    }
+
+    uint64_t id = 0;
+    uint64_t count = 0;
+    uint64_t length = 0;
+    if (!ReadVarint(id) || !ReadVarint(count) || !ReadVarint(length) || count == 0) {
+        return false;
+    }
+
+    m_block.resize(static_cast<size_t>(length));
+    if (!m_in.read(reinterpret_cast<char*>(m_block.data()), static_cast<std::streamsize>(length))) {
+        return false;
+    }
+    flowId = static_cast<uint32_t>(id);
+
+    BitReader reader{m_block.data(), m_block.size() * 8, 0, true};
+    TrajectorySample sample;
+    uint8_t leading[FIELD_COUNT];
+    uint8_t trailing[FIELD_COUNT];
+
+    sample.time_us = reader.Read(64);
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        SetField(sample, f, reader.Read(FIELD_BITS[f]));
+        leading[f] = NO_WINDOW;
+        trailing[f] = 0;
+    }
+    samples.push_back(sample);
+
+    int64_t lastDelta = 0;
+    for (uint64_t i = 1; i < count && reader.ok; i++) {
+        // Timestamp
+        uint64_t dod = 0;
+        if (reader.Read(1) == 1) {
+            if (reader.Read(1) == 0) {
+                dod = reader.Read(7);
+            } else if (reader.Read(1) == 0) {
+                dod = reader.Read(9);
+            } else if (reader.Read(1) == 0) {
+                dod = reader.Read(12);
+            } else {
+                dod = reader.Read(64);
+            }
+        }
+        lastDelta += UnZigZag(dod);
+        sample.time_us += static_cast<uint64_t>(lastDelta);
+
+        // Fields
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (reader.Read(1) == 0) {
+                continue;
+            }
+            uint64_t x = 0;
+            if (reader.Read(1) == 0) {
+                if (leading[f] == NO_WINDOW) {
+                    return false;
+                }
+                uint32_t bits = 64 - leading[f] - trailing[f];
+                x = reader.Read(bits) << trailing[f];
+            } else {
+                uint32_t lead = static_cast<uint32_t>(reader.Read(6));
+                uint32_t bits = static_cast<uint32_t>(reader.Read(6)) + 1;
+                if (lead + bits > 64) {
+                    return false;
+                }
+                uint32_t trail = 64 - lead - bits;
+                x = reader.Read(bits) << trail;
+                leading[f] = static_cast<uint8_t>(lead);
+                trailing[f] = static_cast<uint8_t>(trail);
+            }
+            SetField(sample, f, Field(sample, f) ^ x);
+        }
+        samples.push_back(sample);
+    }
+
+    return reader.ok;
+}
+
+// Read `count` bits, most significant first
+uint64_t TrajectoryDecoder::BitReader::Read(uint32_t count) {
+    if (pos + count > size_bits) {
+        ok = false;
+        pos = size_bits;
+        return 0;
+    }
+
+    uint64_t value = 0;
+    while (count > 0) {
+        uint32_t offset = static_cast<uint32_t>(pos % 8);
+        uint32_t avail = 8 - offset;
+        uint32_t take = std::min(avail, count);
+        uint8_t byte = data[pos / 8];
+        uint64_t chunk = (byte >> (avail - take)) & ((1u << take) - 1);
+        value = (value << take) | chunk;
+        pos += take;
+        count -= take;
+    }
+    return value;
+}
+
+// Check the stream header once
+bool TrajectoryDecoder::ReadHeader() {
+    if (m_headerRead) {
+        return true;
+    }
+
+    char magic[4];
+    char version = 0;
+    if (!m_in.read(magic, sizeof(magic)) || !m_in.get(version)) {
+        return false;
+    }
+    if (!std::equal(magic, magic + sizeof(magic), MAGIC) || static_cast<uint8_t>(version) != VERSION) {
+        return false;
+    }
+    m_headerRead = true;
+    return true;
+}
+
+// Read a LEB128 varint from the stream
+bool TrajectoryDecoder::ReadVarint(uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        char c = 0;
+        if (!m_in.get(c)) {
+            return false;
+        }
+        uint8_t byte = static_cast<uint8_t>(c);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
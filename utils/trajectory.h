@@ -0,0 +1,138 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-17 20:14:52
+@Description: Gorilla-style compressed cwnd/RTT/pacing trajectory encoder and decoder
+@Language: C++17
+*/
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// One point of a flow's trajectory
+struct TrajectorySample {
+    uint64_t time_us;
+    uint32_t cwnd;
+    uint32_t ssthresh;
+    uint32_t rtt_us;
+    uint64_t pacing_rate;       // bytes/sec from CcDecision, 0 before the first RTT sample
+    uint8_t mode;               // algorithm mode + 1 (BBRMode / CopaMode), 0 = none
+
+    bool SameState(const TrajectorySample& other) const {
+        return cwnd == other.cwnd && ssthresh == other.ssthresh && rtt_us == other.rtt_us &&
+               pacing_rate == other.pacing_rate && mode == other.mode;
+    }
+};
+
+/*
+ * Streaming trajectory encoder.
+ *
+ * Samples are buffered per flow and compressed as in Facebook's Gorilla:
+ * timestamps as delta-of-delta with variable-length prefixes, every other
+ * field as the XOR with its previous value, reusing the previous
+ * leading/trailing-zero window when the new XOR fits in it. A sample
+ * identical to the previous one (except for time) is dropped, so only
+ * state changes are stored.
+ *
+ * When a flow's buffer reaches the block size it is written as one
+ * self-contained block:
+ *
+ *   varint flow_id | varint sample_count | varint byte_length | bits
+ *
+ * after a 4-byte "CCTJ" magic and a version byte at the start of the stream.
+ */
+class TrajectoryEncoder {
+public:
+    /**
+     * @param out destination stream (not owned, must outlive the encoder)
+     * @param blockBytes per-flow buffer size that triggers a block write
+     */
+    explicit TrajectoryEncoder(std::ostream& out, size_t blockBytes = DEFAULT_BLOCK_BYTES);
+    ~TrajectoryEncoder();
+
+    // Append a sample; false if it repeats the flow's previous state
+    bool Append(uint32_t flowId, const TrajectorySample& sample);
+
+    // Write the partial blocks of every flow
+    void Flush();
+
+    // Finish one flow (writes its partial block and frees its buffer)
+    void CloseFlow(uint32_t flowId);
+
+    uint64_t GetSampleCount() const;
+    uint64_t GetBytesWritten() const;
+
+    static constexpr size_t DEFAULT_BLOCK_BYTES = 512;
+
+private:
+    TrajectoryEncoder(const TrajectoryEncoder&) = delete;
+    TrajectoryEncoder& operator=(const TrajectoryEncoder&) = delete;
+
+    static constexpr int FIELD_COUNT = 5;
+
+    struct FlowState {
+        std::vector<uint8_t> bits;      // Block being filled
+        uint32_t bit_count;             // Used bits of `bits`
+        uint32_t samples;               // Samples in the block
+        TrajectorySample last;
+        int64_t last_delta;             // Previous timestamp delta
+        uint8_t leading[FIELD_COUNT];   // XOR window per field
+        uint8_t trailing[FIELD_COUNT];
+        bool has_last;                  // A sample was ever appended
+    };
+
+    void WriteBits(FlowState& flow, uint64_t value, uint32_t count);
+    void EncodeTimestamp(FlowState& flow, uint64_t time);
+    void EncodeValue(FlowState& flow, int field, uint64_t prev, uint64_t value);
+    void WriteBlock(uint32_t flowId, FlowState& flow);
+    void WriteHeader();
+
+    std::ostream& m_out;
+    size_t m_blockBytes;
+    std::unordered_map<uint32_t, FlowState> m_flows;
+    bool m_headerWritten;
+    uint64_t m_samples;                 // Samples stored
+    uint64_t m_bytesWritten;
+};
+
+// Reads the blocks written by TrajectoryEncoder
+class TrajectoryDecoder {
+public:
+    explicit TrajectoryDecoder(std::istream& in);
+
+    /**
+     * @brief Decode the next block.
+     *
+     * @param flowId flow the block belongs to
+     * @param samples decoded samples (replaced)
+     * @return false at end of stream or on a malformed block
+     */
+    bool NextBlock(uint32_t& flowId, std::vector<TrajectorySample>& samples);
+
+private:
+    static constexpr int FIELD_COUNT = 5;
+
+    struct BitReader {
+        const uint8_t* data;
+        size_t size_bits;
+        size_t pos;
+        bool ok;
+
+        uint64_t Read(uint32_t count);
+    };
+
+    bool ReadHeader();
+    bool ReadVarint(uint64_t& value);
+
+    std::istream& m_in;
+    bool m_headerRead;
+    std::vector<uint8_t> m_block;
+};
+
+#endif // TRAJECTORY_H
@@ -6,6 +6,7 @@
 */
 
 #include "vegas.h"
+#include "../utils/probes.h"
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
@@ -131,6 +132,7 @@ void Vegas::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
 
     // Update RTT information
     socket->rtt_us_ = static_cast<uint32_t>(rtt);
+    socket->RecordHistograms(static_cast<uint32_t>(rtt));
     m_currentRTT = static_cast<uint32_t>(rtt);
     
     // Basic RTT variance calculation
@@ -142,7 +144,8 @@ void Vegas::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
     socket->rto_us_ = socket->rtt_us_ + 4 * socket->rtt_var_;
 
     // Update base RTT
-    UpdateBaseRTT(static_cast<uint32_t>(rtt));
+    uint64_t now = socket->NowUs();
+    UpdateBaseRTT(static_cast<uint32_t>(rtt), now);
     
     // Track minimum RTT for this period
     if (rtt < m_minRtt) {
@@ -154,7 +157,7 @@ void Vegas::PktsAcked(std::unique_ptr<SocketState>& socket, uint32_t segmentsAck
     
     // Enable Vegas if we have base RTT
     if (!m_doingVegasNow && m_baseRTT != 0xFFFFFFFF) {
-        EnableVegas();
+        EnableVegas(now);
     }
 }
 
@@ -179,6 +182,7 @@ void Vegas::CwndEvent(std::unique_ptr<SocketState>& socket, const CongestionEven
         return;
     }
 
+    CC_PROBE_CWND_EVENT(vegas_cwnd_event, socket, congestionEvent);
     socket->congestion_event_ = congestionEvent;
 
     switch (congestionEvent) {
@@ -333,13 +337,13 @@ void Vegas::VegasUpdate(std::unique_ptr<SocketState>& socket) {
 }
 
 // Update base RTT
-void Vegas::UpdateBaseRTT(uint32_t rtt) {
+void Vegas::UpdateBaseRTT(uint32_t rtt, uint64_t nowUs) {
     if (rtt == 0) {
         return;
     }
     
     // Add new sample
-    m_rttSamples.push_back(VegasRTTSample(rtt));
+    m_rttSamples.push_back(VegasRTTSample(rtt, nowUs));
     
     // Keep only recent samples
     while (m_rttSamples.size() > RTT_SAMPLE_WINDOW) {
@@ -349,15 +353,13 @@ void Vegas::UpdateBaseRTT(uint32_t rtt) {
     // Update base RTT if this is smaller
     if (rtt < m_baseRTT) {
         m_baseRTT = rtt;
-        m_baseRTTTimestamp = std::chrono::steady_clock::now();
+        m_baseRTTTimestamp = nowUs;
     }
     
     // Check if base RTT is stale
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        now - m_baseRTTTimestamp);
+    uint64_t elapsedUs = nowUs - m_baseRTTTimestamp;
     
-    if (elapsed.count() >= BASE_RTT_WINDOW_SEC) {
+    if (elapsedUs >= BASE_RTT_WINDOW_SEC * 1000000ull) {
         // Reset base RTT from current samples
         if (!m_rttSamples.empty()) {
             uint32_t minRTT = 0xFFFFFFFF;
@@ -365,7 +367,7 @@ void Vegas::UpdateBaseRTT(uint32_t rtt) {
                 minRTT = std::min(minRTT, sample.rtt_us);
             }
             m_baseRTT = minRTT;
-            m_baseRTTTimestamp = now;
+            m_baseRTTTimestamp = nowUs;
         }
     }
 }
@@ -447,14 +449,11 @@ void Vegas::ResetVegasState() {
 }
 
 // Clean up old RTT samples
-void Vegas::CleanupOldRTTSamples() {
-    auto now = std::chrono::steady_clock::now();
-    
+void Vegas::CleanupOldRTTSamples(uint64_t nowUs) {
     // Remove samples older than 10 seconds
     while (!m_rttSamples.empty()) {
-        auto age = std::chrono::duration_cast<std::chrono::seconds>(
-            now - m_rttSamples.front().timestamp);
-        if (age.count() > 10) {
+        uint64_t ageUs = nowUs - m_rttSamples.front().timestamp_us;
+        if (ageUs > 10000000) {
             m_rttSamples.pop_front();
         } else {
             break;
@@ -464,21 +463,23 @@ void Vegas::CleanupOldRTTSamples() {
 
 // Initialize Vegas
 void Vegas::InitializeVegas() {
-    m_baseRTTTimestamp = std::chrono::steady_clock::now();
-    m_begTime = std::chrono::steady_clock::now();
+    // Timestamps come from the first ACK
+    m_baseRTTTimestamp = 0;
+    m_begTime = 0;
     ResetVegasState();
 }
 
 // Enable Vegas
-void Vegas::EnableVegas() {
+void Vegas::EnableVegas(uint64_t nowUs) {
     m_doingVegasNow = true;
-    m_begTime = std::chrono::steady_clock::now();
+    m_begTime = nowUs;
     m_begSndNxt = 0;
     m_cntRtt = 0;
+
+    CC_PROBE4(vegas_enable, static_cast<void*>(this), m_cwnd, m_baseRTT, m_currentRTT);
 }
 
 // Disable Vegas
 void Vegas::DisableVegas() {
     m_doingVegasNow = false;
 }
-
@@ -24,10 +24,10 @@ enum class VegasPhase {
 // RTT measurement for Vegas
 struct VegasRTTSample {
     uint32_t rtt_us;                                      // RTT in microseconds
-    std::chrono::steady_clock::time_point timestamp;      // When measured
+    uint64_t timestamp_us;                                // When measured
     
-    VegasRTTSample(uint32_t rtt = 0) 
-        : rtt_us(rtt), timestamp(std::chrono::steady_clock::now()) {}
+    VegasRTTSample(uint32_t rtt = 0, uint64_t timestamp = 0) 
+        : rtt_us(rtt), timestamp_us(timestamp) {}
 };
 
 class Vegas: public CongestionControl {
@@ -66,7 +66,7 @@ protected:
     virtual void VegasUpdate(std::unique_ptr<SocketState>& socket);
     
     // RTT tracking
-    virtual void UpdateBaseRTT(uint32_t rtt);
+    virtual void UpdateBaseRTT(uint32_t rtt, uint64_t nowUs);
     virtual uint32_t GetBaseRTT() const;
     
     // Vegas calculation
@@ -91,7 +91,7 @@ private:
     std::deque<VegasRTTSample> m_rttSamples;  // Recent RTT samples
     uint32_t m_baseRTT;            // Minimum RTT observed (base RTT, microseconds)
     uint32_t m_currentRTT;         // Current RTT (microseconds)
-    std::chrono::steady_clock::time_point m_baseRTTTimestamp;  // When baseRTT was updated
+    uint64_t m_baseRTTTimestamp;   // When baseRTT was updated (microseconds)
     
     // Vegas thresholds (in segments)
     uint32_t m_alpha;              // Lower threshold for cwnd increase
@@ -110,7 +110,7 @@ private:
     uint32_t m_segmentsAcked;      // Segments acked in current RTT
     
     // Timestamps for rate calculation
-    std::chrono::steady_clock::time_point m_begTime;  // Begin time for measurement
+    uint64_t m_begTime;            // Begin time for measurement (microseconds)
     
     // Slow start parameters
     uint32_t m_ssCount;            // Slow start counter
@@ -124,9 +124,9 @@ private:
     static constexpr uint32_t RTT_SAMPLE_WINDOW = 100;  // Keep 100 RTT samples
     
     // Helper methods
-    void CleanupOldRTTSamples();
+    void CleanupOldRTTSamples(uint64_t nowUs);
     void InitializeVegas();
-    void EnableVegas();
+    void EnableVegas(uint64_t nowUs);
     void DisableVegas();
 };
 